@@ -0,0 +1,441 @@
+/*
+ *  stimc is a lightweight verilog-vpi wrapper for stimuli generation.
+ *  Copyright (C) 2019-2022  Andreas Dixius, Felix Neumärker
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Scheduler microbenchmarks on top of the vpi stand-in (vpimock).
+ *
+ * A single driver thread runs the benchmarks one after another
+ * and measures wall clock time around each of them.
+ * Results are written as JSON (stdout or file given via -o).
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stimc.h>
+#include <vpi_mock.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <time.h>
+
+#ifndef STIMC_BENCH_THREAD_IMPL
+#define STIMC_BENCH_THREAD_IMPL "unknown"
+#endif
+
+/* problem sizes (divided by scale divisor),
+ * spawn batch below default stack pool size to measure steady state */
+#define BENCH_SPAWN_THREADS       200000
+#define BENCH_SPAWN_BATCH         32
+#define BENCH_SWITCH_ROUNDS       500000
+#define BENCH_FANOUT_WAITERS      1000
+#define BENCH_FANOUT_ROUNDS       1000
+#define BENCH_WAIT_THREADS        64
+#define BENCH_WAIT_ITERATIONS     10000
+#define BENCH_NBA_NETS            64
+#define BENCH_NBA_STEPS           20000
+
+#define BENCH_QUICK_DIVISOR       100
+#define BENCH_RESULTS_MAX         16
+
+struct bench_result_s {
+    const char *name;
+    const char *op;
+    uint64_t    ops;
+    double      seconds;
+    uint64_t    vpi_callbacks;
+    uint64_t    vpi_put_value;
+};
+
+static struct bench_result_s bench_results[BENCH_RESULTS_MAX];
+static size_t                bench_results_num = 0;
+static unsigned              bench_divisor     = 1;
+static const char           *bench_output      = NULL;
+static double                bench_start       = 0.0;
+
+static stimc_module bench_module;
+static stimc_port   bench_nets[BENCH_NBA_NETS];
+
+/* shared state of benchmark threads */
+static stimc_event bench_done;
+static stimc_event bench_ping;
+static stimc_event bench_pong;
+static uint64_t    bench_count;
+static uint64_t    bench_target;
+static bool        bench_stop;
+
+static uint64_t bench_size (uint64_t size)
+{
+    size /= bench_divisor;
+    return (size > 0) ? size : 1;
+}
+
+static double bench_clock (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+static void bench_begin (void)
+{
+    vpi_mock_stat_reset ();
+    bench_start = bench_clock ();
+}
+
+static void bench_record (const char *name, const char *op, uint64_t ops, double seconds)
+{
+    if (bench_results_num >= BENCH_RESULTS_MAX) {
+        fprintf (stderr, "stimc_bench: too many results\n");
+        exit (1);
+    }
+
+    struct bench_result_s *r = &bench_results[bench_results_num];
+    bench_results_num++;
+
+    r->name          = name;
+    r->op            = op;
+    r->ops           = ops;
+    r->seconds       = seconds;
+    r->vpi_callbacks = vpi_mock_stat (VPI_MOCK_STAT_CALLBACK);
+    r->vpi_put_value = vpi_mock_stat (VPI_MOCK_STAT_PUT_VALUE);
+}
+
+static void bench_end (const char *name, const char *op, uint64_t ops)
+{
+    bench_record (name, op, ops, bench_clock () - bench_start);
+}
+
+/* counts a finished unit of work, last one wakes up the driver */
+static void bench_count_done (void)
+{
+    bench_count++;
+    if (bench_count == bench_target) {
+        stimc_trigger_event (bench_done);
+    }
+}
+
+/******************************************************************************************************/
+/* spawn / finish */
+/******************************************************************************************************/
+static void bench_spawn_child (void *userdata __attribute__((unused)))
+{
+    bench_count_done ();
+}
+
+static void bench_spawn_finish (void)
+{
+    uint64_t threads = bench_size (BENCH_SPAWN_THREADS);
+
+    bench_begin ();
+    for (uint64_t i = 0; i < threads; i += BENCH_SPAWN_BATCH) {
+        uint64_t batch = threads - i;
+        if (batch > BENCH_SPAWN_BATCH) batch = BENCH_SPAWN_BATCH;
+
+        bench_count  = 0;
+        bench_target = batch;
+        for (uint64_t j = 0; j < batch; j++) {
+            stimc_spawn_thread (bench_spawn_child, NULL, 0);
+        }
+        stimc_wait_event (bench_done);
+    }
+    bench_end ("spawn_finish", "thread spawned, run and finished", threads);
+}
+
+/******************************************************************************************************/
+/* context switch */
+/******************************************************************************************************/
+static void bench_pong_thread (void *userdata __attribute__((unused)))
+{
+    while (true) {
+        stimc_wait_event (bench_ping);
+        if (bench_stop) break;
+        stimc_trigger_event (bench_pong);
+    }
+}
+
+static void bench_context_switch (void)
+{
+    uint64_t rounds = bench_size (BENCH_SWITCH_ROUNDS);
+
+    bench_stop = false;
+    stimc_spawn_thread (bench_pong_thread, NULL, 0);
+    /* let pong thread reach its wait */
+    stimc_wait_time (1, SC_NS);
+
+    bench_begin ();
+    for (uint64_t i = 0; i < rounds; i++) {
+        stimc_trigger_event (bench_ping);
+        stimc_wait_event (bench_pong);
+    }
+    bench_end ("context_switch", "thread to thread handoff via event", 2 * rounds);
+
+    bench_stop = true;
+    stimc_trigger_event (bench_ping);
+    stimc_wait_time (1, SC_NS);
+}
+
+/******************************************************************************************************/
+/* event fan-out */
+/******************************************************************************************************/
+static void bench_fanout_waiter (void *userdata __attribute__((unused)))
+{
+    while (true) {
+        stimc_wait_event (bench_ping);
+        if (bench_stop) break;
+        bench_count_done ();
+    }
+}
+
+static void bench_fanout_method (void *userdata __attribute__((unused)))
+{
+    bench_count++;
+}
+
+static void bench_event_fanout (void)
+{
+    uint64_t waiters = BENCH_FANOUT_WAITERS;
+    uint64_t rounds  = bench_size (BENCH_FANOUT_ROUNDS);
+
+    /* waiting threads */
+    bench_stop = false;
+    for (uint64_t i = 0; i < waiters; i++) {
+        stimc_spawn_thread (bench_fanout_waiter, NULL, 0);
+    }
+    stimc_wait_time (1, SC_NS);
+
+    double trigger_seconds = 0.0;
+
+    bench_begin ();
+    for (uint64_t i = 0; i < rounds; i++) {
+        bench_count  = 0;
+        bench_target = waiters;
+
+        double t = bench_clock ();
+        stimc_trigger_event (bench_ping);
+        trigger_seconds += bench_clock () - t;
+
+        stimc_wait_event (bench_done);
+    }
+    bench_end ("event_fanout_threads", "waiting thread woken up and resumed", rounds * waiters);
+
+    bench_record ("event_fanout_trigger", "waiting thread moved to run queue by trigger", rounds * waiters, trigger_seconds);
+
+    bench_stop = true;
+    stimc_trigger_event (bench_ping);
+    stimc_wait_time (1, SC_NS);
+
+    /* event methods */
+    stimc_event event = stimc_event_create ();
+    for (uint64_t i = 0; i < waiters; i++) {
+        stimc_register_event_method (bench_fanout_method, NULL, event);
+    }
+
+    bench_count = 0;
+    bench_begin ();
+    for (uint64_t i = 0; i < rounds; i++) {
+        stimc_trigger_event (event);
+    }
+    bench_end ("event_fanout_methods", "event method called by trigger", rounds * waiters);
+
+    stimc_event_free (event);
+}
+
+/******************************************************************************************************/
+/* wait time */
+/******************************************************************************************************/
+static void bench_wait_thread (void *userdata)
+{
+    uint64_t delay      = 1 + ((uintptr_t)userdata % 4);
+    uint64_t iterations = bench_size (BENCH_WAIT_ITERATIONS);
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        stimc_wait_time (delay, SC_NS);
+    }
+
+    bench_count_done ();
+}
+
+static void bench_wait_time (void)
+{
+    uint64_t threads    = BENCH_WAIT_THREADS;
+    uint64_t iterations = bench_size (BENCH_WAIT_ITERATIONS);
+
+    bench_count  = 0;
+    bench_target = threads;
+
+    bench_begin ();
+    for (uint64_t i = 0; i < threads; i++) {
+        stimc_spawn_thread (bench_wait_thread, (void *)(uintptr_t)i, 0);
+    }
+    stimc_wait_event (bench_done);
+    bench_end ("wait_time", "thread resumed after stimc_wait_time", threads * iterations);
+}
+
+/******************************************************************************************************/
+/* nba flush */
+/******************************************************************************************************/
+static void bench_nba_flush (void)
+{
+    uint64_t steps = bench_size (BENCH_NBA_STEPS);
+
+    bench_begin ();
+    for (uint64_t i = 0; i < steps; i++) {
+        for (uint64_t j = 0; j < BENCH_NBA_NETS; j++) {
+            stimc_net_set_uint64_nonblock (bench_nets[j], i + j);
+        }
+        stimc_wait_time (1, SC_NS);
+    }
+    bench_end ("nba_flush", "nonblocking assignment queued and flushed", steps * BENCH_NBA_NETS);
+}
+
+/******************************************************************************************************/
+/* output */
+/******************************************************************************************************/
+static void bench_write_json (FILE *f)
+{
+    fprintf (f, "{\n");
+    fprintf (f, "  \"suite\": \"stimc_bench\",\n");
+    fprintf (f, "  \"stimc_version\": \"%u.%u.%u\",\n", stimc_version_major, stimc_version_minor, stimc_version_patch);
+    fprintf (f, "  \"thread_impl\": \"%s\",\n", STIMC_BENCH_THREAD_IMPL);
+    fprintf (f, "  \"scale_divisor\": %u,\n", bench_divisor);
+    fprintf (f, "  \"benchmarks\": [\n");
+
+    for (size_t i = 0; i < bench_results_num; i++) {
+        const struct bench_result_s *r = &bench_results[i];
+
+        double ns_per_op = (r->ops > 0) ? (1e9 * r->seconds / (double)r->ops) : 0.0;
+        double ops_per_s = (r->seconds > 0.0) ? ((double)r->ops / r->seconds) : 0.0;
+
+        fprintf (f, "    {\"name\": \"%s\", \"op\": \"%s\", \"ops\": %" PRIu64 ", \"seconds\": %.6f, "
+                 "\"ns_per_op\": %.3f, \"ops_per_second\": %.1f, \"vpi_callbacks\": %" PRIu64 ", \"vpi_put_value\": %" PRIu64 "}%s\n",
+                 r->name, r->op, r->ops, r->seconds, ns_per_op, ops_per_s, r->vpi_callbacks, r->vpi_put_value,
+                 (i + 1 < bench_results_num) ? "," : "");
+    }
+
+    fprintf (f, "  ]\n");
+    fprintf (f, "}\n");
+}
+
+static void bench_driver (void *userdata __attribute__((unused)))
+{
+    bench_spawn_finish ();
+    bench_context_switch ();
+    bench_event_fanout ();
+    bench_wait_time ();
+    bench_nba_flush ();
+
+    if (bench_output != NULL) {
+        FILE *f = fopen (bench_output, "w");
+        if (f == NULL) {
+            perror (bench_output);
+            exit (1);
+        }
+        bench_write_json (f);
+        fclose (f);
+    } else {
+        bench_write_json (stdout);
+    }
+
+    stimc_finish ();
+}
+
+/******************************************************************************************************/
+/* stimc module */
+/******************************************************************************************************/
+static void bench_module_free (void *data __attribute__((unused)))
+{
+    for (size_t i = 0; i < BENCH_NBA_NETS; i++) {
+        stimc_port_free (bench_nets[i]);
+    }
+    stimc_event_free (bench_done);
+    stimc_event_free (bench_ping);
+    stimc_event_free (bench_pong);
+    stimc_module_free (&bench_module);
+}
+
+STIMC_EXPORT (bench)
+{
+    stimc_module_init (&bench_module, bench_module_free, NULL);
+
+    for (size_t i = 0; i < BENCH_NBA_NETS; i++) {
+        char name[16];
+        snprintf (name, sizeof (name), "n%zu", i);
+        bench_nets[i] = stimc_port_init (&bench_module, name);
+    }
+
+    bench_done = stimc_event_create ();
+    bench_ping = stimc_event_create ();
+    bench_pong = stimc_event_create ();
+
+    stimc_spawn_thread (bench_driver, NULL, 0);
+}
+
+/******************************************************************************************************/
+/* main */
+/******************************************************************************************************/
+static void bench_usage (const char *prog)
+{
+    fprintf (stderr, "usage: %s [-q|--quick] [-o <file.json>] [+<plusarg> ...]\n", prog);
+}
+
+static void bench_init (void *data)
+{
+    if (!vpi_mock_systf_call ("$stimc_bench_init", (vpiHandle)data)) {
+        fprintf (stderr, "stimc_bench: module bench is not registered\n");
+        exit (1);
+    }
+}
+
+int main (int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp (argv[i], "-q") == 0) || (strcmp (argv[i], "--quick") == 0)) {
+            bench_divisor = BENCH_QUICK_DIVISOR;
+        } else if ((strcmp (argv[i], "-o") == 0) && (i + 1 < argc)) {
+            i++;
+            bench_output = argv[i];
+        } else if (argv[i][0] == '+') {
+            /* plusargs for stimc (e.g. +stimc_trace=<file>) */
+        } else {
+            bench_usage (argv[0]);
+            return 1;
+        }
+    }
+
+    vpi_mock_set_args (argc, argv);
+    vpi_mock_startup (vlog_startup_routines);
+
+    vpiHandle top = vpi_mock_module_create (NULL, "bench");
+    for (size_t i = 0; i < BENCH_NBA_NETS; i++) {
+        char name[16];
+        snprintf (name, sizeof (name), "n%zu", i);
+        vpi_mock_net_create (top, name, vpiReg, 32);
+    }
+
+    vpi_mock_schedule (0, bench_init, top);
+
+    vpi_mock_run (UINT64_MAX);
+
+    return vpi_mock_end () ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+#include <dummy.h>
+#include <logging.h>
+#include <tb_selfcheck.h>
+
+#include <vector>
+
+using namespace stimcxx;
+
+static int errors = 0;
+static int checks = 0;
+
+static bool check (int id, uint64_t expected, uint64_t actual) {
+    checks++;
+    if (expected == actual) {
+        log_good ("Check %d - PASS: value was 0x%lx (as expected)", id, actual);
+        return true;
+    } else {
+        errors++;
+        log_bad  ("Check %d - FAIL: value was 0x%lx (expected 0x%lx)", id, actual, expected);
+        return false;
+    }
+}
+
+void dummy::testcontrol ()
+{
+    unsigned dw    = DATA_W;
+    unsigned words = (dw + 31) / 32;
+
+    bundle inputs;
+    bundle outputs;
+
+    unsigned i_clk   = inputs.add (clk_i);
+    unsigned i_reset = inputs.add (reset_n_i);
+    unsigned i_din   = inputs.add (data_in_i);
+    unsigned o_dout  = outputs.add (data_out_o);
+
+    /*********************************************/
+    /* check: snapshot */
+    /*********************************************/
+    wait (clk_event);
+    wait (clk_event);
+    wait (clk_event);
+    wait (clk_event);
+    check (1, 3, inputs.snapshot ());
+    check (2, 1, inputs[i_clk]);
+    check (3, 1, inputs[i_reset]);
+
+    /*********************************************/
+    /* check: commit of modified ports only */
+    /*********************************************/
+    outputs[o_dout] = 0x1234;
+    check (4, 1, outputs.commit ());
+    check (5, 0, outputs.commit ());
+    outputs[o_dout] = 0x1234;
+    check (6, 0, outputs.commit ());
+    wait (1, SC_NS);
+    inputs.snapshot ();
+    check (7, 0x1234, inputs[i_din]);
+
+    /*********************************************/
+    /* check: non-blocking commit */
+    /*********************************************/
+    outputs[o_dout] = 0xcafe;
+    check (8, 1, outputs.commit_nonblock ());
+    inputs.snapshot ();
+    check (9, 0x1234, inputs[i_din]);
+    wait (din_event);
+    inputs.snapshot ();
+    check (10, 0xcafe, inputs[i_din]);
+
+    outputs[o_dout] = X;
+    outputs.commit_nonblock ();
+    wait (din_event);
+    inputs.snapshot ();
+    check (11, 1, inputs[i_din] == X);
+
+    /*********************************************/
+    /* check: full width */
+    /*********************************************/
+    std::vector<uint32_t> out (words);
+    std::vector<uint32_t> in  (words);
+
+    for (unsigned i = 0; i < words; i++) {
+        out[i] = 0x11111111 * (i + 1);
+    }
+    if (dw % 32 != 0) out[words - 1] &= (1 << (dw % 32)) - 1;
+
+    outputs[o_dout] = out;
+    outputs.commit_nonblock ();
+    wait (din_event);
+    inputs.snapshot ();
+    inputs[i_din].get (in);
+    for (unsigned i = 0; i < words; i++) {
+        check (12, out[i], in[i]);
+    }
+
+    /*********************************************/
+    /* check: cached ports need no simulator access */
+    /*********************************************/
+    clk_i.enable_cache ();
+    reset_n_i.enable_cache ();
+    check (13, 1, inputs.snapshot ());
+
+    /*********************************************/
+    /* finish */
+    /*********************************************/
+    wait (clk_event);
+    tb_final_check (checks, errors, false);
+
+    /*********************************************/
+}
@@ -0,0 +1,137 @@
+#include <dummy.h>
+#include <logging.h>
+#include <tb_selfcheck.h>
+
+#include <vector>
+
+using namespace stimcxx;
+
+static int errors = 0;
+static int checks = 0;
+
+static uint64_t seen_value = 0;
+static unsigned seen_count = 0;
+
+/* port with access to signed integer value */
+class int_port : public module::port {
+    public:
+        using module::port::port;
+        using module::port::operator=;
+
+        int32_t get_int32 ()
+        {
+            return stimc_net_get_int32 (_port);
+        }
+};
+
+static bool check (int id, uint64_t expected, uint64_t actual) {
+    checks++;
+    if (expected == actual) {
+        log_good ("Check %d - PASS: value was 0x%lx (as expected)", id, actual);
+        return true;
+    } else {
+        errors++;
+        log_bad  ("Check %d - FAIL: value was 0x%lx (expected 0x%lx)", id, actual, expected);
+        return false;
+    }
+}
+
+void dummy::testcontrol ()
+{
+    unsigned dw    = DATA_W;
+    unsigned words = (dw + 31) / 32;
+
+    /* data_in_i already has a change method, clk_i a posedge method */
+    data_in_i.enable_cache ();
+    clk_i.enable_cache ();
+
+    /*********************************************/
+    /* check: edge methods on cached net */
+    /*********************************************/
+    wait (clk_event);
+    uint64_t t_start = time (SC_PS);
+    for (unsigned i = 0; i < 4; i++) {
+        wait (clk_event);
+    }
+    check (1, 8000, time (SC_PS) - t_start);
+    check (2, 1, (uint64_t)clk_i);
+
+    /*********************************************/
+    /* check: cached value in same time step */
+    /*********************************************/
+    data_out_o <<= 0x12345678;
+    wait (din_event);
+    check (3, 0x12345678, (uint64_t)data_in_i);
+    wait (1, SC_NS);
+    check (4, 1, seen_count);
+    check (5, 0x12345678, seen_value);
+
+    data_out_o <<= 0xcafe;
+    check (6, 0x12345678, (uint64_t)data_in_i);
+    wait (din_event);
+    check (7, 2, seen_count);
+    check (8, 0xcafe, seen_value);
+
+    /*********************************************/
+    /* check: x/z values */
+    /*********************************************/
+    data_out_o <<= X;
+    wait (1, SC_NS);
+    check (9, 1, data_in_i == X);
+    data_out_o <<= 0;
+    wait (1, SC_NS);
+    check (10, 0, data_in_i == X);
+
+    /*********************************************/
+    /* check: full width */
+    /*********************************************/
+    std::vector<uint32_t> out (words);
+    std::vector<uint32_t> in  (words);
+
+    for (unsigned i = 0; i < words; i++) {
+        out[i] = 0x11111111 * (i + 1);
+    }
+    if (dw % 32 != 0) out[words - 1] &= (1 << (dw % 32)) - 1;
+
+    data_out_o = out;
+    wait (1, SC_NS);
+    data_in_i.get (in);
+    for (unsigned i = 0; i < words; i++) {
+        check (11, out[i], in[i]);
+    }
+    check (12, out[words - 1] >> 1, data_in_i (dw - 1, 32 * (words - 1) + 1));
+
+    /*********************************************/
+    /* check: sign extension of narrow signed net */
+    /*********************************************/
+    int_port sdata (*this, "sdata_r");
+
+    sdata = 0xf6;
+    wait (1, SC_NS);
+    check (13, (uint32_t)-10, (uint32_t)sdata.get_int32 ());
+    sdata.enable_cache ();
+    check (14, (uint32_t)-10, (uint32_t)sdata.get_int32 ());
+    sdata = 0x80;
+    wait (1, SC_NS);
+    check (15, (uint32_t)-128, (uint32_t)sdata.get_int32 ());
+    sdata = 0x7f;
+    wait (1, SC_NS);
+    check (16, 127, (uint32_t)sdata.get_int32 ());
+
+    /*********************************************/
+    /* finish */
+    /*********************************************/
+    wait (clk_event);
+    tb_final_check (checks, errors, false);
+
+    /*********************************************/
+}
+
+void dummy::testcontrol2 ()
+{
+    while (seen_count < 2) {
+        wait (din_event);
+        seen_value = data_in_i;
+        seen_count++;
+    }
+}
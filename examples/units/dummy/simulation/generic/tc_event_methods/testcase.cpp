@@ -0,0 +1,100 @@
+#include <dummy.h>
+#include <logging.h>
+#include <tb_selfcheck.h>
+
+using namespace stimcxx;
+
+static int errors = 0;
+static int checks = 0;
+
+static event e_method;
+static event e_chain;
+
+static unsigned method_calls = 0;
+static unsigned chain_wakeups = 0;
+
+static event   *e_self       = nullptr;
+static unsigned self_frees   = 0;
+static unsigned after_free   = 0;
+
+static bool check (int id, uint32_t expected, uint32_t actual) {
+    checks++;
+    if (expected == actual) {
+        log_good ("Check %d - PASS: value was %d (as expected)", id, actual);
+        return true;
+    } else {
+        errors++;
+        log_bad  ("Check %d - FAIL: value was %d (expected %d)", id, actual, expected);
+        return false;
+    }
+}
+
+static void method_count (void *data)
+{
+    unsigned *count = static_cast<unsigned *>(data);
+
+    (*count)++;
+}
+
+static void method_chain (void *data __attribute__((unused)))
+{
+    /* triggering from within a method is allowed */
+    e_chain.trigger ();
+}
+
+static void method_self_free (void *data __attribute__((unused)))
+{
+    /* freeing the event from its own method is allowed */
+    delete e_self;
+    e_self = nullptr;
+    self_frees++;
+}
+
+void dummy::testcontrol ()
+{
+    e_method.register_method (method_count, &method_calls);
+    e_method.register_method (method_chain, nullptr);
+
+    wait (clk_event);
+
+    /*********************************************/
+    /* check: methods are called directly on trigger */
+    /*********************************************/
+    for (unsigned i = 1; i <= 5; i++) {
+        e_method.trigger ();
+        check (i, i, method_calls);
+        wait (1, SC_NS);
+    }
+
+    /*********************************************/
+    /* check: threads waiting for event triggered by method */
+    /*********************************************/
+    wait (1, SC_NS);
+    check (6, 5, chain_wakeups);
+
+    /*********************************************/
+    /* check: event freed by its own method */
+    /*********************************************/
+    e_self = new event ();
+    e_self->register_method (method_self_free, nullptr);
+    e_self->register_method (method_count,     &after_free);
+    e_self->trigger ();
+    check (7, 1, self_frees);
+    check (8, 0, after_free);
+
+    /*********************************************/
+    /* finish */
+    /*********************************************/
+    wait (clk_event);
+    tb_final_check (checks, errors, false);
+
+    /*********************************************/
+}
+
+void dummy::testcontrol2 ()
+{
+    while (true) {
+        wait (e_chain);
+        chain_wakeups++;
+    }
+}
@@ -0,0 +1,102 @@
+#include <dummy.h>
+#include <logging.h>
+#include <tb_selfcheck.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+using namespace stimcxx;
+
+static int errors = 0;
+static int checks = 0;
+
+static bool check (int id, uint64_t expected, uint64_t actual) {
+    checks++;
+    if (expected == actual) {
+        log_good ("Check %d - PASS: value was %lu (as expected)", id, actual);
+        return true;
+    } else {
+        errors++;
+        log_bad  ("Check %d - FAIL: value was %lu (expected %lu)", id, actual, expected);
+        return false;
+    }
+}
+
+static const unsigned lines = 20000;
+
+/* count numbered lines in order, return number of lines or index of first mismatch */
+static unsigned count_lines (const char *filename, unsigned *long_lines)
+{
+    FILE *f = fopen (filename, "r");
+    if (f == nullptr) return 0;
+
+    static char line[4096];
+    unsigned    count = 0;
+    *long_lines = 0;
+
+    while (fgets (line, sizeof (line), f) != nullptr) {
+        unsigned n;
+        if (sscanf (line, "INFO:     line %u", &n) == 1) {
+            if (n != count) break;
+            count++;
+        } else if (strlen (line) == sizeof (line) - 1) {
+            (*long_lines)++;
+            /* skip rest of long line */
+            while ((fgets (line, sizeof (line), f) != nullptr) && (strlen (line) == sizeof (line) - 1)) {}
+        }
+    }
+    fclose (f);
+
+    return count;
+}
+
+void dummy::testcontrol ()
+{
+    wait (clk_event);
+
+    /*********************************************/
+    /* check: ordered async file output */
+    /*********************************************/
+    log_to_file_async ("tc_logging.log", false);
+    log_set_console_level (LOG_LEVEL_QUIET);
+
+    for (unsigned i = 0; i < lines / 2; i++) {
+        log_info ("line %u", i);
+    }
+    /* message larger than the ring buffer */
+    std::string large (3 * 1024 * 1024, 'x');
+    log_info ("%s", large.c_str ());
+    for (unsigned i = lines / 2; i < lines; i++) {
+        log_info ("line %u", i);
+    }
+    log_debug ("suppressed");
+
+    log_flush ();
+    log_set_console_level (LOG_LEVEL_DEBUG);
+
+    unsigned long_lines = 0;
+    check (1, lines, count_lines ("tc_logging.log", &long_lines));
+    check (2, 1,     long_lines);
+
+    /*********************************************/
+    /* check: pending output written on close */
+    /*********************************************/
+    log_to_file_async ("tc_logging.log", false);
+    log_set_console_level (LOG_LEVEL_QUIET);
+    for (unsigned i = 0; i < lines; i++) {
+        log_info ("line %u", i);
+    }
+    log_close_file ();
+    log_set_console_level (LOG_LEVEL_DEBUG);
+
+    check (3, lines, count_lines ("tc_logging.log", &long_lines));
+
+    /*********************************************/
+    /* finish */
+    /*********************************************/
+    wait (clk_event);
+    tb_final_check (checks, errors, false);
+
+    /*********************************************/
+}
@@ -0,0 +1,146 @@
+#include <dummy.h>
+#include <logging.h>
+#include <tb_selfcheck.h>
+
+#include <cstdio>
+#include <vector>
+
+using namespace stimcxx;
+
+static int errors = 0;
+static int checks = 0;
+
+static bool check (int id, uint64_t expected, uint64_t actual) {
+    checks++;
+    if (expected == actual) {
+        log_good ("Check %d - PASS: value was 0x%lx (as expected)", id, actual);
+        return true;
+    } else {
+        errors++;
+        log_bad  ("Check %d - FAIL: value was 0x%lx (expected 0x%lx)", id, actual, expected);
+        return false;
+    }
+}
+
+static uint64_t pattern (int32_t addr)
+{
+    return 0x800000000 | (0x01010101 * (uint64_t)addr);
+}
+
+static void write_file (const char *filename, const char *content)
+{
+    FILE *f = fopen (filename, "w");
+    fputs (content, f);
+    fclose (f);
+}
+
+static std::string read_file (const char *filename)
+{
+    char  line[64] = {0};
+    FILE *f        = fopen (filename, "r");
+    if (f != nullptr) {
+        if (fgets (line, sizeof (line), f) == nullptr) line[0] = '\0';
+        fclose (f);
+    }
+    return std::string (line);
+}
+
+void dummy::testcontrol ()
+{
+    memory mem (*this, "tb_dummy.mem");
+
+    wait (clk_event);
+
+    /*********************************************/
+    /* check: geometry */
+    /*********************************************/
+    check (1, 36, mem.width ());
+    check (2, 32, mem.depth ());
+    check (3, 16, mem.base ());
+
+    /*********************************************/
+    /* check: dump/load roundtrip */
+    /*********************************************/
+    for (int32_t a = 16; a < 48; a++) {
+        mem[a] = pattern (a);
+    }
+    check (4, pattern (20), mem[20]);
+    check (5, 1, mem.dump ("tc_memory.hex"));
+    check (6, 1, mem.dump ("tc_memory.bin", STIMC_MEMORY_FORMAT_BIN));
+
+    for (int32_t a = 16; a < 48; a++) {
+        mem[a] = 0;
+    }
+    check (7, 1, mem.load ("tc_memory.hex"));
+    unsigned ok = 0;
+    for (int32_t a = 16; a < 48; a++) {
+        if (mem[a] == pattern (a)) ok++;
+    }
+    check (8, 32, ok);
+
+    for (int32_t a = 16; a < 48; a++) {
+        mem[a] = 0;
+    }
+    check (9, 1, mem.load ("tc_memory.bin", STIMC_MEMORY_FORMAT_BIN));
+    ok = 0;
+    for (int32_t a = 16; a < 48; a++) {
+        if (mem[a] == pattern (a)) ok++;
+    }
+    check (10, 32, ok);
+
+    /*********************************************/
+    /* check: hex syntax and ranges */
+    /*********************************************/
+    write_file ("tc_memory_in.hex",
+                "// comment\n"
+                "@14\n"
+                "1_2345_6789 /* comment */ abc\n"
+                "@2f fffffffff\n");
+    check (11, 1, mem.load ("tc_memory_in.hex"));
+    check (12, 0x123456789, mem[20]);
+    check (13, 0xabc, mem[21]);
+    check (14, 0xfffffffff, mem[47]);
+
+    mem[20] = 0;
+    mem[21] = 0;
+    check (15, 1, mem.load ("tc_memory_in.hex", STIMC_MEMORY_FORMAT_HEX, 21, 1));
+    check (16, 0x0, mem[20]);
+    check (17, 0xabc, mem[21]);
+
+    write_file ("tc_memory_in.hex", "@1e xxxxxxxxz\n");
+    mem.load ("tc_memory_in.hex");
+    mem.dump ("tc_memory.hex", STIMC_MEMORY_FORMAT_HEX, 30, 1);
+    check (18, 1, read_file ("tc_memory.hex") == "xxxxxxxxz\n");
+
+    write_file ("tc_memory_in.hex", "12g4\n");
+    check (19, 0, mem.load ("tc_memory_in.hex"));
+    check (20, 0, mem.load ("tc_memory_missing.hex"));
+
+    write_file ("tc_memory_in.hex", "12 34\n56/78\n");
+    check (21, 0, mem.load ("tc_memory_in.hex"));
+    write_file ("tc_memory_in.hex", "12 34 /* unterminated\n56\n");
+    check (22, 0, mem.load ("tc_memory_in.hex"));
+
+    /*********************************************/
+    /* check: word ranges */
+    /*********************************************/
+    std::vector<uint32_t> out = {0x11111111, 0x1, 0x22222222, 0x2, 0x33333333, 0x3};
+    std::vector<uint32_t> in (6);
+
+    mem.write (40, out);
+    mem.read (40, in);
+    ok = 0;
+    for (unsigned i = 0; i < 6; i++) {
+        if (in[i] == out[i]) ok++;
+    }
+    check (23, 6, ok);
+    check (24, 0x222222222, mem[41]);
+
+    /*********************************************/
+    /* finish */
+    /*********************************************/
+    wait (clk_event);
+    tb_final_check (checks, errors, false);
+
+    /*********************************************/
+}
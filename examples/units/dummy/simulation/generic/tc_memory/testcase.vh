@@ -0,0 +1,8 @@
+reg [35:0] mem [16:47];
+
+initial begin
+    #1000;
+    $display ("ERROR:    timeout");
+    tb_check_failed;
+    tb_final_check;
+end
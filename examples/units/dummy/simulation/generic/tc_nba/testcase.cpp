@@ -0,0 +1,149 @@
+#include <dummy.h>
+#include <logging.h>
+#include <tb_selfcheck.h>
+
+#include <vector>
+
+using namespace stimcxx;
+
+static int errors = 0;
+static int checks = 0;
+
+static const unsigned words = 4;
+
+/* port with raw access for non-blocking bit assignments and aval/bval readback */
+class nba_port : public module::port {
+    public:
+        using module::port::port;
+
+        stimc_port net ()
+        {
+            return _port;
+        }
+};
+
+static bool check (int id, uint64_t expected, uint64_t actual) {
+    checks++;
+    if (expected == actual) {
+        log_good ("Check %d - PASS: value was 0x%lx (as expected)", id, actual);
+        return true;
+    } else {
+        errors++;
+        log_bad  ("Check %d - FAIL: value was 0x%lx (expected 0x%lx)", id, actual, expected);
+        return false;
+    }
+}
+
+/* compare all aval/bval words of net */
+static void check_vector (int id, stimc_port net, const uint32_t *aval, const uint32_t *bval)
+{
+    uint32_t a[words];
+    uint32_t b[words];
+
+    stimc_net_get_vector (net, a, b, words);
+
+    for (unsigned i = 0; i < words; i++) {
+        check (id, aval[i], a[i]);
+        check (id, bval[i], b[i]);
+    }
+}
+
+void dummy::testcontrol ()
+{
+    nba_port   dout (*this, "data_out_o");
+    stimc_port n = dout.net ();
+
+    check (1, 32 * words, (unsigned)DATA_W);
+
+    wait (clk_event);
+    data_out_o = 0;
+    wait (1, SC_NS);
+
+    /*********************************************/
+    /* check: overlapping bit assignments on top of full x */
+    /*********************************************/
+    stimc_net_set_x_nonblock            (n);
+    stimc_net_set_bits_uint64_nonblock  (n,  95,  32, 0x0123456789abcdef);
+    stimc_net_set_bits_z_nonblock       (n,  39,  36);
+    stimc_net_set_bits_uint64_nonblock  (n,  47,  40, 0x5a);
+    stimc_net_set_bits_x_nonblock       (n,  33,  32);
+    stimc_net_set_bits_uint64_nonblock  (n, 127, 124, 0x6);
+
+    /* nothing applied before flush */
+    {
+        const uint32_t aval[words] = {0, 0, 0, 0};
+        const uint32_t bval[words] = {0, 0, 0, 0};
+        check_vector (2, n, aval, bval);
+    }
+    wait (1, SC_NS);
+    {
+        const uint32_t aval[words] = {0xffffffff, 0x89ab5a0f, 0x01234567, 0x6fffffff};
+        const uint32_t bval[words] = {0xffffffff, 0x000000f3, 0x00000000, 0x0fffffff};
+        check_vector (3, n, aval, bval);
+    }
+
+    /*********************************************/
+    /* check: last full assignment discards earlier ones */
+    /*********************************************/
+    stimc_net_set_bits_uint64_nonblock (n, 63, 0, 0xffffffffffffffff);
+    stimc_net_set_z_nonblock           (n);
+    stimc_net_set_uint64_nonblock      (n, 0x1122334455667788);
+    stimc_net_set_bits_x_nonblock      (n, 3, 0);
+    wait (1, SC_NS);
+    {
+        const uint32_t aval[words] = {0x5566778f, 0x11223344, 0, 0};
+        const uint32_t bval[words] = {0x0000000f, 0x00000000, 0, 0};
+        check_vector (4, n, aval, bval);
+    }
+
+    /*********************************************/
+    /* check: bit assignments only, on top of current value */
+    /*********************************************/
+    stimc_net_set_bits_uint64_nonblock (n,  71,  56, 0xbeef);
+    stimc_net_set_bits_uint64_nonblock (n,  63,  60, 0x0);
+    stimc_net_set_bits_z_nonblock      (n, 127, 126);
+    wait (1, SC_NS);
+    {
+        const uint32_t aval[words] = {0x5566778f, 0x0f223344, 0x000000be, 0x00000000};
+        const uint32_t bval[words] = {0x0000000f, 0x00000000, 0x00000000, 0xc0000000};
+        check_vector (5, n, aval, bval);
+    }
+
+    /*********************************************/
+    /* check: bit assignments on top of vector value (bundle commit) */
+    /*********************************************/
+    bundle   outputs;
+    unsigned o_dout = outputs.add (dout);
+
+    outputs[o_dout] = X;
+    outputs.commit_nonblock ();
+    stimc_net_set_bits_uint64_nonblock (n, 71, 8, 0x0123456789abcdef);
+    wait (1, SC_NS);
+    {
+        const uint32_t aval[words] = {0xabcdefff, 0x23456789, 0xffffff01, 0xffffffff};
+        const uint32_t bval[words] = {0x000000ff, 0x00000000, 0xffffff00, 0xffffffff};
+        check_vector (6, n, aval, bval);
+    }
+
+    std::vector<uint32_t> out (words);
+    for (unsigned i = 0; i < words; i++) {
+        out[i] = 0x11111111 * (i + 1);
+    }
+    outputs[o_dout] = out;
+    outputs.commit_nonblock ();
+    stimc_net_set_bits_x_nonblock (n, 100, 90);
+    wait (1, SC_NS);
+    {
+        const uint32_t aval[words] = {0x11111111, 0x22222222, 0xff333333, 0x4444445f};
+        const uint32_t bval[words] = {0x00000000, 0x00000000, 0xfc000000, 0x0000001f};
+        check_vector (7, n, aval, bval);
+    }
+
+    /*********************************************/
+    /* finish */
+    /*********************************************/
+    wait (clk_event);
+    tb_final_check (checks, errors, false);
+
+    /*********************************************/
+}
@@ -0,0 +1,98 @@
+#include <dummy.h>
+#include <logging.h>
+#include <tb_selfcheck.h>
+
+using namespace stimcxx;
+
+static int errors = 0;
+static int checks = 0;
+
+static bool check (int id, uint64_t expected, uint64_t actual) {
+    checks++;
+    if (expected == actual) {
+        log_good ("Check %d - PASS: value was 0x%lx (as expected)", id, actual);
+        return true;
+    } else {
+        errors++;
+        log_bad  ("Check %d - FAIL: value was 0x%lx (expected 0x%lx)", id, actual, expected);
+        return false;
+    }
+}
+
+void dummy::testcontrol ()
+{
+    /* testbench has DATA_W of 128 */
+    port_t<1>   clk  (*this, "clk_i");
+    port_t<128> dout (*this, "data_out_o");
+    port_t<128> din  (*this, "data_in_i");
+
+    /*********************************************/
+    /* check: scalar port */
+    /*********************************************/
+    wait (clk_event);
+    check (1, 1, (uint64_t)clk);
+    check (2, 0, clk == X);
+
+    /*********************************************/
+    /* check: full value */
+    /*********************************************/
+    dout <<= 0x123456789abcdef0;
+    wait (din_event);
+    check (3, 0x123456789abcdef0, (uint64_t)din);
+    check (4, 0x0, din.bits<127, 64>());
+    check (5, 0x12345678, din.bits<63, 32>());
+    check (6, 0x56789abcdef, din.bits<47, 4>());
+    check (7, 0x1, din.bits<60>());
+
+    /*********************************************/
+    /* check: bit ranges across words */
+    /*********************************************/
+    dout = 0;
+    dout.bits<67, 60>() = 0xa5;
+    dout.bits<127, 96>() = 0xffffffff;
+    wait (1, SC_NS);
+    check (8, 0x5000000000000000, (uint64_t)din);
+    check (9, 0xa5, din.bits<67, 60>());
+    check (10, 0xffffffff0000000a, din.bits<127, 64>());
+
+    dout.bits<95, 32>() <<= 0x0123456789abcdef;
+    wait (din_event);
+    check (11, 0x0123456789abcdef, din.bits<95, 32>());
+    check (12, 0xffffffff01234567, din.bits<127, 64>());
+
+    /*********************************************/
+    /* check: x/z values */
+    /*********************************************/
+    dout.bits<7, 0>() = X;
+    wait (1, SC_NS);
+    check (13, 1, din.bits<7, 0>() == X);
+    check (14, 0, din.bits<15, 8>() == X);
+    check (15, 1, din == X);
+    dout = 0x42;
+    wait (1, SC_NS);
+    check (16, 0, din == X);
+    check (17, 0x42, din.bits<7, 0>());
+
+    /*********************************************/
+    /* check: scalar assignment of non-zero values */
+    /*********************************************/
+    port_t<1> rst (*this, "reset_n_i");
+
+    wait (10, SC_NS);
+    rst = 0;
+    check (18, 0, (uint64_t)rst);
+    rst = 2;
+    check (19, 1, (uint64_t)rst);
+    rst = 0;
+    rst <<= 2;
+    wait (1, SC_NS);
+    check (20, 1, (uint64_t)rst);
+
+    /*********************************************/
+    /* finish */
+    /*********************************************/
+    wait (clk_event);
+    tb_final_check (checks, errors, false);
+
+    /*********************************************/
+}
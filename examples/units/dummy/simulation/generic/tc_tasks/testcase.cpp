@@ -0,0 +1,163 @@
+#include <dummy.h>
+#include <logging.h>
+#include <tb_selfcheck.h>
+
+using namespace stimcxx;
+
+static int errors = 0;
+static int checks = 0;
+
+static const unsigned num_agents = 1000;
+
+static event e_start;
+static event e_a;
+static event e_b;
+
+static unsigned agent_wakeups = 0;
+static unsigned agents_done   = 0;
+static unsigned event_wakeups = 0;
+static unsigned any_wakeups   = 0;
+static unsigned all_wakeups   = 0;
+static unsigned timeouts      = 0;
+static unsigned no_timeouts   = 0;
+static uint64_t nested_time   = 0;
+static bool     nested_caught = false;
+
+static bool check (int id, uint32_t expected, uint32_t actual) {
+    checks++;
+    if (expected == actual) {
+        log_good ("Check %d - PASS: value was %d (as expected)", id, actual);
+        return true;
+    } else {
+        errors++;
+        log_bad  ("Check %d - FAIL: value was %d (expected %d)", id, actual, expected);
+        return false;
+    }
+}
+
+static task agent (unsigned id)
+{
+    co_await e_start;
+
+    for (unsigned i = 0; i < 10; i++) {
+        co_await co::wait ((id % 7) + 1, SC_NS);
+        agent_wakeups++;
+    }
+
+    agents_done++;
+}
+
+static task event_waiter ()
+{
+    while (true) {
+        co_await e_a;
+        event_wakeups++;
+    }
+}
+
+static task combination_waiter ()
+{
+    co_await (e_a | e_b);
+    any_wakeups++;
+
+    co_await (e_a & e_b);
+    all_wakeups++;
+}
+
+static task timeout_waiter ()
+{
+    bool timeout;
+
+    timeout = co_await co::wait (e_b, 5, SC_NS);
+    if (timeout) timeouts++;
+
+    timeout = co_await co::wait (e_b, 5, SC_NS);
+    if (!timeout) no_timeouts++;
+}
+
+static task nested_delay (uint64_t delay)
+{
+    co_await co::wait (delay, SC_NS);
+}
+
+static task nested_throw ()
+{
+    co_await co::wait (1, SC_NS);
+    throw 42;
+}
+
+static task nested ()
+{
+    uint64_t start = time (SC_NS);
+
+    co_await nested_delay (3);
+    co_await nested_delay (4);
+
+    nested_time = time (SC_NS) - start;
+
+    try {
+        co_await nested_throw ();
+    } catch (int &e) {
+        nested_caught = (e == 42);
+    }
+}
+
+void dummy::testcontrol ()
+{
+    for (unsigned i = 0; i < num_agents; i++) {
+        spawn (agent (i));
+    }
+    spawn (event_waiter ());
+    spawn (combination_waiter ());
+
+    wait (clk_event);
+
+    /*********************************************/
+    /* check: many agents waiting on time */
+    /*********************************************/
+    e_start.trigger ();
+    wait (100, SC_NS);
+    check (1, num_agents, agents_done);
+    check (2, 10 * num_agents, agent_wakeups);
+
+    /*********************************************/
+    /* check: events and event combinations */
+    /*********************************************/
+    e_a.trigger ();
+    wait (1, SC_NS);
+    check (3, 1, event_wakeups);
+    check (4, 1, any_wakeups);
+    check (5, 0, all_wakeups);
+
+    e_a.trigger ();
+    e_b.trigger ();
+    wait (1, SC_NS);
+    check (6, 2, event_wakeups);
+    check (7, 1, all_wakeups);
+
+    /*********************************************/
+    /* check: wait with timeout */
+    /*********************************************/
+    spawn (timeout_waiter ());
+    wait (7, SC_NS);
+    check (8, 1, timeouts);
+    e_b.trigger ();
+    wait (1, SC_NS);
+    check (9, 1, no_timeouts);
+
+    /*********************************************/
+    /* check: awaiting tasks */
+    /*********************************************/
+    spawn (nested ());
+    wait (10, SC_NS);
+    check (10, 7, nested_time);
+    check (11, 1, nested_caught);
+
+    /*********************************************/
+    /* finish */
+    /*********************************************/
+    wait (clk_event);
+    tb_final_check (checks, errors, false);
+
+    /*********************************************/
+}
@@ -57,6 +57,28 @@ static struct t_data d1 (1, e1, e2);
 static struct t_data d2 (2, e2, e3);
 static struct t_data d3 (3, e3, e1);
 
+static unsigned short_done = 0;
+
+static unsigned long_done = 0;
+
+static void func_long_seconds (unsigned *done)
+{
+    wait (1e30);
+    (*done)++;
+}
+
+static void func_long_int (unsigned *done)
+{
+    wait (UINT64_MAX, SC_S);
+    (*done)++;
+}
+
+static void func_short (unsigned *done)
+{
+    wait (1, SC_NS);
+    (*done)++;
+}
+
 void dummy::testcontrol ()
 {
     STIMCXX_SPAWN_THREAD (func_t, &d1);
@@ -73,6 +95,54 @@ void dummy::testcontrol ()
         log_error ("value != expected value (10)");
         errors++;
     }
+    checks++;
+
+    /* stacks of finished threads are reused */
+    uint64_t hits_start, misses_start;
+    stimc_thread_stack_pool_stats (&hits_start, &misses_start);
+
+    static const unsigned short_num = 8;
+    for (unsigned i = 0; i < short_num; i++) {
+        STIMCXX_SPAWN_THREAD (func_short, &short_done);
+        wait (2, SC_NS);
+    }
+
+    uint64_t hits, misses;
+    stimc_thread_stack_pool_stats (&hits, &misses);
+    log_info ("stack pool: %lu hits, %lu misses", hits - hits_start, misses - misses_start);
+    if (short_done != short_num) {
+        log_error ("finished threads: %u (expected %u)", short_done, short_num);
+        errors++;
+    }
+#ifdef STIMC_DISABLE_THREAD_STACK_POOL
+    if ((misses - misses_start != short_num) || (hits != hits_start)) {
+        log_error ("thread stacks reused with disabled pool");
+        errors++;
+    }
+#else
+    if ((misses - misses_start > 1) || (hits - hits_start < short_num - 1)) {
+        log_error ("thread stacks not reused");
+        errors++;
+    }
+#endif
+    checks += 2;
+
+    /* wait times beyond the maximum simulation time are clamped, negative ones ignored */
+    STIMCXX_SPAWN_THREAD (func_long_seconds, &long_done);
+    STIMCXX_SPAWN_THREAD (func_long_int,     &long_done);
+
+    uint64_t start = time (SC_PS);
+    wait (-1.0);
+    if (time (SC_PS) != start) {
+        log_error ("negative wait time advanced time");
+        errors++;
+    }
+    wait (10, SC_NS);
+    if (long_done != 0) {
+        log_error ("overflowing wait time finished early");
+        errors++;
+    }
+    checks += 2;
 
     tb_final_check (checks, errors, false);
 }
@@ -0,0 +1,83 @@
+#include <dummy.h>
+#include <logging.h>
+#include <tb_selfcheck.h>
+
+#include <vector>
+#include <array>
+
+using namespace stimcxx;
+
+static int errors = 0;
+static int checks = 0;
+
+static bool check (int id, uint32_t expected, uint32_t actual) {
+    checks++;
+    if (expected == actual) {
+        log_good ("Check %d - PASS: value was 0x%08x (as expected)", id, actual);
+        return true;
+    } else {
+        errors++;
+        log_bad  ("Check %d - FAIL: value was 0x%08x (expected 0x%08x)", id, actual, expected);
+        return false;
+    }
+}
+
+void dummy::testcontrol ()
+{
+    unsigned dw    = DATA_W;
+    unsigned words = (dw + 31) / 32;
+
+    std::vector<uint32_t> out (words);
+    std::vector<uint32_t> in  (words + 2, 0xffffffff);
+
+    for (unsigned i = 0; i < words; i++) {
+        out[i] = (0x01020304 * (i + 1)) ^ 0xa5a5a5a5;
+    }
+    if (dw % 32 != 0) out[words - 1] &= (1 << (dw % 32)) - 1;
+
+    wait (clk_event);
+
+    /*********************************************/
+    /* check: full width assignment + read */
+    /*********************************************/
+    data_out_o = out;
+    wait (1, SC_NS);
+    data_in_i.get (in);
+    for (unsigned i = 0; i < words; i++) {
+        check (1, out[i], in[i]);
+    }
+    check (2, 0, in[words]);
+    check (3, 0, in[words + 1]);
+    check (4, out[0], data_in_i (31, 0));
+
+    /*********************************************/
+    /* check: partial assignment (zero extended) */
+    /*********************************************/
+    data_out_o = std::array<uint32_t, 1> {{0xdeadbeef}};
+    wait (1, SC_NS);
+    data_in_i.get (in);
+    check (5, 0xdeadbeef & (dw < 32 ? (1 << dw) - 1 : 0xffffffff), in[0]);
+    for (unsigned i = 1; i < words; i++) {
+        check (6, 0, in[i]);
+    }
+
+    /*********************************************/
+    /* check: x/z read as 0 */
+    /*********************************************/
+    data_out_o = out;
+    wait (1, SC_NS);
+    data_out_o = X;
+    wait (1, SC_NS);
+    data_in_i.get (in);
+    for (unsigned i = 0; i < words; i++) {
+        check (7, 0, in[i]);
+    }
+
+    /*********************************************/
+    /* finish */
+    /*********************************************/
+    wait (clk_event);
+    tb_final_check (checks, errors, false);
+
+    /*********************************************/
+}
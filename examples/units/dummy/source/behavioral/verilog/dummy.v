@@ -12,6 +12,9 @@ module dummy (
     input  [DATA_W-1:0] data_in_i;
     output [DATA_W-1:0] data_out_o;
 
+    /* signed value accessed by testcases */
+    reg signed [7:0]    sdata_r;
+
     initial begin
         $stimc_dummy_init();
     end
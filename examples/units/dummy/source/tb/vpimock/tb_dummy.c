@@ -0,0 +1,127 @@
+/*
+ * vpimock counterpart of tb_dummy.v (time precision 1ps).
+ *
+ * Contains the union of what the generic testcase.vh files add:
+ * data_out -> data_in loopback, memory mem [16:47] and the timeout.
+ * The dut additionally contains the signed variable sdata_r of dummy.v.
+ */
+#include <vpi_mock.h>
+#include <tb_selfcheck.h>
+#include <logging.h>
+#include <stdlib.h>
+
+#define DATA_W    128
+#define CLKPERIOD 2000
+#define TIMEOUT   1000000
+
+static vpiHandle clk;
+static vpiHandle reset_n;
+static vpiHandle data_in;
+static vpiHandle data_out;
+
+static PLI_INT32 clk_val = 0;
+
+static void tb_assign_int (vpiHandle net, PLI_INT32 value)
+{
+    s_vpi_value v;
+
+    v.format        = vpiIntVal;
+    v.value.integer = value;
+    vpi_put_value (net, &v, NULL, vpiNoDelay);
+}
+
+static void tb_clk (void *data __attribute__((unused)))
+{
+    clk_val = !clk_val;
+    tb_assign_int (clk, clk_val);
+
+    vpi_mock_schedule (CLKPERIOD / 2, tb_clk, NULL);
+}
+
+static void tb_reset_release (void *data __attribute__((unused)))
+{
+    tb_assign_int (reset_n, 1);
+}
+
+static void tb_init (void *data __attribute__((unused)))
+{
+    tb_assign_int (clk, 0);
+    tb_assign_int (reset_n, 0);
+
+    vpi_mock_schedule (CLKPERIOD / 2,      tb_clk,           NULL);
+    vpi_mock_schedule (33 * CLKPERIOD / 10, tb_reset_release, NULL);
+}
+
+static void tb_dut_init (void *data)
+{
+    if (!vpi_mock_systf_call ("$stimc_dummy_init", (vpiHandle)data)) {
+        log_error ("stimc module dummy is not registered");
+        exit (1);
+    }
+}
+
+/* always @(data_out_s) data_in = data_out_s; */
+static void tb_loopback (void *data __attribute__((unused)))
+{
+    s_vpi_value v;
+
+    v.format = vpiVectorVal;
+    vpi_get_value (data_out, &v);
+    vpi_put_value (data_in, &v, NULL, vpiNoDelay);
+}
+
+static PLI_INT32 tb_data_out_changed (struct t_cb_data *cb_data __attribute__((unused)))
+{
+    vpi_mock_schedule (0, tb_loopback, NULL);
+    return 0;
+}
+
+static void tb_timeout (void *data __attribute__((unused)))
+{
+    log_error ("timeout");
+    tb_final_check (1, 1, false);
+}
+
+int main (void)
+{
+    vpi_mock_startup (vlog_startup_routines);
+
+    vpiHandle tb = vpi_mock_module_create (NULL, "tb_dummy");
+
+    vpi_mock_parameter_create (tb, "DATA_W", DATA_W);
+    vpi_mock_memory_create (tb, "mem", 36, 16, 47);
+
+    vpiHandle dut = vpi_mock_module_create (tb, "i_dummy");
+
+    vpi_mock_parameter_create (dut, "DATA_W", DATA_W);
+    clk      = vpi_mock_net_create (dut, "clk_i",      vpiNet, 1);
+    reset_n  = vpi_mock_net_create (dut, "reset_n_i",  vpiNet, 1);
+    data_in  = vpi_mock_net_create (dut, "data_in_i",  vpiNet, DATA_W);
+    data_out = vpi_mock_net_create (dut, "data_out_o", vpiNet, DATA_W);
+
+    vpi_mock_net_set_signed (vpi_mock_net_create (dut, "sdata_r", vpiReg, 8));
+
+    s_cb_data   cb_data;
+    s_vpi_time  cb_time;
+    s_vpi_value cb_value;
+
+    cb_time.type    = vpiSuppressTime;
+    cb_value.format = vpiSuppressVal;
+
+    cb_data.reason    = cbValueChange;
+    cb_data.cb_rtn    = tb_data_out_changed;
+    cb_data.obj       = data_out;
+    cb_data.time      = &cb_time;
+    cb_data.value     = &cb_value;
+    cb_data.index     = 0;
+    cb_data.user_data = NULL;
+    vpi_free_object (vpi_register_cb (&cb_data));
+
+    vpi_mock_schedule (0,       tb_init,     NULL);
+    vpi_mock_schedule (0,       tb_dut_init, dut);
+    vpi_mock_schedule (TIMEOUT, tb_timeout,  NULL);
+
+    vpi_mock_run (UINT64_MAX);
+
+    return vpi_mock_end () ? 0 : 1;
+}
@@ -22,6 +22,10 @@
 #include <vpi_user.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
 #include <assert.h>
 
 static const char ANSI_COLOR_RED[]     = "\x1b[31m";
@@ -57,8 +61,35 @@ static const char *ansi_bold          = ANSI_NOTHING;
 /* logging to file */
 static FILE *logfile = NULL;
 
+/* asynchronous file sink: ring buffer drained by a writer thread */
+#ifndef LOGGING_ASYNC_BUFFER_SIZE
+#define LOGGING_ASYNC_BUFFER_SIZE (1024 * 1024)
+#endif
+/* writer is woken up at this fill level, otherwise writes periodically */
+#define LOGGING_ASYNC_WATERMARK   (LOGGING_ASYNC_BUFFER_SIZE / 8)
+#define LOGGING_ASYNC_INTERVAL_NS 100000000
+
+struct log_async_s {
+    char  *buf;
+    size_t size;
+    size_t head;                /* bytes queued in total (producer) */
+    size_t tail;                /* bytes written in total (writer) */
+    bool   drain;               /* write pending data without waiting for watermark */
+    bool   stop;
+
+    pthread_t       writer;
+    pthread_mutex_t lock;
+    pthread_cond_t  data_cond;  /* signaled on new data or stop */
+    pthread_cond_t  space_cond; /* signaled after data has been written */
+};
+
+static struct log_async_s *log_async = NULL;
+static bool                log_async_callbacks = false;
+
 /* log level */
 static enum log_level current_level = LOG_LEVEL_INFO;
+static enum log_level console_level = LOG_LEVEL_DEBUG;
+static enum log_level message_level = LOG_LEVEL_INFO;
 
 #define LOG_HEADER_SIZE 128
 static char         log_header_file[LOG_HEADER_SIZE];
@@ -84,13 +115,14 @@ static enum log_mode current_mode    = LOG_MODE_INIT;
 static enum log_mode last_mode       = LOG_MODE_INIT;
 static bool          log_autonewline = true;
 
-static void log_base_reset (enum log_mode mode)
+static void log_base_reset (enum log_mode mode, enum log_level level)
 {
     log_header_file[0]  = '\0';
     log_header_out[0]   = '\0';
     log_header_file_pos = 0;
     log_header_out_pos  = 0;
     current_mode        = mode;
+    message_level       = level;
 }
 
 static void log_base_modify (const char *mod)
@@ -118,6 +150,153 @@ static void log_base_header (const char *header)
 }
 
 
+static bool log_async_ready (const struct log_async_s *async)
+{
+    return (async->stop) || (async->drain) || (async->head - async->tail >= LOGGING_ASYNC_WATERMARK);
+}
+
+static void *log_async_writer (void *userdata)
+{
+    struct log_async_s *async = (struct log_async_s *)userdata;
+
+    pthread_mutex_lock (&(async->lock));
+    while (true) {
+        while (!log_async_ready (async)) {
+            struct timespec deadline;
+            clock_gettime (CLOCK_MONOTONIC, &deadline);
+            deadline.tv_nsec += LOGGING_ASYNC_INTERVAL_NS;
+            if (deadline.tv_nsec >= 1000000000) {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000;
+            }
+
+            int result = pthread_cond_timedwait (&(async->data_cond), &(async->lock), &deadline);
+            if ((result == ETIMEDOUT) && (async->head != async->tail)) break;
+        }
+        if (async->head == async->tail) {
+            if (async->stop) break;
+            continue;
+        }
+
+        size_t head = async->head;
+        size_t tail = async->tail;
+        async->drain = false;
+        pthread_mutex_unlock (&(async->lock));
+
+        /* only the writer accesses the file while data is pending */
+        while (tail != head) {
+            size_t pos = tail % async->size;
+            size_t len = head - tail;
+            if (len > async->size - pos) len = async->size - pos;
+
+            fwrite (&(async->buf[pos]), 1, len, logfile);
+            tail += len;
+        }
+
+        pthread_mutex_lock (&(async->lock));
+        async->tail = tail;
+        pthread_cond_broadcast (&(async->space_cond));
+    }
+    pthread_mutex_unlock (&(async->lock));
+
+    return NULL;
+}
+
+static void log_async_put (struct log_async_s *async, const char *data, size_t len)
+{
+    pthread_mutex_lock (&(async->lock));
+    while (len > 0) {
+        /* buffer full: wait for writer instead of dropping messages */
+        while (async->head - async->tail == async->size) {
+            async->drain = true;
+            pthread_cond_signal (&(async->data_cond));
+            pthread_cond_wait (&(async->space_cond), &(async->lock));
+        }
+
+        size_t pos  = async->head % async->size;
+        size_t fill = async->head - async->tail;
+        size_t n    = len;
+        if (n > async->size - fill) n = async->size - fill;
+        if (n > async->size - pos) n = async->size - pos;
+
+        memcpy (&(async->buf[pos]), data, n);
+
+        if ((fill < LOGGING_ASYNC_WATERMARK) && (fill + n >= LOGGING_ASYNC_WATERMARK)) {
+            pthread_cond_signal (&(async->data_cond));
+        }
+        async->head += n;
+        data        += n;
+        len         -= n;
+    }
+    pthread_mutex_unlock (&(async->lock));
+}
+
+static void log_async_drain (struct log_async_s *async)
+{
+    pthread_mutex_lock (&(async->lock));
+    if (async->head != async->tail) {
+        async->drain = true;
+        pthread_cond_signal (&(async->data_cond));
+    }
+    while (async->head != async->tail) {
+        pthread_cond_wait (&(async->space_cond), &(async->lock));
+    }
+    pthread_mutex_unlock (&(async->lock));
+}
+
+static void log_async_free (struct log_async_s *async)
+{
+    pthread_mutex_lock (&(async->lock));
+    async->stop = true;
+    pthread_cond_signal (&(async->data_cond));
+    pthread_mutex_unlock (&(async->lock));
+
+    pthread_join (async->writer, NULL);
+
+    pthread_cond_destroy (&(async->space_cond));
+    pthread_cond_destroy (&(async->data_cond));
+    pthread_mutex_destroy (&(async->lock));
+    free (async->buf);
+    free (async);
+}
+
+static PLI_INT32 log_async_end_of_simulation (struct t_cb_data *cb_data __attribute__((unused)))
+{
+    /* keep file open for messages from later cleanup, closed at exit */
+    log_flush ();
+
+    return 0;
+}
+
+static void log_async_register_callbacks (void)
+{
+    if (log_async_callbacks) return;
+    log_async_callbacks = true;
+
+    s_cb_data data = {
+        .reason = cbEndOfSimulation,
+        .cb_rtn = log_async_end_of_simulation,
+    };
+    vpiHandle cb = vpi_register_cb (&data);
+    if (cb != NULL) vpi_free_object (cb);
+
+    atexit (log_close_file);
+}
+
+static void log_file_write (const char *data, size_t len)
+{
+    if (log_async != NULL) {
+        log_async_put (log_async, data, len);
+    } else {
+        fwrite (data, 1, len, logfile);
+    }
+}
+
+static void log_file_puts (const char *str)
+{
+    log_file_write (str, strlen (str));
+}
+
 static void log_base_vprintf (const char *format, va_list arg_list)
 {
     #define LOG_BUFF_SIZE 4096
@@ -144,7 +323,8 @@ static void log_base_vprintf (const char *format, va_list arg_list)
         assert (would_have_written < size_target);
     }
 
-    char *line = log_string;
+    char *line    = log_string;
+    bool  console = (message_level >= console_level);
 
     while (line != NULL) {
         char *line_next = line;
@@ -161,35 +341,45 @@ static void log_base_vprintf (const char *format, va_list arg_list)
         if (log_autonewline) {
             /* always add header and newline (for newline and at end of message) */
             if (logfile != NULL) {
-                fprintf (logfile, "%s%s\n", log_header_file, line);
+                log_file_write (log_header_file, log_header_file_pos);
+                log_file_puts (line);
+                log_file_write ("\n", 1);
             }
 
-            vpi_printf ("%s%s%s\n", log_header_out, line, ansi_reset);
+            if (console) {
+                vpi_printf ("%s%s%s\n", log_header_out, line, ansi_reset);
+            }
         } else if ((*line != '\0') || (newline)) {
             /* header - only after newline (last_mode == INIT) or log-type change */
             if (current_mode != last_mode) {
                 if (logfile != NULL) {
-                    fprintf (logfile, "%s", log_header_file);
+                    log_file_write (log_header_file, log_header_file_pos);
                 }
 
-                vpi_printf ("%s%s", ansi_reset, log_header_out);
+                if (console) {
+                    vpi_printf ("%s%s", ansi_reset, log_header_out);
+                }
                 last_mode = current_mode;
             }
 
             /* text */
             if (logfile != NULL) {
-                fprintf (logfile, "%s", line);
+                log_file_puts (line);
             }
 
-            vpi_printf ("%s", line);
+            if (console) {
+                vpi_printf ("%s", line);
+            }
 
             /* newline ? */
             if (newline) {
                 if (logfile != NULL) {
-                    fprintf (logfile, "\n");
+                    log_file_write ("\n", 1);
                 }
 
-                vpi_printf ("%s\n", ansi_reset);
+                if (console) {
+                    vpi_printf ("%s\n", ansi_reset);
+                }
                 last_mode = LOG_MODE_INIT;
             }
         }
@@ -212,8 +402,61 @@ void log_to_file (const char *filename, bool append)
     }
 }
 
+void log_to_file_async (const char *filename, bool append)
+{
+    log_to_file (filename, append);
+    if (logfile == NULL) return;
+
+    struct log_async_s *async = (struct log_async_s *)malloc (sizeof (struct log_async_s));
+    assert (async);
+
+    async->size = LOGGING_ASYNC_BUFFER_SIZE;
+    async->buf  = (char *)malloc (async->size);
+    assert (async->buf);
+    async->head  = 0;
+    async->tail  = 0;
+    async->drain = false;
+    async->stop  = false;
+
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init (&cond_attr);
+    pthread_condattr_setclock (&cond_attr, CLOCK_MONOTONIC);
+
+    pthread_mutex_init (&(async->lock), NULL);
+    pthread_cond_init (&(async->data_cond), &cond_attr);
+    pthread_cond_init (&(async->space_cond), NULL);
+    pthread_condattr_destroy (&cond_attr);
+
+    if (pthread_create (&(async->writer), NULL, log_async_writer, async) != 0) {
+        pthread_cond_destroy (&(async->space_cond));
+        pthread_cond_destroy (&(async->data_cond));
+        pthread_mutex_destroy (&(async->lock));
+        free (async->buf);
+        free (async);
+        log_warn ("could not start writer thread for logfile %s, logging synchronously", filename);
+        return;
+    }
+
+    log_async = async;
+    log_async_register_callbacks ();
+}
+
+void log_flush (void)
+{
+    if (logfile == NULL) return;
+
+    if (log_async != NULL) {
+        log_async_drain (log_async);
+    }
+    fflush (logfile);
+}
+
 void log_close_file (void)
 {
+    if (log_async != NULL) {
+        log_async_free (log_async);
+        log_async = NULL;
+    }
     if (logfile != NULL) {
         fclose (logfile);
         logfile = NULL;
@@ -230,6 +473,11 @@ enum log_level log_get_level (void)
     return current_level;
 }
 
+void log_set_console_level (enum log_level level)
+{
+    console_level = level;
+}
+
 /* colors */
 void log_colors_on (void)
 {
@@ -265,7 +513,7 @@ void log_set_newline_mode (bool autonewline)
 /* log functions */
 void log_error (const char *format, ...)
 {
-    log_base_reset  (LOG_MODE_ERROR);
+    log_base_reset  (LOG_MODE_ERROR, LOG_LEVEL_QUIET);
     log_base_modify (ansi_color_red);
     log_base_modify (ansi_bold);
     log_base_header ("ERROR:");
@@ -276,12 +524,15 @@ void log_error (const char *format, ...)
     va_start (argptr, format);
     log_base_vprintf (format, argptr);
     va_end (argptr);
+
+    /* errors are on disk before a possible abort */
+    if (log_async != NULL) log_flush ();
 }
 
 
 void log_warn (const char *format, ...)
 {
-    log_base_reset  (LOG_MODE_WARNING);
+    log_base_reset  (LOG_MODE_WARNING, LOG_LEVEL_QUIET);
     log_base_modify (ansi_color_yellow);
     log_base_modify (ansi_bold);
     log_base_header ("WARNING:");
@@ -297,7 +548,7 @@ void log_warn (const char *format, ...)
 void log_info (const char *format, ...)
 {
     if (current_level > LOG_LEVEL_INFO) return;
-    log_base_reset  (LOG_MODE_INFO);
+    log_base_reset  (LOG_MODE_INFO, LOG_LEVEL_INFO);
     log_base_modify (ansi_bold);
     log_base_header ("INFO:");
     log_base_modify (ansi_reset);
@@ -311,7 +562,7 @@ void log_info (const char *format, ...)
 void log_debug (const char *format, ...)
 {
     if (current_level > LOG_LEVEL_DEBUG) return;
-    log_base_reset  (LOG_MODE_DEBUG);
+    log_base_reset  (LOG_MODE_DEBUG, LOG_LEVEL_DEBUG);
     log_base_modify (ansi_reset);
     log_base_header ("DEBUG:");
     va_list argptr;
@@ -323,7 +574,7 @@ void log_debug (const char *format, ...)
 
 void log_extra (const char *header, const char *format, ...)
 {
-    log_base_reset  (LOG_MODE_EXTRA);
+    log_base_reset  (LOG_MODE_EXTRA, LOG_LEVEL_QUIET);
     log_base_modify (ansi_color_blue);
     log_base_modify (ansi_bold);
     log_base_header (header);
@@ -338,7 +589,7 @@ void log_extra (const char *header, const char *format, ...)
 void log_good (const char *format, ...)
 {
     if (current_level > LOG_LEVEL_INFO) return;
-    log_base_reset  (LOG_MODE_GOOD);
+    log_base_reset  (LOG_MODE_GOOD, LOG_LEVEL_INFO);
     log_base_modify (ansi_color_green);
     log_base_modify (ansi_bold);
     log_base_header ("INFO:");
@@ -351,7 +602,7 @@ void log_good (const char *format, ...)
 
 void log_bad (const char *format, ...)
 {
-    log_base_reset  (LOG_MODE_BAD);
+    log_base_reset  (LOG_MODE_BAD, LOG_LEVEL_QUIET);
     log_base_modify (ansi_color_red);
     log_base_modify (ansi_bold);
     log_base_header ("WARNING:");
@@ -366,12 +617,12 @@ void log_eval (bool good, const char *format, ...)
 {
     if (good) {
         if (current_level > LOG_LEVEL_INFO) return;
-        log_base_reset  (LOG_MODE_GOOD);
+        log_base_reset  (LOG_MODE_GOOD, LOG_LEVEL_INFO);
         log_base_modify (ansi_color_green);
         log_base_modify (ansi_bold);
         log_base_header ("INFO:");
     } else {
-        log_base_reset  (LOG_MODE_BAD);
+        log_base_reset  (LOG_MODE_BAD, LOG_LEVEL_QUIET);
         log_base_modify (ansi_color_red);
         log_base_modify (ansi_bold);
         log_base_header ("WARNING:");
@@ -386,7 +637,7 @@ void log_eval (bool good, const char *format, ...)
 void log_print (const char *format, ...)
 {
     if (current_level > LOG_LEVEL_INFO) return;
-    log_base_reset  (LOG_MODE_PRINT);
+    log_base_reset  (LOG_MODE_PRINT, LOG_LEVEL_INFO);
     log_base_modify (ansi_reset);
     va_list argptr;
 
@@ -398,7 +649,7 @@ void log_print (const char *format, ...)
 void log_print_debug (const char *format, ...)
 {
     if (current_level > LOG_LEVEL_DEBUG) return;
-    log_base_reset  (LOG_MODE_PRINT);
+    log_base_reset  (LOG_MODE_PRINT, LOG_LEVEL_DEBUG);
     log_base_modify (ansi_reset);
     va_list argptr;
 
@@ -137,10 +137,29 @@ void log_print_debug (const char *format, ...) __attribute__((format (printf, 1,
 void log_to_file (const char *filename, bool append);
 
 /**
- * @brief Close logfile opened with @ref log_to_file.
+ * @brief Log to file specified in addition to stdout, writing the file asynchronously.
+ *
+ * @param filename Path to file to open for logging.
+ * @param append Open file in append mode.
+ *
+ * Similar to @ref log_to_file, but formatted messages are queued in a ring buffer
+ * and written to the file in order by a background thread.
+ * Pending messages are written on @ref log_flush, @ref log_close_file, after error messages,
+ * at end of simulation (e.g. after @c $finish or @c stimc_finish) and at program exit.
+ * In case the buffer is full, logging waits for the writer thread.
+ */
+void log_to_file_async (const char *filename, bool append);
+
+/**
+ * @brief Close logfile opened with @ref log_to_file or @ref log_to_file_async.
  */
 void log_close_file (void);
 
+/**
+ * @brief Write all pending messages to the logfile.
+ */
+void log_flush (void);
+
 /**
  * @brief Log levels.
  */
@@ -166,6 +185,18 @@ void log_set_level (enum log_level level);
  */
 enum log_level log_get_level (void);
 
+/**
+ * @brief Set log level for the simulator console.
+ *
+ * @param level Console log level.
+ *
+ * Messages passing the log level (@ref log_set_level) are printed to the
+ * simulator console only if they also pass the console log level, so e.g. with
+ * @ref LOG_LEVEL_QUIET debug and info messages only go to the logfile.
+ * Default console level is @ref LOG_LEVEL_DEBUG.
+ */
+void log_set_console_level (enum log_level level);
+
 /**
  * @brief Log printout newline-mode.
  *
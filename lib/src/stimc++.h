@@ -28,6 +28,17 @@
 #include <stimc.h>
 #include <utility>
 #include <string>
+#include <type_traits>
+#include <cassert>
+
+#if defined (__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L) && !defined (STIMCXX_DISABLE_TASK)
+/**
+ * @brief Defined if C++20 coroutine based @ref stimcxx::task is available.
+ */
+#define STIMCXX_ENABLE_TASK
+#include <coroutine>
+#include <exception>
+#endif
 
 /**
  * @brief stimc++ namespace.
@@ -36,6 +47,17 @@ namespace stimcxx {
     class event_combination_all;
     class event_combination_any;
 
+    /**
+     * @brief Helper for span-like types (contiguous @c data() and @c size()) of 32 bit words.
+     *
+     * Enables vector assignment/read of ports, e.g. for std::vector<uint32_t>,
+     * std::array<uint32_t, N> or std::span<uint32_t>.
+     */
+    template<typename T, typename W = typename std::remove_pointer<decltype (std::declval<T &>().data ())>::type>
+    using enable_if_words = typename std::enable_if<
+        std::is_same<typename std::remove_cv<W>::type, uint32_t>::value
+        && std::is_convertible<decltype (std::declval<T &>().size ()), size_t>::value>::type;
+
 #ifdef STIMCXX_DISABLE_STACK_UNWIND
     constexpr bool enable_stack_unwind = false;
 #else
@@ -163,6 +185,19 @@ namespace stimcxx {
                 stimc_trigger_event (_event);
             }
 
+            /**
+             * @brief Register a callback method for triggers of event.
+             * @brief callback Method to register.
+             * @brief p Data pointer for callback.
+             *
+             * Internal helper. For registering from inside a module
+             * use @ref STIMCXX_REGISTER_EVENT_METHOD for convenience.
+             */
+            void register_method (void (*callback)(void *p), void *p) noexcept
+            {
+                stimc_register_event_method (callback, p, _event);
+            }
+
             /**
              * @brief Combine two events for waiting on both of them
              *
@@ -575,7 +610,7 @@ namespace stimcxx {
              * Meant as base class - not to be constructed directly.
              */
             module () noexcept :
-                _module {nullptr}
+                _module {nullptr, nullptr}
             {
                 stimc_module_init (&(this->_module), module::cleanup, this);
             }
@@ -603,6 +638,9 @@ namespace stimcxx {
                 return vpi_get_str (vpiFullName, _module.mod);
             }
 
+        public:
+            class bundle;
+
         protected:
             /**
              * @brief Wrapper base class for @ref stimc_port.
@@ -612,6 +650,8 @@ namespace stimcxx {
                 protected:
                     stimc_port _port; /**< @brief The actual @ref stimc_port. */
 
+                    friend class bundle;
+
                 public:
                     /**
                      * @brief Port constructor for @ref stimc_port.
@@ -638,6 +678,17 @@ namespace stimcxx {
                         stimc_port_free (this->_port);
                     }
 
+                    /**
+                     * @brief Keep a cached copy of the port value for reading.
+                     * @see @ref stimc_net_enable_cache.
+                     *
+                     * Intended for frequently read input ports that change rarely.
+                     */
+                    void enable_cache () noexcept
+                    {
+                        stimc_net_enable_cache (this->_port);
+                    }
+
                     /**
                      * @brief Register a callback method for posedge events at port.
                      * @brief callback Method to register.
@@ -831,6 +882,35 @@ namespace stimcxx {
                         return *this;
                     }
 
+                    /**
+                     * @brief Immediate assignment operator to port of arbitrary width.
+                     * @param words Span-like container of 32 bit words (least significant first).
+                     * @return reference to the port.
+                     * @see @ref stimc_net_set_vector.
+                     *
+                     * Sets port to specified value similar
+                     * to using a verilog blocking assignment.
+                     */
+                    template<typename T, typename = enable_if_words<const T> >
+                    port& operator= (const T &words) noexcept
+                    {
+                        stimc_net_set_vector (_port, words.data (), nullptr, (unsigned)words.size ());
+                        return *this;
+                    }
+
+                    /**
+                     * @brief Read port of arbitrary width.
+                     * @param words Span-like container of 32 bit words (least significant first) to fill.
+                     * @see @ref stimc_net_get_vector.
+                     *
+                     * x/z bits are read as 0.
+                     */
+                    template<typename T, typename = enable_if_words<T> >
+                    void get (T &&words) noexcept
+                    {
+                        stimc_net_get_vector (_port, words.data (), nullptr, (unsigned)words.size ());
+                    }
+
                     /**
                      * @brief Immediate x/z assignment.
                      * @see @ref stimc_net_set_x and @ref stimc_net_set_z.
@@ -1043,111 +1123,845 @@ namespace stimcxx {
             };
 
             /**
-             * @brief Wrapper class for @ref stimc_parameter.
+             * @brief Wrapper class for @ref stimc_port of fixed width.
+             * @tparam N Width of the port in bits.
+             *
+             * Width dependent masks, word counts and the choice between
+             * scalar and vector access are resolved at compile time, so
+             * reads and blocking writes access the simulator directly
+             * (and use the value cache if enabled) instead of going through
+             * the generic width handling of the stimc net functions.
+             * The width is checked against the actual port on construction.
              */
-            class parameter {
-                protected:
-                    stimc_parameter _parameter; /**<@brief The wrapped @ref stimc_parameter. */
-                    int32_t _value_i;           /**<@brief Cached integer value of parameter. */
-                    double _value_d;            /**<@brief Cached double value of parameter. */
+            template<unsigned N> class port_t : public port_base {
+                static_assert (N > 0, "port width must be at least 1 bit");
+
                 public:
+                    static constexpr unsigned width = N;                     /**< @brief Width of port in bits. */
+                    static constexpr unsigned words = ((N - 1) / 32) + 1;    /**< @brief Number of 32 bit vector words of port value. */
+                    static constexpr uint64_t mask  = (N >= 64) ? ~(uint64_t)0 : (((uint64_t)1 << (N % 64)) - 1); /**< @brief Mask of port value as uint64_t. */
+
                     /**
-                     * @brief Parameter constructor.
-                     * @param m Parent module of parameter.
-                     * @param name Name of the parameter.
+                     * @brief Helper class for access to fixed bit range of signal.
+                     * @tparam MSB Most significant bit.
+                     * @tparam LSB Least significant bit.
                      */
-                    parameter (module &m, const char *name) noexcept :
-                        _parameter (stimc_parameter_init (&(m._module), name)),
-                        _value_i (0),
-                        _value_d (0.0)
-                    {
-                        if (stimc_parameter_get_format (this->_parameter) == vpiRealVal) {
-                            this->_value_d = stimc_parameter_get_double (this->_parameter);
-                            this->_value_i = this->_value_d;
-                        } else {
-                            this->_value_i = stimc_parameter_get_int32 (this->_parameter);
-                            this->_value_d = this->_value_i;
-                        }
-                    }
+                    template<unsigned MSB, unsigned LSB> class subbits_t {
+                        static_assert (MSB >= LSB,      "msb must not be less than lsb");
+                        static_assert (MSB < N,         "bit range exceeds port width");
+                        static_assert (MSB - LSB < 64,  "bit range exceeds 64 bit");
 
-                    parameter            (const parameter &p) = delete; /**< @brief Do not copy/change internals */
-                    parameter& operator= (const parameter &p) = delete; /**< @brief Do not copy/change internals */
-                    parameter            (parameter &&p)      = delete; /**< @brief Do not move/change internals */
-                    parameter& operator= (parameter &&p)      = delete; /**< @brief Do not move/change internals */
+                        private:
+                            static constexpr unsigned jstart = LSB / 32; /**< @brief First vector word of bit range. */
+                            static constexpr unsigned jstop  = MSB / 32; /**< @brief Last vector word of bit range. */
+                            static constexpr unsigned s0     = LSB % 32; /**< @brief Offset of bit range in first vector word. */
+                            static constexpr uint64_t bmask  = (MSB - LSB >= 63) ? ~(uint64_t)0 : (((uint64_t)2 << (MSB - LSB)) - 1); /**< @brief Mask of bit range value. */
 
-                    /**
-                     * @brief Simple destructor
-                     */
-                    ~parameter () noexcept
-                    {
-                        stimc_parameter_free (this->_parameter);
-                    }
+                            port_t &_p; /**< @brief Port accessed by bit range. */
+
+                            /**
+                             * @brief Mask of bit range within vector word.
+                             * @param j Vector word index.
+                             * @return mask of bits in word @c j belonging to bit range.
+                             */
+                            static uint32_t word_mask (unsigned j) noexcept
+                            {
+                                unsigned lo = (j == jstart) ? s0 : 0;
+                                unsigned hi = (j == jstop) ? (MSB % 32) : 31;
+
+                                return (uint32_t)((((uint64_t)2 << hi) - 1) & ~(((uint64_t)1 << lo) - 1));
+                            }
+
+                            /**
+                             * @brief Value part of bit range within vector word.
+                             * @param j Vector word index.
+                             * @param value Bit range value.
+                             * @return part of @c value to place in word @c j (unmasked).
+                             */
+                            static uint32_t word_value (unsigned j, uint64_t value) noexcept
+                            {
+                                if (j == jstart) return (uint32_t)(value << s0);
+
+                                return (uint32_t)(value >> (32 * (j - jstart) - s0));
+                            }
+
+                            /**
+                             * @brief Blocking assignment of bit range.
+                             * @param aval Value aval bits.
+                             * @param bval Value bval bits.
+                             */
+                            void set (uint64_t aval, uint64_t bval) noexcept
+                            {
+                                s_vpi_value v;
+
+                                v.format = vpiVectorVal;
+                                vpi_get_value (_p._port->net, &v);
+
+                                for (unsigned j = jstart; j <= jstop; j++) {
+                                    uint32_t m = word_mask (j);
+
+                                    v.value.vector[j].aval = (PLI_INT32)(((uint32_t)v.value.vector[j].aval & ~m) | (word_value (j, aval) & m));
+                                    v.value.vector[j].bval = (PLI_INT32)(((uint32_t)v.value.vector[j].bval & ~m) | (word_value (j, bval) & m));
+                                }
+
+                                vpi_put_value (_p._port->net, &v, NULL, vpiNoDelay);
+                            }
+
+                        public:
+                            /**
+                             * @brief Constructor for subbit range of port
+                             * @param p Port accessed.
+                             */
+                            explicit subbits_t (port_t &p) noexcept :
+                                _p (p)
+                            {}
+
+                            subbits_t            (const subbits_t &sb) noexcept = default; /**< @brief default copy constructor */
+                            subbits_t            (subbits_t &&sb) noexcept      = default; /**< @brief default move constructor */
+                            subbits_t& operator= (const subbits_t &sb)          = delete;  /**< @brief delete assignment - assignment to be used with values */
+                            subbits_t& operator= (subbits_t &&sb)               = delete;  /**< @brief delete assignment - assignment to be used with values */
+
+                            ~subbits_t () noexcept = default; /**< @brief default destructor */
+
+                            /**
+                             * @brief Cast for reading from port bit range as uint64_t.
+                             * @return Current value of represented port bit range as uint64_t.
+                             */
+                            operator uint64_t () noexcept
+                            {
+                                const s_vpi_vecval *vec = _p.vecval ();
+
+                                uint64_t result = 0;
+
+                                for (unsigned i = 0, j = jstart; j <= jstop; i++, j++) {
+                                    /* prevent sign extension */
+                                    uint64_t word = (uint64_t)((uint32_t)vec[j].aval & ~(uint32_t)vec[j].bval);
+
+                                    if (i == 0) {
+                                        result |= (word >> s0);
+                                    } else {
+                                        result |= (word << (32 * i - s0));
+                                    }
+                                }
+
+                                return result & bmask;
+                            }
+
+                            /**
+                             * @brief Check for x/z value in comparisons.
+                             * @return @ref X if port bit range contains x or z values, @ref not_XZ otherwise.
+                             */
+                            operator bit () noexcept
+                            {
+                                const s_vpi_vecval *vec = _p.vecval ();
+
+                                for (unsigned j = jstart; j <= jstop; j++) {
+                                    if (((uint32_t)vec[j].bval & word_mask (j)) != 0) return bit::X;
+                                }
 
+                                return bit::not_XZ;
+                            }
+
+                            /**
+                             * @brief Immediate assignment operator to port bit range.
+                             * @param value Value to assgin.
+                             * @return reference to the bitrange.
+                             *
+                             * Sets represented bit range of port to specified
+                             * value similar to using a verilog blocking assignment.
+                             */
+                            subbits_t& operator= (uint64_t value) noexcept
+                            {
+                                set (value, 0);
+                                return *this;
+                            }
+
+                            /**
+                             * @brief Immediate x/z assignment.
+                             *
+                             * Sets represented bit range of port to unknown/high impedance
+                             * state similar to using a verilog blocking assignment.
+                             */
+                            subbits_t& operator= (bit v) noexcept
+                            {
+                                if (v == bit::X) {
+                                    set (~(uint64_t)0, ~(uint64_t)0);
+                                } else if (v == bit::Z) {
+                                    set (0, ~(uint64_t)0);
+                                }
+                                return *this;
+                            }
+
+                            /**
+                             * @brief Non-blocking assignment operator to port bit range.
+                             * @param value Value to assgin.
+                             * @return reference to the bitrange.
+                             * @see @ref stimc_net_set_bits_uint64_nonblock.
+                             */
+                            subbits_t& operator<<= (uint64_t value) noexcept
+                            {
+                                stimc_net_set_bits_uint64_nonblock (_p._port, MSB, LSB, value);
+                                return *this;
+                            }
+
+                            /**
+                             * @brief Non-blocking x/z assignment.
+                             * @see @ref stimc_net_set_bits_x_nonblock and @ref stimc_net_set_bits_z_nonblock.
+                             */
+                            subbits_t& operator<<= (bit v) noexcept
+                            {
+                                if (v == bit::X) {
+                                    stimc_net_set_bits_x_nonblock (_p._port, MSB, LSB);
+                                } else if (v == bit::Z) {
+                                    stimc_net_set_bits_z_nonblock (_p._port, MSB, LSB);
+                                }
+                                return *this;
+                            }
+                    };
+
+                private:
                     /**
-                     * @brief Integer value of parameter.
-                     * @return Integer value.
+                     * @brief Current port value as vector.
+                     * @return Cached value if enabled, otherwise value as returned by simulator (valid until next vpi call).
                      */
-                    int value () noexcept
+                    const s_vpi_vecval *vecval () noexcept
                     {
-                        return _value_i;
+                        if (_port->cache != NULL) return _port->cache;
+
+                        s_vpi_value v;
+
+                        v.format = vpiVectorVal;
+                        vpi_get_value (_port->net, &v);
+
+                        return v.value.vector;
                     }
 
+                public:
                     /**
-                     * @brief Double value of parameter.
-                     * @return Double value.
+                     * @brief Port constructor.
+                     * @param m Parent module of port.
+                     * @param name Name of the port.
+                     *
+                     * Asserts the port to be @c N bits wide.
                      */
-                    double dvalue () noexcept
+                    port_t (module &m, const char *name) noexcept :
+                        port_base (m, name)
                     {
-                        return _value_d;
+                        assert (stimc_net_size (_port) == N);
                     }
 
+                    port_t            (const port_t &p) = delete; /**< @brief Do not copy/change internals */
+                    port_t& operator= (const port_t &p) = delete; /**< @brief Do not copy/change internals */
+                    port_t            (port_t &&p)      = delete; /**< @brief Do not move/change internals */
+                    port_t& operator= (port_t &&p)      = delete; /**< @brief Do not move/change internals */
+
+                    ~port_t () noexcept = default; /**< @brief default constructor */
+
                     /**
-                     * @brief String value of parameter.
-                     * @return Temporary c string value, copy if needed.
+                     * @brief Immediate assignment operator to port.
+                     * @param value Value to assgin.
+                     * @return reference to the port.
+                     *
+                     * Sets port to specified value similar
+                     * to using a verilog blocking assignment.
+                     * Bits above 64 are set to 0.
                      */
-                    const char *strvalue ()
+                    port_t& operator= (uint64_t value) noexcept
                     {
-                        const char *str = stimc_parameter_get_str (this->_parameter);
+                        if (N > 64) {
+                            stimc_net_set_uint64 (_port, value);
+                            return *this;
+                        }
 
-                        return str;
+                        s_vpi_value v;
+
+                        if (N == 1) {
+                            v.format       = vpiScalarVal;
+                            v.value.scalar = (value ? vpi1 : vpi0);
+                            vpi_put_value (_port->net, &v, NULL, vpiNoDelay);
+                            return *this;
+                        }
+
+                        s_vpi_vecval vec[(words < 2) ? words : 2];
+
+                        for (unsigned i = 0; (i < words) && (i < 2); i++) {
+                            vec[i].aval = (PLI_INT32)(uint32_t)(value >> (32 * i));
+                            vec[i].bval = 0;
+                        }
+
+                        v.format       = vpiVectorVal;
+                        v.value.vector = &(vec[0]);
+                        vpi_put_value (_port->net, &v, NULL, vpiNoDelay);
+
+                        return *this;
                     }
 
                     /**
-                     * @brief Integer value of parameter.
-                     * @return Integer value.
+                     * @brief Immediate x/z assignment.
+                     * @see @ref stimc_net_set_x and @ref stimc_net_set_z.
                      */
-                    operator uint64_t () noexcept
+                    port_t& operator= (bit v) noexcept
                     {
-                        return _value_i;
+                        if (v == bit::X) {
+                            stimc_net_set_x (_port);
+                        } else if (v == bit::Z) {
+                            stimc_net_set_z (_port);
+                        }
+                        return *this;
                     }
 
                     /**
-                     * @brief Integer value of parameter.
-                     * @return Integer value.
+                     * @brief Non-blocking assignment operator to port.
+                     * @param value Value to assgin.
+                     * @return reference to the port.
+                     * @see @ref stimc_net_set_uint64_nonblock.
                      */
-                    operator uint32_t () noexcept
+                    port_t& operator<<= (uint64_t value) noexcept
                     {
-                        return _value_i;
+                        stimc_net_set_uint64_nonblock (_port, value);
+                        return *this;
                     }
 
                     /**
-                     * @brief Double value of parameter.
-                     * @return Double value.
+                     * @brief Non-blocking x/z assignment.
+                     * @see @ref stimc_net_set_x_nonblock and @ref stimc_net_set_z_nonblock.
                      */
-                    operator double () noexcept
+                    port_t& operator<<= (bit v) noexcept
                     {
-                        return _value_d;
+                        if (v == bit::X) {
+                            stimc_net_set_x_nonblock (_port);
+                        } else if (v == bit::Z) {
+                            stimc_net_set_z_nonblock (_port);
+                        }
+                        return *this;
                     }
 
                     /**
-                     * @brief String value of parameter.
-                     * @return c++ string value.
+                     * @brief Cast for reading from port as uint64_t.
+                     * @return Current value of port as uint64_t (lower 64 bits for wider ports).
                      */
-                    operator std::string ()
+                    operator uint64_t () noexcept
                     {
-                        std::string str = strvalue ();
-                        return str;
-                    }
+                        if ((N == 1) && (_port->cache == NULL)) {
+                            s_vpi_value v;
+
+                            v.format = vpiScalarVal;
+                            vpi_get_value (_port->net, &v);
+
+                            return (v.value.scalar == vpi1) ? 1 : 0;
+                        }
+
+                        const s_vpi_vecval *vec = vecval ();
+
+                        uint64_t result = 0;
+
+                        for (unsigned i = 0; (i < words) && (i < 2); i++) {
+                            /* prevent sign extension */
+                            result |= ((uint64_t)((uint32_t)vec[i].aval & ~(uint32_t)vec[i].bval) << (32 * i));
+                        }
+
+                        return result & mask;
+                    }
+
+                    /**
+                     * @brief Check for x/z value in comparisons.
+                     * @return @ref X if port contains x or z values, @ref not_XZ otherwise.
+                     */
+                    operator bit () noexcept
+                    {
+                        if ((N == 1) && (_port->cache == NULL)) {
+                            s_vpi_value v;
+
+                            v.format = vpiScalarVal;
+                            vpi_get_value (_port->net, &v);
+
+                            return ((v.value.scalar == vpiX) || (v.value.scalar == vpiZ)) ? bit::X : bit::not_XZ;
+                        }
+
+                        const s_vpi_vecval *vec = vecval ();
+
+                        for (unsigned i = 0; i < words; i++) {
+                            if (vec[i].bval != 0) return bit::X;
+                        }
+
+                        return bit::not_XZ;
+                    }
+
+                    /**
+                     * @brief Optain a fixed bit range handle to the port.
+                     * @tparam MSB Most significant bit of bit range.
+                     * @tparam LSB Least significant bit of bit range.
+                     * @return the subbits handle.
+                     */
+                    template<unsigned MSB, unsigned LSB = MSB> subbits_t<MSB, LSB> bits () noexcept
+                    {
+                        return subbits_t<MSB, LSB> (*this);
+                    }
+            };
+
+            /**
+             * @brief Wrapper class for @ref stimc_port_bundle.
+             *
+             * Groups ports for reading them in a single pass via @ref snapshot
+             * and writing modified values in a single pass via @ref commit or
+             * @ref commit_nonblock. Port values are accessed via the buffer
+             * of the bundle using the index returned by @ref add.
+             */
+            class bundle {
+                private:
+                    stimc_port_bundle _bundle; /**< @brief The actual @ref stimc_port_bundle. */
+
+                public:
+                    /**
+                     * @brief Helper class for access to buffered value of a port within the bundle.
+                     */
+                    class entry {
+                        private:
+                            stimc_port_bundle _bundle; /**< @brief Bundle of port. */
+                            unsigned          _idx;    /**< @brief Index of port within bundle. */
+                        public:
+                            /**
+                             * @brief Constructor for bundle entry.
+                             * @param b Bundle of port.
+                             * @param idx Index of port within bundle.
+                             */
+                            entry (stimc_port_bundle b, unsigned idx) noexcept :
+                                _bundle (b), _idx (idx)
+                            {}
+
+                            entry            (const entry &e) noexcept = default; /**< @brief default copy constructor */
+                            entry            (entry &&e) noexcept      = default; /**< @brief default move constructor */
+                            entry& operator= (const entry &e)          = delete;  /**< @brief delete assignment - assignment to be used with values */
+                            entry& operator= (entry &&e)               = delete;  /**< @brief delete assignment - assignment to be used with values */
+
+                            ~entry () noexcept = default; /**< @brief default destructor */
+
+                            /**
+                             * @brief Cast for reading buffered value as uint64_t.
+                             * @return Buffered value as uint64_t.
+                             */
+                            operator uint64_t () noexcept
+                            {
+                                return stimc_port_bundle_get_uint64 (_bundle, _idx);
+                            }
+
+                            /**
+                             * @brief Check buffered value for x/z value in comparisons.
+                             * @return @ref X if buffered value contains x or z values, @ref not_XZ otherwise.
+                             */
+                            operator bit () noexcept
+                            {
+                                if (stimc_port_bundle_is_xz (_bundle, _idx)) {
+                                    return bit::X;
+                                } else {
+                                    return bit::not_XZ;
+                                }
+                            }
+
+                            /**
+                             * @brief Read buffered value of arbitrary width.
+                             * @param words Span-like container of 32 bit words (least significant first) to fill.
+                             * @see @ref stimc_port_bundle_get_vector.
+                             */
+                            template<typename T, typename = enable_if_words<T> >
+                            void get (T &&words) noexcept
+                            {
+                                stimc_port_bundle_get_vector (_bundle, _idx, words.data (), nullptr, (unsigned)words.size ());
+                            }
+
+                            /**
+                             * @brief Set buffered value.
+                             * @param value Value to assign on next commit.
+                             * @return reference to the entry.
+                             */
+                            entry& operator= (uint64_t value) noexcept
+                            {
+                                stimc_port_bundle_set_uint64 (_bundle, _idx, value);
+                                return *this;
+                            }
+
+                            /**
+                             * @brief Set buffered value of arbitrary width.
+                             * @param words Span-like container of 32 bit words (least significant first).
+                             * @return reference to the entry.
+                             */
+                            template<typename T, typename = enable_if_words<const T> >
+                            entry& operator= (const T &words) noexcept
+                            {
+                                stimc_port_bundle_set_vector (_bundle, _idx, words.data (), nullptr, (unsigned)words.size ());
+                                return *this;
+                            }
+
+                            /**
+                             * @brief Set buffered value to x/z.
+                             * @param v @ref X or @ref Z.
+                             * @return reference to the entry.
+                             */
+                            entry& operator= (bit v) noexcept
+                            {
+                                if (v == bit::X) {
+                                    stimc_port_bundle_set_x (_bundle, _idx);
+                                } else if (v == bit::Z) {
+                                    stimc_port_bundle_set_z (_bundle, _idx);
+                                }
+                                return *this;
+                            }
+                    };
+
+                public:
+                    /**
+                     * @brief Create empty bundle.
+                     */
+                    bundle () noexcept :
+                        _bundle (stimc_port_bundle_init ())
+                    {}
+
+                    bundle            (const bundle &b) = delete; /**< @brief Do not copy/change internals */
+                    bundle& operator= (const bundle &b) = delete; /**< @brief Do not copy/change internals */
+                    bundle            (bundle &&b)      = delete; /**< @brief Do not move/change internals */
+                    bundle& operator= (bundle &&b)      = delete; /**< @brief Do not move/change internals */
+
+                    /**
+                     * @brief Destructor.
+                     */
+                    ~bundle () noexcept
+                    {
+                        stimc_port_bundle_free (_bundle);
+                    }
+
+                    /**
+                     * @brief Add port to bundle.
+                     * @param p Port to add (must outlive the bundle usage).
+                     * @return index of port within bundle.
+                     */
+                    unsigned add (port_base &p) noexcept
+                    {
+                        return stimc_port_bundle_add (_bundle, p._port);
+                    }
+
+                    /**
+                     * @brief Read all ports of bundle.
+                     * @return number of simulator value transfers.
+                     * @see @ref stimc_port_bundle_snapshot.
+                     */
+                    unsigned snapshot () noexcept
+                    {
+                        return stimc_port_bundle_snapshot (_bundle);
+                    }
+
+                    /**
+                     * @brief Immediate assignment of modified ports.
+                     * @return number of simulator value transfers.
+                     * @see @ref stimc_port_bundle_commit.
+                     */
+                    unsigned commit () noexcept
+                    {
+                        return stimc_port_bundle_commit (_bundle);
+                    }
+
+                    /**
+                     * @brief Non-blocking assignment of modified ports.
+                     * @return number of ports scheduled for assignment.
+                     * @see @ref stimc_port_bundle_commit_nonblock.
+                     */
+                    unsigned commit_nonblock () noexcept
+                    {
+                        return stimc_port_bundle_commit_nonblock (_bundle);
+                    }
+
+                    /**
+                     * @brief Access buffered value of port.
+                     * @param idx Index of port as returned by @ref add.
+                     * @return the entry handle.
+                     */
+                    entry operator[] (unsigned idx) noexcept
+                    {
+                        entry e (_bundle, idx);
+
+                        return e;
+                    }
+            };
+
+            /**
+             * @brief Wrapper class for @ref stimc_parameter.
+             */
+            class parameter {
+                protected:
+                    stimc_parameter _parameter; /**<@brief The wrapped @ref stimc_parameter. */
+                    int32_t _value_i;           /**<@brief Cached integer value of parameter. */
+                    double _value_d;            /**<@brief Cached double value of parameter. */
+                public:
+                    /**
+                     * @brief Parameter constructor.
+                     * @param m Parent module of parameter.
+                     * @param name Name of the parameter.
+                     */
+                    parameter (module &m, const char *name) noexcept :
+                        _parameter (stimc_parameter_init (&(m._module), name)),
+                        _value_i (0),
+                        _value_d (0.0)
+                    {
+                        if (stimc_parameter_get_format (this->_parameter) == vpiRealVal) {
+                            this->_value_d = stimc_parameter_get_double (this->_parameter);
+                            this->_value_i = this->_value_d;
+                        } else {
+                            this->_value_i = stimc_parameter_get_int32 (this->_parameter);
+                            this->_value_d = this->_value_i;
+                        }
+                    }
+
+                    parameter            (const parameter &p) = delete; /**< @brief Do not copy/change internals */
+                    parameter& operator= (const parameter &p) = delete; /**< @brief Do not copy/change internals */
+                    parameter            (parameter &&p)      = delete; /**< @brief Do not move/change internals */
+                    parameter& operator= (parameter &&p)      = delete; /**< @brief Do not move/change internals */
+
+                    /**
+                     * @brief Simple destructor
+                     */
+                    ~parameter () noexcept
+                    {
+                        stimc_parameter_free (this->_parameter);
+                    }
+
+                    /**
+                     * @brief Integer value of parameter.
+                     * @return Integer value.
+                     */
+                    int value () noexcept
+                    {
+                        return _value_i;
+                    }
+
+                    /**
+                     * @brief Double value of parameter.
+                     * @return Double value.
+                     */
+                    double dvalue () noexcept
+                    {
+                        return _value_d;
+                    }
+
+                    /**
+                     * @brief String value of parameter.
+                     * @return Temporary c string value, copy if needed.
+                     */
+                    const char *strvalue ()
+                    {
+                        const char *str = stimc_parameter_get_str (this->_parameter);
+
+                        return str;
+                    }
+
+                    /**
+                     * @brief Integer value of parameter.
+                     * @return Integer value.
+                     */
+                    operator uint64_t () noexcept
+                    {
+                        return _value_i;
+                    }
+
+                    /**
+                     * @brief Integer value of parameter.
+                     * @return Integer value.
+                     */
+                    operator uint32_t () noexcept
+                    {
+                        return _value_i;
+                    }
+
+                    /**
+                     * @brief Double value of parameter.
+                     * @return Double value.
+                     */
+                    operator double () noexcept
+                    {
+                        return _value_d;
+                    }
+
+                    /**
+                     * @brief String value of parameter.
+                     * @return c++ string value.
+                     */
+                    operator std::string ()
+                    {
+                        std::string str = strvalue ();
+                        return str;
+                    }
+            };
+
+            /**
+             * @brief Wrapper class for @ref stimc_memory.
+             */
+            class memory {
+                protected:
+                    stimc_memory _memory; /**< @brief The actual @ref stimc_memory. */
+
+                public:
+                    /**
+                     * @brief Helper class for access to a memory word.
+                     */
+                    class word {
+                        private:
+                            stimc_memory _memory; /**< @brief Memory of word. */
+                            int32_t      _addr;   /**< @brief Address of word. */
+                        public:
+                            /**
+                             * @brief Constructor for memory word.
+                             * @param mem Memory accessed.
+                             * @param addr Word address.
+                             */
+                            word (stimc_memory mem, int32_t addr) noexcept :
+                                _memory (mem), _addr (addr)
+                            {}
+
+                            word            (const word &w) noexcept = default; /**< @brief default copy constructor */
+                            word            (word &&w) noexcept      = default; /**< @brief default move constructor */
+                            word& operator= (const word &w)          = delete;  /**< @brief delete assignment - assignment to be used with values */
+                            word& operator= (word &&w)               = delete;  /**< @brief delete assignment - assignment to be used with values */
+
+                            ~word () noexcept = default; /**< @brief default destructor */
+
+                            /**
+                             * @brief Cast for reading memory word as uint64_t.
+                             * @return Current value of memory word.
+                             */
+                            operator uint64_t () noexcept
+                            {
+                                return stimc_memory_get_uint64 (_memory, _addr);
+                            }
+
+                            /**
+                             * @brief Immediate assignment operator to memory word.
+                             * @param value Value to assgin.
+                             * @return reference to the word.
+                             */
+                            word& operator= (uint64_t value) noexcept
+                            {
+                                stimc_memory_set_uint64 (_memory, _addr, value);
+                                return *this;
+                            }
+                    };
+
+                public:
+                    /**
+                     * @brief Memory constructor.
+                     * @param m Parent module of memory.
+                     * @param name Name of the memory (or hierarchical name).
+                     */
+                    memory (module &m, const char *name) noexcept :
+                        _memory (stimc_memory_init (&(m._module), name))
+                    {}
+
+                    memory            (const memory &m) = delete; /**< @brief Do not copy/change internals */
+                    memory& operator= (const memory &m) = delete; /**< @brief Do not copy/change internals */
+                    memory            (memory &&m)      = delete; /**< @brief Do not move/change internals */
+                    memory& operator= (memory &&m)      = delete; /**< @brief Do not move/change internals */
+
+                    /**
+                     * @brief Destructor.
+                     */
+                    ~memory () noexcept
+                    {
+                        stimc_memory_free (this->_memory);
+                    }
+
+                    /**
+                     * @brief Width of memory words.
+                     * @return Width in bits.
+                     */
+                    unsigned width () noexcept
+                    {
+                        return stimc_memory_width (_memory);
+                    }
+
+                    /**
+                     * @brief Number of memory words.
+                     * @return Memory depth.
+                     */
+                    unsigned depth () noexcept
+                    {
+                        return stimc_memory_depth (_memory);
+                    }
+
+                    /**
+                     * @brief Lowest address of memory.
+                     * @return Memory base address.
+                     */
+                    int32_t base () noexcept
+                    {
+                        return stimc_memory_base (_memory);
+                    }
+
+                    /**
+                     * @brief Load memory from file.
+                     * @see @ref stimc_memory_load.
+                     */
+                    bool load (const char *filename, enum stimc_memory_format format, int32_t addr, unsigned num) noexcept
+                    {
+                        return stimc_memory_load (_memory, filename, format, addr, num);
+                    }
+
+                    /**
+                     * @brief Load memory from file (complete memory).
+                     * @see @ref stimc_memory_load.
+                     */
+                    bool load (const char *filename, enum stimc_memory_format format = STIMC_MEMORY_FORMAT_HEX) noexcept
+                    {
+                        return stimc_memory_load (_memory, filename, format, base (), 0);
+                    }
+
+                    /**
+                     * @brief Dump memory to file.
+                     * @see @ref stimc_memory_dump.
+                     */
+                    bool dump (const char *filename, enum stimc_memory_format format, int32_t addr, unsigned num) noexcept
+                    {
+                        return stimc_memory_dump (_memory, filename, format, addr, num);
+                    }
+
+                    /**
+                     * @brief Dump memory to file (complete memory).
+                     * @see @ref stimc_memory_dump.
+                     */
+                    bool dump (const char *filename, enum stimc_memory_format format = STIMC_MEMORY_FORMAT_HEX) noexcept
+                    {
+                        return stimc_memory_dump (_memory, filename, format, base (), 0);
+                    }
+
+                    /**
+                     * @brief Write memory word range.
+                     * @param addr Address of first word.
+                     * @param words Span-like container of 32 bit words in layout as for @ref stimc_memory_write.
+                     */
+                    template<typename T, typename = enable_if_words<const T> >
+                    void write (int32_t addr, const T &words) noexcept
+                    {
+                        stimc_memory_write (_memory, addr, (unsigned)words.size () / (((width () - 1) / 32) + 1), words.data ());
+                    }
+
+                    /**
+                     * @brief Read memory word range.
+                     * @param addr Address of first word.
+                     * @param words Span-like container of 32 bit words to fill in layout as for @ref stimc_memory_read.
+                     */
+                    template<typename T, typename = enable_if_words<T> >
+                    void read (int32_t addr, T &&words) noexcept
+                    {
+                        stimc_memory_read (_memory, addr, (unsigned)words.size () / (((width () - 1) / 32) + 1), words.data ());
+                    }
+
+                    /**
+                     * @brief Optain a memory word handle.
+                     * @param addr Word address.
+                     * @return the word handle.
+                     */
+                    word operator[] (int32_t addr) noexcept
+                    {
+                        word w (_memory, addr);
+
+                        return w;
+                    }
             };
     };
 
@@ -1380,6 +2194,459 @@ namespace stimcxx {
             thread_cleanup            (thread_cleanup &&t)      = delete; /**< @brief Do not move/change internals */
             thread_cleanup& operator= (thread_cleanup &&t)      = delete; /**< @brief Do not move/change internals */
     };
+
+#ifdef STIMCXX_ENABLE_TASK
+    /**
+     * @brief Stackless thread based on C++20 coroutines.
+     *
+     * A coroutine returning @ref task is either started as stackless thread via
+     * @ref spawn (see @ref stimc_spawn_stackless_thread) or run as part of another task
+     * via @c co_await. Tasks do not need a stack of their own, instead of the
+     * wait functions they suspend via @c co_await on the awaitables in @ref stimcxx::co,
+     * on @ref event or on @ref event_combination (e.g. <tt>co_await (e1 | e2)</tt>).
+     * The blocking wait functions must not be used within a task.
+     *
+     * On end of simulation suspended tasks are destroyed, so
+     * local objects are cleaned up without the need of stack unwinding.
+     */
+    class task {
+        public:
+            class promise_type;
+            using handle_type = std::coroutine_handle<promise_type>; /**< @brief Coroutine handle of task. */
+
+            /**
+             * @brief Coroutine promise of @ref task.
+             */
+            class promise_type {
+                private:
+                    promise_type           *_root         = this;      /**< @brief Promise of spawned (outermost) task. */
+                    std::coroutine_handle<> _resume       = nullptr;   /**< @brief Innermost suspended coroutine (valid in root promise). */
+                    std::coroutine_handle<> _continuation = nullptr;   /**< @brief Awaiting task to continue on completion. */
+                    std::exception_ptr      _exception    = nullptr;   /**< @brief Unhandled exception to rethrow in awaiting task. */
+
+                    /**
+                     * @brief Final suspend: continue awaiting task if any.
+                     */
+                    class final_awaiter {
+                        public:
+                            bool await_ready () const noexcept
+                            {
+                                return false;
+                            }
+
+                            std::coroutine_handle<> await_suspend (handle_type h) noexcept
+                            {
+                                std::coroutine_handle<> c = h.promise ()._continuation;
+
+                                if (c) return c;
+
+                                return std::noop_coroutine ();
+                            }
+
+                            void await_resume () const noexcept
+                            {}
+                    };
+
+                public:
+                    promise_type () noexcept = default;
+
+                    promise_type            (const promise_type &p) = delete; /**< @brief Do not copy/change internals */
+                    promise_type& operator= (const promise_type &p) = delete; /**< @brief Do not copy/change internals */
+
+                    task get_return_object () noexcept
+                    {
+                        return task (handle_type::from_promise (*this));
+                    }
+
+                    std::suspend_always initial_suspend () const noexcept
+                    {
+                        return {};
+                    }
+
+                    final_awaiter final_suspend () const noexcept
+                    {
+                        return {};
+                    }
+
+                    void return_void () const noexcept
+                    {}
+
+                    void unhandled_exception () noexcept
+                    {
+                        _exception = std::current_exception ();
+                    }
+
+                    /**
+                     * @brief Mark coroutine as the one to resume on next run of the task.
+                     * @param h Handle of the suspending coroutine.
+                     */
+                    void suspend (std::coroutine_handle<> h) noexcept
+                    {
+                        _root->_resume = h;
+                    }
+
+                    friend class task;
+            };
+
+        private:
+            handle_type _handle; /**< @brief Owned coroutine (null if spawned or moved). */
+
+            /**
+             * @brief Constructor from coroutine promise.
+             * @param h Handle of the created coroutine.
+             */
+            explicit task (handle_type h) noexcept :
+                _handle (h)
+            {}
+
+            /**
+             * @brief Release coroutine for starting it as stackless thread.
+             * @return Address of the coroutine.
+             */
+            void *release () noexcept
+            {
+                handle_type h = _handle;
+
+                _handle = nullptr;
+
+                h.promise ()._resume = h;
+
+                return h.address ();
+            }
+
+            /**
+             * @brief Resume callback for @ref stimc_spawn_stackless_thread.
+             * @param p Address of the spawned coroutine.
+             */
+            static void resume_callback (void *p) noexcept
+            {
+                handle_type   h    = handle_type::from_address (p);
+                promise_type &root = h.promise ();
+
+                root._resume.resume ();
+
+                if (!h.done ()) return;
+
+                /* finish unwinding is expected, any other exception terminates */
+                if (root._exception) {
+                    try {
+                        std::rethrow_exception (root._exception);
+                    } catch (thread_finish_exception &) {}
+                }
+
+                stimc_thread_exit ();
+            }
+
+            /**
+             * @brief Free callback for @ref stimc_spawn_stackless_thread.
+             * @param p Address of the spawned coroutine.
+             */
+            static void free_callback (void *p) noexcept
+            {
+                handle_type::from_address (p).destroy ();
+            }
+
+        public:
+            task            (const task &t) = delete; /**< @brief Do not copy/change internals */
+            task& operator= (const task &t) = delete; /**< @brief Do not copy/change internals */
+
+            task (task &&t) noexcept :
+                _handle (t._handle)
+            {
+                t._handle = nullptr;
+            }
+
+            task& operator= (task &&t) noexcept
+            {
+                std::swap (_handle, t._handle);
+
+                return *this;
+            }
+
+            /**
+             * @brief Destroy coroutine if neither spawned nor awaited.
+             */
+            ~task () noexcept
+            {
+                if (_handle) _handle.destroy ();
+            }
+
+            /**
+             * @brief Awaiter for running a task within another task.
+             */
+            class awaiter {
+                private:
+                    handle_type _handle; /**< @brief The awaited coroutine. */
+
+                public:
+                    /**
+                     * @brief Constructor.
+                     * @param h Handle of the awaited coroutine.
+                     */
+                    explicit awaiter (handle_type h) noexcept :
+                        _handle (h)
+                    {}
+
+                    bool await_ready () const noexcept
+                    {
+                        return false;
+                    }
+
+                    handle_type await_suspend (handle_type parent) noexcept
+                    {
+                        promise_type &p = _handle.promise ();
+
+                        p._root         = parent.promise ()._root;
+                        p._continuation = parent;
+
+                        return _handle;
+                    }
+
+                    void await_resume () const
+                    {
+                        if (_handle.promise ()._exception) {
+                            std::rethrow_exception (_handle.promise ()._exception);
+                        }
+                    }
+            };
+
+            /**
+             * @brief Run task within the awaiting task until it completes.
+             * @return Awaiter of the task.
+             *
+             * Exceptions not handled in the awaited task are rethrown.
+             */
+            awaiter operator co_await () && noexcept
+            {
+                return awaiter (_handle);
+            }
+
+            friend void spawn (task &&t) noexcept;
+    };
+
+    /**
+     * @brief Start task as stackless thread.
+     * @param t Task to start.
+     *
+     * Calls @ref stimc_spawn_stackless_thread.
+     */
+    inline void spawn (task &&t) noexcept
+    {
+        stimc_spawn_stackless_thread (task::resume_callback, task::free_callback, t.release ());
+    }
+
+    /**
+     * @brief Awaitables for suspending a @ref task.
+     */
+    namespace co {
+        /**
+         * @brief Generic awaitable scheduling the resume of the awaiting task.
+         * @tparam schedule_type Functor scheduling the resume via the stimc wait functions.
+         * @tparam timeout Whether the result of @c co_await is the timeout flag.
+         */
+        template<typename schedule_type, bool timeout = false> class awaitable {
+            private:
+                schedule_type _schedule; /**< @brief Schedule functor. */
+
+            public:
+                /**
+                 * @brief Constructor.
+                 * @param schedule Functor to schedule the resume.
+                 */
+                explicit awaitable (schedule_type &&schedule) :
+                    _schedule (std::move (schedule))
+                {}
+
+                bool await_ready () const noexcept
+                {
+                    return false;
+                }
+
+                void await_suspend (task::handle_type h)
+                {
+                    h.promise ().suspend (h);
+                    _schedule ();
+                }
+
+                auto await_resume () const noexcept
+                {
+                    if constexpr (timeout) {
+                        return stimc_wait_timed_out ();
+                    }
+                }
+        };
+
+        /**
+         * @brief Create awaitable from schedule functor.
+         * @tparam timeout Whether the result of @c co_await is the timeout flag.
+         * @param schedule Functor to schedule the resume.
+         * @return The awaitable.
+         */
+        template<bool timeout = false, typename schedule_type> static inline auto make_awaitable (schedule_type &&schedule)
+        {
+            return awaitable<schedule_type, timeout> (std::move (schedule));
+        }
+
+        /**
+         * @brief Awaitable wait.
+         * @param time_seconds Amount of time in seconds.
+         * @return Awaitable, see @ref stimcxx::wait(double).
+         */
+        static inline auto wait (double time_seconds)
+        {
+            return make_awaitable ([time_seconds] () {stimc_wait_time_seconds (time_seconds);});
+        }
+
+        /**
+         * @brief Awaitable wait.
+         * @param time Amount of time in unit specified by @c exp.
+         * @param exp Time unit (e.g. SC_US).
+         * @return Awaitable, see @ref stimcxx::wait(uint64_t, enum stimc_time_unit).
+         */
+        static inline auto wait (uint64_t time, enum stimc_time_unit exp)
+        {
+            return make_awaitable ([time, exp] () {stimc_wait_time (time, exp);});
+        }
+
+        /**
+         * @brief Awaitable wait.
+         * @param e Event to wait for.
+         * @return Awaitable, see @ref stimcxx::wait(event &).
+         */
+        static inline auto wait (event &e)
+        {
+            return make_awaitable ([&e] () {e.wait ();});
+        }
+
+        /**
+         * @brief Awaitable wait.
+         * @param e Event to wait for.
+         * @param time_seconds Amount of time in seconds for timeout.
+         * @return Awaitable with result true in case of timeout, see @ref stimcxx::wait(event &, double).
+         */
+        static inline auto wait (event &e, double time_seconds)
+        {
+            return make_awaitable<true> ([&e, time_seconds] () {e.wait (time_seconds);});
+        }
+
+        /**
+         * @brief Awaitable wait.
+         * @param e Event to wait for.
+         * @param time Amount of time in unit specified by @c exp for timeout.
+         * @param exp Time unit (e.g. SC_US).
+         * @return Awaitable with result true in case of timeout, see @ref stimcxx::wait(event &, uint64_t, enum stimc_time_unit).
+         */
+        static inline auto wait (event &e, uint64_t time, enum stimc_time_unit exp)
+        {
+            return make_awaitable<true> ([&e, time, exp] () {e.wait (time, exp);});
+        }
+
+        /**
+         * @brief Awaitable wait, rvalue version.
+         * @param ec Event combination to wait for.
+         * @return Awaitable, see @ref stimcxx::wait(event_combination &&).
+         */
+        static inline auto wait (event_combination &&ec)
+        {
+            return make_awaitable ([ec = std::move (ec)] () mutable {std::move (ec).wait ();});
+        }
+
+        /**
+         * @brief Awaitable wait, rvalue version.
+         * @param ec Event combination to wait for.
+         * @param time_seconds Amount of time in seconds for timeout.
+         * @return Awaitable with result true in case of timeout, see @ref stimcxx::wait(event_combination &&, double).
+         */
+        static inline auto wait (event_combination &&ec, double time_seconds)
+        {
+            return make_awaitable<true> ([ec = std::move (ec), time_seconds] () mutable {std::move (ec).wait (time_seconds);});
+        }
+
+        /**
+         * @brief Awaitable wait, rvalue version.
+         * @param ec Event combination to wait for.
+         * @param time Amount of time in unit specified by @c exp for timeout.
+         * @param exp Time unit (e.g. SC_US).
+         * @return Awaitable with result true in case of timeout, see @ref stimcxx::wait(event_combination &&, uint64_t, enum stimc_time_unit).
+         */
+        static inline auto wait (event_combination &&ec, uint64_t time, enum stimc_time_unit exp)
+        {
+            return make_awaitable<true> ([ec = std::move (ec), time, exp] () mutable {std::move (ec).wait (time, exp);});
+        }
+
+        /**
+         * @brief Awaitable wait.
+         * @param ec Event combination to wait for.
+         * @return Awaitable, see @ref stimcxx::wait(const event_combination &).
+         */
+        static inline auto wait (const event_combination &ec)
+        {
+            return make_awaitable ([&ec] () {ec.wait ();});
+        }
+
+        /**
+         * @brief Awaitable wait.
+         * @param ec Event combination to wait for.
+         * @param time_seconds Amount of time in seconds for timeout.
+         * @return Awaitable with result true in case of timeout, see @ref stimcxx::wait(const event_combination &, double).
+         */
+        static inline auto wait (const event_combination &ec, double time_seconds)
+        {
+            return make_awaitable<true> ([&ec, time_seconds] () {ec.wait (time_seconds);});
+        }
+
+        /**
+         * @brief Awaitable wait.
+         * @param ec Event combination to wait for.
+         * @param time Amount of time in unit specified by @c exp for timeout.
+         * @param exp Time unit (e.g. SC_US).
+         * @return Awaitable with result true in case of timeout, see @ref stimcxx::wait(const event_combination &, uint64_t, enum stimc_time_unit).
+         */
+        static inline auto wait (const event_combination &ec, uint64_t time, enum stimc_time_unit exp)
+        {
+            return make_awaitable<true> ([&ec, time, exp] () {ec.wait (time, exp);});
+        }
+
+        /**
+         * @brief Awaitable halt.
+         * @return Awaitable, see @ref stimcxx::halt.
+         */
+        static inline auto halt ()
+        {
+            return make_awaitable ([] () {stimc_thread_halt ();});
+        }
+    }
+
+    /**
+     * @brief Await event within a @ref task.
+     * @param e Event to wait for.
+     * @return Awaitable, see @ref co::wait(event &).
+     */
+    static inline auto operator co_await (event &e)
+    {
+        return co::wait (e);
+    }
+
+    /**
+     * @brief Await event combination within a @ref task, rvalue version.
+     * @param ec Event combination to wait for.
+     * @return Awaitable, see @ref co::wait(event_combination &&).
+     */
+    static inline auto operator co_await (event_combination &&ec)
+    {
+        return co::wait (std::move (ec));
+    }
+
+    /**
+     * @brief Await event combination within a @ref task.
+     * @param ec Event combination to wait for.
+     * @return Awaitable, see @ref co::wait(const event_combination &).
+     */
+    static inline auto operator co_await (const event_combination &ec)
+    {
+        return co::wait (ec);
+    }
+#endif
 }
 
 /**
@@ -1391,6 +2658,15 @@ namespace stimcxx {
 #define STIMCXX_PARAMETER(param) \
     param (*this, #param)
 
+/**
+ * @brief Memory initialization for module constructor initializer list.
+ * @param mem Memory to initialize.
+ *
+ * Will take care of proper constructor call for @ref stimcxx::module::memory.
+ */
+#define STIMCXX_MEMORY(mem) \
+    mem (*this, #mem)
+
 /**
  * @brief Port initialization for module constructor initializer list.
  * @param port Port to initialize.
@@ -1475,6 +2751,24 @@ namespace stimcxx {
         port.register_ ## event ## _method (_func, _dataptr); \
     } while (false)
 
+/**
+ * @brief Convenience wrapper for registering a method to be called on event trigger.
+ * @param event The @ref stimcxx::event to observe.
+ * @param func the method to call on trigger of the event.
+ *
+ * Wraps @ref stimc_register_event_method for given event and function.
+ */
+#define STIMCXX_REGISTER_EVENT_METHOD(event, func) \
+    do { \
+        using _thistype = decltype (this); \
+        void *_dataptr = static_cast<void *>(this); \
+        auto  _func = [](void *_ptr) { \
+                _thistype _data = static_cast<_thistype>(_ptr); \
+                _data->func (); \
+            }; \
+        event.register_method (_func, _dataptr); \
+    } while (false)
+
 
 /**
  * @brief stimc++ module initialization routine macro.
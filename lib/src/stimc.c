@@ -25,13 +25,34 @@
 #include "stimc.h"
 #include "stimc_config.h"
 
-#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdio.h>
+#include <ctype.h>
+
+#if (defined(STIMC_THREAD_STACK_WATERMARK) || defined(STIMC_PROFILE) || defined(STIMC_TRACE)) && defined(__GLIBC__)
+#include <execinfo.h>
+#define STIMC_FUNC_SYMBOLS
+#endif
+
+#if defined(STIMC_PROFILE) || defined(STIMC_TRACE)
+#include <stdarg.h>
+#include <inttypes.h>
+#include <time.h>
+#endif
 
 #include <assert.h>
 
+/* memory files are mapped where available */
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define STIMC_MEMORY_FILE_MMAP
+#endif
+
 #ifdef __cplusplus
 #include <atomic>
 /**
@@ -78,11 +99,27 @@ const char *const stimc_version       = STIMC_VERSION_STR (STIMC_VERSION_MAJOR)
 
 #define STIMC_USE_INTERNAL_HEADER
 #include "stimc_thread.inl"
+#include "stimc_slab.inl"
 #undef STIMC_USE_INTERNAL_HEADER
 
 /* modules and co */
+/* name lookup index: open addressing hash table over module objects */
+struct stimc_module_index_entry_s {
+    vpiHandle handle; /* NULL: empty slot */
+    uint32_t  hash;
+    int       type;
+};
+struct stimc_module_index_s {
+    size_t                             max; /* power of 2 */
+    size_t                             num;
+    struct stimc_module_index_entry_s *entries;
+};
+
 static vpiHandle stimc_get_caller_scope (void);
 static vpiHandle stimc_module_handle_init (stimc_module *m, const uint32_t *types, const char *name);
+static void      stimc_module_index_build (stimc_module *m);
+static void      stimc_module_index_insert (struct stimc_module_index_s *index, vpiHandle handle, uint32_t hash, int type);
+static uint32_t  stimc_module_index_hash (const char *name);
 
 static int stimc_module_register_init_cptf (PLI_BYTE8 *user_data);
 static int stimc_module_register_init_cltf (PLI_BYTE8 *user_data);
@@ -100,12 +137,16 @@ struct stimc_thread_s {
     /* thread implementation data */
     stimc_thread_impl thread;
 
-    /* thread function + data to call initially */
+    /* thread function + data to call initially
+     * (stackless threads: resume function called on every run + function to release data) */
     void  (*func) (void *data);
+    void  (*freefunc) (void *data);
     void *data;
+    bool  stackless;
 
     /* data related to waiting for time/event */
-    vpiHandle               call_handle;
+    struct stimc_timer_s   *timer;
+    size_t                  timer_idx;
     stimc_event_combination event_combination;
     bool                    timeout;
 
@@ -117,18 +158,33 @@ struct stimc_thread_s {
     struct stimc_cleanup_entry_s *cleanup_queue;
     struct stimc_cleanup_entry_s *cleanup_self;
 #endif
+#ifdef STIMC_PROFILE
+    size_t profile_idx; /* entry of thread function in profile */
+#endif
+#ifdef STIMC_TRACE
+    uint64_t trace_id;      /* thread id in trace */
+    size_t   trace_module;  /* module the thread was spawned in */
+    unsigned trace_session; /* trace session the thread name was written in */
+#endif
+};
+
+struct stimc_thread_queue_entry_s {
+    struct stimc_thread_s *thread;
+    size_t                 ref; /* back reference into thread data (event queues: index of thread's event handle) */
 };
 
 struct stimc_thread_queue_s {
-    size_t                  max;
-    size_t                  num;
-    struct stimc_thread_s **threads;
+    size_t                             max;
+    size_t                             num;
+    size_t                             dead; /* number of removed entries (thread == NULL) */
+    struct stimc_thread_queue_entry_s *entries;
 };
 
+static struct stimc_thread_s *stimc_thread_alloc  (void (*threadfunc)(void *userdata), void *userdata);
 static struct stimc_thread_s *stimc_thread_create (void (*threadfunc)(void *userdata), void *userdata, size_t stacksize);
 static void                   stimc_thread_finish (struct stimc_thread_s *thread);
 
-static void        stimc_thread_remove_event_handle (struct stimc_thread_s *thread, stimc_event event);
+static void        stimc_thread_remove_event_handle (struct stimc_thread_s *thread, size_t handle_idx);
 static inline bool stimc_thread_has_event_handle    (struct stimc_thread_s *thread);
 
 static inline void stimc_thread_queue_init        (struct stimc_thread_queue_s *q);
@@ -140,9 +196,210 @@ static void        stimc_thread_queue_clear       (struct stimc_thread_queue_s *
 
 static void stimc_main_queue_run_threads (void);
 
+/* maximum stack usage per thread function */
+struct stimc_thread_stack_usage_s {
+    void   (*func) (void *data);
+    size_t num;  /* number of measured threads */
+    size_t size; /* maximum stack size */
+    size_t used; /* maximum stack usage */
+};
+
+struct stimc_thread_stack_usage_table_s {
+    size_t                             max;
+    size_t                             num;
+    struct stimc_thread_stack_usage_s *entries;
+};
+
+#ifdef STIMC_THREAD_STACK_WATERMARK
+static void stimc_thread_stack_usage_add  (void (*threadfunc)(void *userdata), stimc_thread_impl ti);
+#endif
+#ifndef STIMC_DISABLE_CLEANUP
+static void stimc_thread_stack_usage_free (void);
+#endif
+
+static void stimc_func_symbol (void (*func)(void *data), char *buf, size_t len);
+
+/* scheduler profile: counters + wall time per section of execution */
+enum stimc_profile_section {
+    STIMC_PROFILE_SIMULATOR, /* outside of stimc */
+    STIMC_PROFILE_STIMC,     /* stimc bookkeeping (inside vpi callbacks) */
+    STIMC_PROFILE_THREAD,    /* user thread code */
+    STIMC_PROFILE_METHOD,    /* user method code */
+    STIMC_PROFILE__SIZE_,
+};
+
+struct stimc_profile_func_s {
+    void   (*func) (void *data);
+    uint64_t threads; /* number of created threads */
+    uint64_t resumes; /* number of context switches into thread */
+    uint64_t time;    /* wall time in thread code [ns] */
+};
+
+struct stimc_profile_s {
+    /* vpi callbacks */
+    uint64_t cb_registered;
+    uint64_t cb_removed;
+    uint64_t cb_executed;
+
+    /* main queue */
+    uint64_t run_calls;           /* calls of main queue processing */
+    uint64_t run_iterations;      /* passes over main queue */
+    uint64_t time_steps;          /* simulation time steps with main queue processing */
+    uint64_t time_step_last;      /* simulation time of last step */
+    uint64_t time_step_iter;      /* passes in current time step */
+    uint64_t time_step_iter_max;  /* maximum passes in one time step */
+
+    /* events, methods, nba */
+    uint64_t events_triggered;
+    uint64_t waiters_woken;
+    uint64_t methods_called;
+    uint64_t nba_flushes;
+    uint64_t nba_nets;
+    uint64_t nba_entries;
+
+    /* wall time per section [ns] */
+    enum stimc_profile_section section;
+    uint64_t                   section_start;
+    uint64_t                   section_time[STIMC_PROFILE__SIZE_];
+
+    /* per thread function */
+    size_t                       funcs_max;
+    size_t                       funcs_num;
+    struct stimc_profile_func_s *funcs;
+
+    /* end-of-simulation report file (NULL: simulator console) */
+    char *report_file;
+};
+
+#ifdef STIMC_PROFILE
+static inline enum stimc_profile_section stimc_profile_switch        (enum stimc_profile_section section, uint64_t now);
+static size_t                            stimc_profile_func_idx      (void (*func)(void *data));
+static void                              stimc_profile_run_start     (void);
+static inline void                       stimc_profile_run_iteration (void);
+
+#define STIMC_PROFILE_COUNT(counter, n) (stimc_profile.counter += (n))
+#define STIMC_PROFILE_ENTER(section)    enum stimc_profile_section stimc_profile_section_prev_ = stimc_profile_switch ((section), stimc_wall_time ())
+#define STIMC_PROFILE_LEAVE()           (void)stimc_profile_switch (stimc_profile_section_prev_, stimc_wall_time ())
+#else
+#define STIMC_PROFILE_COUNT(counter, n) ((void)0)
+#define STIMC_PROFILE_ENTER(section)    ((void)0)
+#define STIMC_PROFILE_LEAVE()           ((void)0)
+#endif
+#ifndef STIMC_DISABLE_CLEANUP
+static void stimc_profile_free (void);
+#endif
+
+/* scheduler trace: chrome trace event json (array format) via buffered writer */
+#define STIMC_TRACE_BUFFER_SIZE (1024 * 1024)
+#define STIMC_TRACE_RECORD_MAX  1024
+#define STIMC_TRACE_NAME_MAX    256
+
+struct stimc_trace_module_s {
+    char    *name;    /* json safe hierarchical name */
+    unsigned session; /* trace session the module name was written in */
+};
+
+struct stimc_trace_func_s {
+    void  (*func) (void *data);
+    char *name; /* json safe symbol */
+};
+
+struct stimc_trace_s {
+    FILE     *file;       /* trace file (NULL: inactive) */
+    char     *buf;        /* write buffer */
+    size_t    len;        /* used length of write buffer */
+    bool      first;      /* no record written yet */
+    uint64_t  start;      /* wall time of trace start [ns] */
+    unsigned  session;    /* number of started traces */
+    size_t    module;     /* module of current context (0: none) */
+    uint64_t  thread_ids; /* last assigned thread id */
+    vpiHandle eos_cb;     /* end-of-simulation callback stopping the trace */
+
+    size_t                       modules_max;
+    size_t                       modules_num;
+    struct stimc_trace_module_s *modules;
+
+    size_t                     funcs_max;
+    size_t                     funcs_num;
+    struct stimc_trace_func_s *funcs;
+};
+
+struct stimc_method_s;
+
+#ifdef STIMC_TRACE
+static inline bool  stimc_trace_active       (void);
+static size_t       stimc_trace_module       (vpiHandle mod);
+static const char  *stimc_trace_func_name    (void (*func)(void *data));
+static void         stimc_trace_printf       (const char *format, ...) __attribute__((format (printf, 1, 2)));
+static void         stimc_trace_flush        (void);
+static void         stimc_trace_context      (size_t *module, uint64_t *tid);
+static void         stimc_trace_run          (struct stimc_thread_s *thread, uint64_t start, uint64_t stop, uint64_t sim_time);
+static void         stimc_trace_method_call  (const struct stimc_method_s *m);
+static void         stimc_trace_trigger      (stimc_event event);
+static void         stimc_trace_timer        (uint64_t delay, uint64_t time, bool new_slot);
+static void         stimc_trace_plusarg      (void);
+static PLI_INT32    stimc_trace_eos_callback (struct t_cb_data *cb_data);
+#endif
+#ifndef STIMC_DISABLE_CLEANUP
+static void stimc_trace_free (void);
+#endif
+
+#if defined(STIMC_PROFILE) || defined(STIMC_TRACE)
+static inline uint64_t stimc_wall_time (void);
+#endif
+
+/* vpi callback (un)registration */
+static inline vpiHandle stimc_vpi_register_cb (s_cb_data *data);
+static inline void      stimc_vpi_remove_cb   (vpiHandle cb);
+
+/* timers: threads waiting for the same absolute simulation time share one callback */
+struct stimc_timer_s {
+    uint64_t                    time;      /* absolute wakeup time in simulator units */
+    vpiHandle                   cb_handle; /* vpi callback of this time slot */
+    size_t                      active;    /* number of threads still waiting */
+    struct stimc_thread_queue_s queue;     /* waiting threads */
+    struct stimc_timer_s       *next;      /* next slot in hash bucket */
+};
+
+struct stimc_timer_table_s {
+    size_t                 max;
+    size_t                 num;
+    struct stimc_timer_s **buckets;
+};
+
+static inline size_t         stimc_timer_hash           (uint64_t time, size_t max);
+static struct stimc_timer_s *stimc_timer_get            (uint64_t time, uint64_t delay);
+static void                  stimc_timer_unlink         (struct stimc_timer_s *timer);
+static void                  stimc_timer_enqueue_thread (struct stimc_thread_s *thread, uint64_t delay);
+static void                  stimc_timer_remove_thread  (struct stimc_thread_s *thread);
+static PLI_INT32             stimc_timer_callback       (struct t_cb_data *cb_data);
+
+/* methods: plain callbacks called from simulator/trigger context */
+struct stimc_method_s {
+    void  (*func) (void *data);
+    void *data;
+#ifdef STIMC_TRACE
+    size_t trace_module; /* module the method was registered in */
+#endif
+};
+
+struct stimc_method_list_s {
+    size_t                 max;
+    size_t                 num;
+    struct stimc_method_s *methods;
+};
+
+static inline void stimc_method_list_init   (struct stimc_method_list_s *l);
+static void        stimc_method_list_append (struct stimc_method_list_s *l, void (*methodfunc)(void *userdata), void *userdata);
+static void        stimc_method_list_free   (struct stimc_method_list_s *l);
+static void        stimc_method_list_call   (struct stimc_method_list_s *l);
+
 /* events */
 struct stimc_event_s {
     struct stimc_thread_queue_s queue;
+    struct stimc_method_list_s  methods;
+    unsigned                    dispatch;     /* nesting depth of method calls on trigger */
+    bool                        free_pending; /* freed by a method - release after dispatch */
 #ifndef STIMC_DISABLE_CLEANUP
     struct stimc_cleanup_entry_s *cleanup_self;
 #endif
@@ -165,28 +422,78 @@ static inline void stimc_event_combination_prepare       (stimc_event_combinatio
 static void        stimc_event_combination_append_handle (stimc_event_combination combination, stimc_event event, size_t idx);
 
 static inline void stimc_event_remove_thread     (stimc_event event, size_t queue_idx);
+static void        stimc_event_queue_compact     (stimc_event event);
 static inline void stimc_event_enqueue_thread    (stimc_event event, struct stimc_thread_s *thread);
 static void        stimc_event_thread_queue_free (stimc_event event);
 
 /* methods / callbacks */
-struct stimc_callback_wrap_s {
-    void      (*func) (void *data);
-    void     *data;
-    vpiHandle cb_handle;
+struct stimc_net_methods_s {
+    vpiHandle                  cb_handle; /* value change callback of net */
+    struct stimc_method_list_s posedge;
+    struct stimc_method_list_s negedge;
+    struct stimc_method_list_s change;
+#ifndef STIMC_DISABLE_CLEANUP
+    struct stimc_cleanup_entry_s *cleanup_self;
+#endif
 };
 
-static inline void stimc_valuechange_method_callback_wrapper (struct t_cb_data *cb_data, int edge);
-static PLI_INT32   stimc_posedge_method_callback_wrapper     (struct t_cb_data *cb_data);
-static PLI_INT32   stimc_negedge_method_callback_wrapper     (struct t_cb_data *cb_data);
-static PLI_INT32   stimc_change_method_callback_wrapper      (struct t_cb_data *cb_data);
-static void        stimc_register_valuechange_method         (void (*methodfunc)(void *userdata), void *userdata, stimc_net net, int edge);
-static PLI_INT32   stimc_thread_callback_wrapper             (struct t_cb_data *cb_data);
-static void        stimc_thread_wrap                         (STIMC_THREAD_ARG_DECL);
+static PLI_INT32                   stimc_net_methods_callback        (struct t_cb_data *cb_data);
+static struct stimc_net_methods_s *stimc_net_methods_get             (stimc_net net);
+static void                        stimc_net_methods_register_cb     (stimc_net net);
+static void                        stimc_net_methods_free            (stimc_net net);
+static void                        stimc_register_valuechange_method (void (*methodfunc)(void *userdata), void *userdata, stimc_net net, int edge);
+static void                        stimc_thread_wrap                 (STIMC_THREAD_ARG_DECL);
+
+/* net value access */
+static const int                   stimc_vecval_scalar[4] = {vpi0, vpi1, vpiZ, vpiX}; /* index: aval | bval << 1 */
+static inline const s_vpi_vecval *stimc_net_vecval (stimc_net net);
 
 /* thread helper function */
 static inline void stimc_run     (struct stimc_thread_s *thread);
 static inline void stimc_suspend (void);
 
+/* simulation time */
+#define STIMC_POW10_NUM 20
+
+static const uint64_t stimc_pow10_uint64[STIMC_POW10_NUM] = {
+    UINT64_C (1),
+    UINT64_C (10),
+    UINT64_C (100),
+    UINT64_C (1000),
+    UINT64_C (10000),
+    UINT64_C (100000),
+    UINT64_C (1000000),
+    UINT64_C (10000000),
+    UINT64_C (100000000),
+    UINT64_C (1000000000),
+    UINT64_C (10000000000),
+    UINT64_C (100000000000),
+    UINT64_C (1000000000000),
+    UINT64_C (10000000000000),
+    UINT64_C (100000000000000),
+    UINT64_C (1000000000000000),
+    UINT64_C (10000000000000000),
+    UINT64_C (100000000000000000),
+    UINT64_C (1000000000000000000),
+    UINT64_C (10000000000000000000),
+};
+
+static const double stimc_pow10_double[STIMC_POW10_NUM] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,
+    1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+};
+
+struct stimc_time_data_s {
+    bool   valid;     /* time unit already queried */
+    int    unit;      /* simulator time unit exponent */
+    double scale;     /* simulator time unit in seconds */
+    double scale_inv; /* simulator time units per second */
+};
+
+static inline void     stimc_time_data_init (void);
+static inline uint64_t stimc_time_scale     (uint64_t time, int shift);
+static inline uint64_t stimc_time_sim       (void);
+
 /* common wait function */
 static void stimc_wait_time_int_exp (uint64_t time, int exp);
 static void stimc_event_combination_enqueue_thread (struct stimc_thread_s *thread, stimc_event_combination combination, bool consume);
@@ -197,6 +504,7 @@ enum stimc_nba_type {
     STIMC_NBA_X_ALL,
     STIMC_NBA_VAL_ALL_INT32,
     STIMC_NBA_VAL_ALL_UINT64,
+    STIMC_NBA_VAL_ALL_VECTOR,
     STIMC_NBA_Z_BITS,
     STIMC_NBA_X_BITS,
     STIMC_NBA_VAL_BITS,
@@ -204,27 +512,75 @@ enum stimc_nba_type {
 };
 struct stimc_nba_queue_entry_s {
     union {
-        uint64_t value;
-        double   real_value;
+        uint64_t      value;
+        double        real_value;
+        s_vpi_vecval *vector; /* allocated copy of full vector value */
     };
     enum stimc_nba_type type;
-    uint16_t            lsb;
-    uint16_t            msb;
+    unsigned            lsb;
+    unsigned            msb;
 };
 struct stimc_nba_data_s {
-    vpiHandle                       cb_handle;
     struct stimc_nba_queue_entry_s *queue;
     size_t                          max;
     size_t                          num;
 };
+/* nets with pending non-blocking assignments in order of first assignment */
+struct stimc_nba_net_list_s {
+    size_t     max;
+    size_t     num;
+    stimc_net *nets;
+};
 
 static void      stimc_net_nba_queue_append     (stimc_net net, struct stimc_nba_queue_entry_s *entry_new);
+static void      stimc_net_nba_dirty_add        (stimc_net net);
+static void      stimc_net_nba_dirty_remove     (stimc_net net);
+#ifndef STIMC_DISABLE_CLEANUP
+static void      stimc_net_nba_dirty_free       (void);
+#endif
 static PLI_INT32 stimc_net_nba_callback_wrapper (struct t_cb_data *cb_data);
+static void      stimc_net_nba_flush            (stimc_net net, const struct stimc_nba_queue_entry_s *queue, size_t num);
+static void      stimc_net_nba_entries_free     (struct stimc_nba_queue_entry_s *queue, size_t num);
 
 /* common x/z setters */
 static inline void stimc_net_set_xz      (stimc_net net, int val);
 static inline void stimc_net_set_bits_xz (stimc_net net, unsigned msb, unsigned lsb, int val);
 
+/* memories */
+struct stimc_memory_s {
+    vpiHandle  mem;
+    unsigned   width;
+    unsigned   depth;
+    int32_t    base;  /* lowest address */
+    vpiHandle *words; /* word handles by address - base (resolved on first access) */
+};
+
+static inline vpiHandle stimc_memory_word         (stimc_memory mem, int32_t addr);
+static void             stimc_memory_word_put     (stimc_memory mem, int32_t addr, s_vpi_vecval *vec);
+static bool             stimc_memory_hex_word     (s_vpi_vecval *vec, unsigned width, const char *digits, size_t len);
+static const char      *stimc_memory_file_map     (const char *filename, size_t *len);
+static void             stimc_memory_file_unmap   (const char *data, size_t len);
+
+/* port bundles */
+struct stimc_port_bundle_entry_s {
+    stimc_port port;
+    size_t     offset;   /* first word in bundle buffer */
+    unsigned   words;
+    bool       known;    /* buffer holds value of port (after snapshot/commit) */
+    bool       modified; /* buffer changed since last snapshot/commit */
+};
+struct stimc_port_bundle_s {
+    size_t                            num;
+    size_t                            max;
+    size_t                            words;
+    size_t                            words_max;
+    struct stimc_port_bundle_entry_s *entries;
+    s_vpi_vecval                     *buffer;
+};
+
+static void        stimc_net_set_vecval_nonblock (stimc_net net, const s_vpi_vecval *vec);
+static inline void stimc_port_bundle_word_set    (stimc_port_bundle bundle, struct stimc_port_bundle_entry_s *e, unsigned j, uint32_t aval, uint32_t bval);
+
 /* final cleanup */
 #ifndef STIMC_DISABLE_CLEANUP
 struct stimc_cleanup_entry_s {
@@ -260,9 +616,9 @@ struct stimc_cleanup_data_main_s {
 static void      stimc_cleanup_internal (enum stimc_cleanup_reason reason);
 static PLI_INT32 stimc_cleanup_callback (struct t_cb_data *cb_data);
 
-static void stimc_cleanup_callback_wrap (void *userdata);
-static void stimc_cleanup_thread        (void *userdata);
-static void stimc_cleanup_event         (void *userdata);
+static void stimc_cleanup_net_methods (void *userdata);
+static void stimc_cleanup_thread      (void *userdata);
+static void stimc_cleanup_event       (void *userdata);
 
 /* simulator data */
 struct stimc_vlog_product_data {
@@ -292,8 +648,35 @@ static struct stimc_thread_s *stimc_current_thread = NULL;
 
 static bool stimc_finish_pending = false;
 
-static struct stimc_thread_queue_s stimc_main_queue        = {0, 0, NULL};
-static struct stimc_thread_queue_s stimc_main_queue_shadow = {0, 0, NULL};
+static struct stimc_thread_queue_s stimc_main_queue        = {0, 0, 0, NULL};
+static struct stimc_thread_queue_s stimc_main_queue_shadow = {0, 0, 0, NULL};
+
+static struct stimc_timer_table_s stimc_timers = {0, 0, NULL};
+
+static struct stimc_time_data_s stimc_time_data = {false, 0, 1.0, 1.0};
+
+static struct stimc_thread_stack_usage_table_s stimc_thread_stack_usage = {0, 0, NULL};
+
+#ifdef STIMC_PROFILE
+static struct stimc_profile_s stimc_profile;
+#endif
+
+#ifdef STIMC_TRACE
+static struct stimc_trace_s stimc_trace;
+#endif
+
+static struct stimc_nba_net_list_s stimc_nba_dirty    = {0, 0, NULL};
+static struct stimc_nba_net_list_s stimc_nba_flushing = {0, 0, NULL};
+static vpiHandle                   stimc_nba_cb_handle = NULL;
+
+/* allocators for internal objects */
+static struct stimc_slab_s stimc_thread_slab        = STIMC_SLAB_INIT (struct stimc_thread_s);
+static struct stimc_slab_s stimc_event_slab         = STIMC_SLAB_INIT (struct stimc_event_s);
+static struct stimc_slab_s stimc_combination_slab   = STIMC_SLAB_INIT (struct stimc_event_combination_s);
+static struct stimc_slab_s stimc_timer_slab         = STIMC_SLAB_INIT (struct stimc_timer_s);
+#ifndef STIMC_DISABLE_CLEANUP
+static struct stimc_slab_s stimc_cleanup_entry_slab = STIMC_SLAB_INIT (struct stimc_cleanup_entry_s);
+#endif
 
 #ifndef STIMC_DISABLE_CLEANUP
 static struct stimc_cleanup_data_main_s stimc_cleanup_data = {NULL, {NULL, NULL}};
@@ -316,63 +699,128 @@ static vpiHandle stimc_get_caller_scope (void)
     return taskscope;
 }
 
-static inline void stimc_valuechange_method_callback_wrapper (struct t_cb_data *cb_data, int edge)
+static inline vpiHandle stimc_vpi_register_cb (s_cb_data *data)
 {
-    struct stimc_callback_wrap_s *wrap = (struct stimc_callback_wrap_s *)cb_data->user_data;
+    STIMC_PROFILE_COUNT (cb_registered, 1);
 
-    /* correct edge? */
-    if ((edge > 0) && (cb_data->value->value.scalar != vpi1)) {
-        return;
+    return vpi_register_cb (data);
+}
+
+static inline void stimc_vpi_remove_cb (vpiHandle cb)
+{
+    STIMC_PROFILE_COUNT (cb_removed, 1);
+
+    vpi_remove_cb (cb);
+}
+
+static PLI_INT32 stimc_net_methods_callback (struct t_cb_data *cb_data)
+{
+    stimc_net                   net     = (stimc_net)cb_data->user_data;
+    struct stimc_net_methods_s *methods = net->methods;
+
+    STIMC_PROFILE_ENTER (STIMC_PROFILE_STIMC);
+    STIMC_PROFILE_COUNT (cb_executed, 1);
+
+    int scalar;
+
+    if (net->cache != NULL) {
+        /* update cached value before any method or thread reads it */
+        unsigned vsize = ((net->size - 1) / 32) + 1;
+
+        for (unsigned i = 0; i < vsize; i++) {
+            net->cache[i] = cb_data->value->value.vector[i];
+        }
+
+        scalar = stimc_vecval_scalar[(net->cache[0].aval & 1) | ((net->cache[0].bval & 1) << 1)];
+    } else {
+        scalar = cb_data->value->value.scalar;
     }
-    if ((edge < 0) && (cb_data->value->value.scalar != vpi0)) {
-        return;
+
+    /* edge methods */
+    if (scalar == vpi1) {
+        stimc_method_list_call (&methods->posedge);
+    } else if (scalar == vpi0) {
+        stimc_method_list_call (&methods->negedge);
     }
 
-    wrap->func (wrap->data);
+    /* value change methods */
+    stimc_method_list_call (&methods->change);
 
     stimc_main_queue_run_threads ();
-}
 
-static PLI_INT32 stimc_posedge_method_callback_wrapper (struct t_cb_data *cb_data)
-{
-    stimc_valuechange_method_callback_wrapper (cb_data, 1);
+    STIMC_PROFILE_LEAVE ();
+
     return 0;
 }
-static PLI_INT32 stimc_negedge_method_callback_wrapper (struct t_cb_data *cb_data)
+
+static void stimc_net_methods_free (stimc_net net)
 {
-    stimc_valuechange_method_callback_wrapper (cb_data, -1);
-    return 0;
+    struct stimc_net_methods_s *methods = net->methods;
+
+    if (methods == NULL) return;
+
+#ifndef STIMC_DISABLE_CLEANUP
+    if (methods->cleanup_self != NULL) {
+        methods->cleanup_self->cancel = true;
+    }
+#endif
+
+    stimc_vpi_remove_cb (methods->cb_handle);
+
+    stimc_method_list_free (&methods->posedge);
+    stimc_method_list_free (&methods->negedge);
+    stimc_method_list_free (&methods->change);
+
+    free (methods);
+    net->methods = NULL;
+
+    /* cached value is not updated anymore */
+    if (net->cache != NULL) {
+        free (net->cache);
+        net->cache = NULL;
+    }
 }
-static PLI_INT32 stimc_change_method_callback_wrapper (struct t_cb_data *cb_data)
+
+static struct stimc_net_methods_s *stimc_net_methods_get (stimc_net net)
 {
-    stimc_valuechange_method_callback_wrapper (cb_data, 0);
-    return 0;
+    struct stimc_net_methods_s *methods = net->methods;
+
+    if (methods != NULL) return methods;
+
+    methods = (struct stimc_net_methods_s *)malloc (sizeof (struct stimc_net_methods_s));
+    assert (methods);
+
+    stimc_method_list_init (&methods->posedge);
+    stimc_method_list_init (&methods->negedge);
+    stimc_method_list_init (&methods->change);
+
+    methods->cb_handle = NULL;
+    net->methods       = methods;
+
+    stimc_net_methods_register_cb (net);
+
+#ifndef STIMC_DISABLE_CLEANUP
+    methods->cleanup_self = stimc_cleanup_add (stimc_cleanup_net_methods, net);
+#endif
+
+    return methods;
 }
 
-static void stimc_register_valuechange_method (void (*methodfunc)(void *userdata), void *userdata, stimc_net net, int edge)
+static void stimc_net_methods_register_cb (stimc_net net)
 {
+    struct stimc_net_methods_s *methods = net->methods;
+
+    if (methods->cb_handle != NULL) {
+        stimc_vpi_remove_cb (methods->cb_handle);
+    }
+
+    /* one dispatching callback per net - cached nets need the full value */
     s_cb_data   data;
     s_vpi_time  data_time;
     s_vpi_value data_value;
 
-    struct stimc_callback_wrap_s *wrap = (struct stimc_callback_wrap_s *)malloc (sizeof (struct stimc_callback_wrap_s));
-
-    assert (wrap);
-
-    wrap->func = methodfunc;
-    wrap->data = userdata;
-
-    data.reason = cbValueChange;
-    if (edge > 0) {
-        /* posedge */
-        data.cb_rtn = stimc_posedge_method_callback_wrapper;
-    } else if (edge < 0) {
-        /* negedge */
-        data.cb_rtn = stimc_negedge_method_callback_wrapper;
-    } else {
-        /* value change */
-        data.cb_rtn = stimc_change_method_callback_wrapper;
-    }
+    data.reason        = cbValueChange;
+    data.cb_rtn        = stimc_net_methods_callback;
     data.obj           = net->net;
     data.time          = &data_time;
     data.time->type    = vpiSuppressTime;
@@ -380,16 +828,28 @@ static void stimc_register_valuechange_method (void (*methodfunc)(void *userdata
     data.time->low     = 0;
     data.time->real    = 0;
     data.value         = &data_value;
-    data.value->format = vpiScalarVal;
+    data.value->format = (net->cache != NULL) ? vpiVectorVal : vpiScalarVal;
     data.index         = 0;
-    data.user_data     = (PLI_BYTE8 *)wrap;
+    data.user_data     = (PLI_BYTE8 *)net;
 
-    wrap->cb_handle = vpi_register_cb (&data);
-    assert (wrap->cb_handle);
+    methods->cb_handle = stimc_vpi_register_cb (&data);
+    assert (methods->cb_handle);
+}
 
-#ifndef STIMC_DISABLE_CLEANUP
-    stimc_cleanup_add (stimc_cleanup_callback_wrap, wrap);
-#endif
+static void stimc_register_valuechange_method (void (*methodfunc)(void *userdata), void *userdata, stimc_net net, int edge)
+{
+    struct stimc_net_methods_s *methods = stimc_net_methods_get (net);
+
+    if (edge > 0) {
+        /* posedge */
+        stimc_method_list_append (&methods->posedge, methodfunc, userdata);
+    } else if (edge < 0) {
+        /* negedge */
+        stimc_method_list_append (&methods->negedge, methodfunc, userdata);
+    } else {
+        /* value change */
+        stimc_method_list_append (&methods->change, methodfunc, userdata);
+    }
 }
 
 void stimc_register_posedge_method (void (*methodfunc)(void *userdata), void *userdata, stimc_net net)
@@ -405,21 +865,61 @@ void stimc_register_change_method  (void (*methodfunc)(void *userdata), void *us
     stimc_register_valuechange_method (methodfunc, userdata, net, 0);
 }
 
-static struct stimc_thread_s *stimc_thread_create (void (*threadfunc)(void *userdata), void *userdata, size_t stacksize)
+void stimc_net_enable_cache (stimc_net net)
 {
-    struct stimc_thread_s *thread = (struct stimc_thread_s *)malloc (sizeof (struct stimc_thread_s));
+    if (net->cache != NULL) return;
 
-    assert (thread);
+    assert (net->type != vpiRealVar);
 
-    if (stacksize == 0) stacksize = STIMC_THREAD_STACK_SIZE_DEFAULT;
-    stimc_thread_impl ti = stimc_thread_impl_create (stimc_thread_wrap, stacksize);
+    unsigned vsize = ((net->size - 1) / 32) + 1;
+
+    net->cache = (s_vpi_vecval *)malloc (vsize * sizeof (s_vpi_vecval));
+    assert (net->cache);
+
+    s_vpi_value v;
+
+    v.format = vpiVectorVal;
+    vpi_get_value (net->net, &v);
+
+    for (unsigned i = 0; i < vsize; i++) {
+        net->cache[i] = v.value.vector[i];
+    }
+
+    /* existing dispatcher needs to be registered for vector values */
+    if (net->methods != NULL) {
+        stimc_net_methods_register_cb (net);
+    } else {
+        stimc_net_methods_get (net);
+    }
+}
+
+static inline const s_vpi_vecval *stimc_net_vecval (stimc_net net)
+{
+    if (net->cache != NULL) return net->cache;
+
+    s_vpi_value v;
+
+    v.format = vpiVectorVal;
+    vpi_get_value (net->net, &v);
+
+    return v.value.vector;
+}
+
+static struct stimc_thread_s *stimc_thread_alloc (void (*threadfunc)(void *userdata), void *userdata)
+{
+    struct stimc_thread_s *thread = (struct stimc_thread_s *)stimc_slab_alloc (&stimc_thread_slab);
+
+    assert (thread);
 
-    thread->thread = ti;
-    thread->func   = threadfunc;
-    thread->data   = userdata;
+    thread->thread    = NULL;
+    thread->func      = threadfunc;
+    thread->freefunc  = NULL;
+    thread->data      = userdata;
+    thread->stackless = false;
 
-    thread->call_handle = NULL;
-    thread->timeout     = false;
+    thread->timer     = NULL;
+    thread->timer_idx = 0;
+    thread->timeout   = false;
 
     thread->state            = STIMC_THREAD_STATE_CREATED;
     thread->resume_on_finish = false;
@@ -430,6 +930,26 @@ static struct stimc_thread_s *stimc_thread_create (void (*threadfunc)(void *user
     thread->cleanup_queue = NULL;
     thread->cleanup_self  = stimc_cleanup_add (stimc_cleanup_thread, thread);
 #endif
+#ifdef STIMC_PROFILE
+    thread->profile_idx = stimc_profile_func_idx (threadfunc);
+    stimc_profile.funcs[thread->profile_idx].threads++;
+#endif
+#ifdef STIMC_TRACE
+    stimc_trace.thread_ids++;
+    thread->trace_id      = stimc_trace.thread_ids;
+    thread->trace_module  = (stimc_current_thread != NULL) ? stimc_current_thread->trace_module : stimc_trace.module;
+    thread->trace_session = 0;
+#endif
+
+    return thread;
+}
+
+static struct stimc_thread_s *stimc_thread_create (void (*threadfunc)(void *userdata), void *userdata, size_t stacksize)
+{
+    struct stimc_thread_s *thread = stimc_thread_alloc (threadfunc, userdata);
+
+    if (stacksize == 0) stacksize = STIMC_THREAD_STACK_SIZE_DEFAULT;
+    thread->thread = stimc_thread_impl_create (stimc_thread_wrap, stacksize);
 
     return thread;
 }
@@ -481,810 +1001,2491 @@ bool stimc_thread_is_finished (void)
     return false;
 }
 
-static void stimc_thread_finish (struct stimc_thread_s *thread)
+void stimc_thread_stack_pool_stats (uint64_t *hits, uint64_t *misses)
 {
-    assert (thread);
+    stimc_thread_impl_stack_pool_stats (hits, misses);
+}
 
-#ifndef STIMC_DISABLE_CLEANUP
-    thread->cleanup_self->cancel = true;
-#endif
+#ifdef STIMC_THREAD_STACK_WATERMARK
+static void stimc_thread_stack_usage_add (void (*threadfunc)(void *userdata), stimc_thread_impl ti)
+{
+    size_t used;
+    size_t size;
 
-    /* final resume ? */
-    bool final_resume = false;
-    if (thread->resume_on_finish
-        && thread->state > STIMC_THREAD_STATE_CREATED
-        && thread->state < STIMC_THREAD_STATE_FINISHED) {
-        final_resume = true;
-    }
+    stimc_thread_impl_stack_usage (ti, &used, &size);
+    if (size == 0) return;
 
-    thread->state = STIMC_THREAD_STATE_CLEANUP;
+    struct stimc_thread_stack_usage_s *u = NULL;
 
-    if (final_resume) {
-        stimc_run (thread);
+    for (size_t i = 0; i < stimc_thread_stack_usage.num; i++) {
+        if (stimc_thread_stack_usage.entries[i].func == threadfunc) {
+            u = &(stimc_thread_stack_usage.entries[i]);
+            break;
+        }
     }
 
-    /* remove resume callbacks */
-    if (thread->call_handle != NULL) {
-        vpi_remove_cb (thread->call_handle);
-    }
-    for (size_t i = 0; i < thread->event_combination->num; i++) {
-        struct stimc_event_handle_s *h = &(thread->event_combination->events[i]);
-        stimc_event_remove_thread (h->event, h->idx);
-        h->event = NULL;
+    if (u == NULL) {
+        if (stimc_thread_stack_usage.num == stimc_thread_stack_usage.max) {
+            stimc_thread_stack_usage.max     = (stimc_thread_stack_usage.max == 0) ? 16 : 2 * stimc_thread_stack_usage.max;
+            stimc_thread_stack_usage.entries = (struct stimc_thread_stack_usage_s *)realloc (
+                stimc_thread_stack_usage.entries, sizeof (struct stimc_thread_stack_usage_s) * stimc_thread_stack_usage.max);
+            assert (stimc_thread_stack_usage.entries);
+        }
+
+        u = &(stimc_thread_stack_usage.entries[stimc_thread_stack_usage.num]);
+        stimc_thread_stack_usage.num++;
+
+        u->func = threadfunc;
+        u->num  = 0;
+        u->size = 0;
+        u->used = 0;
     }
 
+    u->num++;
+    if (size > u->size) u->size = size;
+    if (used > u->used) u->used = used;
+}
+#endif
+
 #ifndef STIMC_DISABLE_CLEANUP
-    stimc_cleanup_run (&(thread->cleanup_queue));
+static void stimc_thread_stack_usage_free (void)
+{
+    if (stimc_thread_stack_usage.entries != NULL) free (stimc_thread_stack_usage.entries);
+
+    stimc_thread_stack_usage.max     = 0;
+    stimc_thread_stack_usage.num     = 0;
+    stimc_thread_stack_usage.entries = NULL;
+}
 #endif
 
-    stimc_thread_impl ti = thread->thread;
-    stimc_event_combination_free (thread->event_combination);
-    free (thread);
-    stimc_thread_impl_delete (ti);
+static void stimc_func_symbol (void (*func)(void *data), char *buf, size_t len)
+{
+    void *func_ptr;
+
+    memcpy (&func_ptr, &func, sizeof (func_ptr));
+
+#ifdef STIMC_FUNC_SYMBOLS
+    /* resolve function symbol if possible */
+    char **symbols = backtrace_symbols (&func_ptr, 1);
+    snprintf (buf, len, "%s", (symbols != NULL) ? symbols[0] : "?");
+    free (symbols);
+#else
+    snprintf (buf, len, "%p", func_ptr);
+#endif
 }
 
-static void stimc_thread_remove_event_handle (struct stimc_thread_s *thread, stimc_event event)
+void stimc_thread_stack_report (void)
 {
-    for (size_t i = 0; i < thread->event_combination->num; i++) {
-        struct stimc_event_handle_s *h = &(thread->event_combination->events[i]);
+    vpi_printf ("stimc thread stack usage (%zu thread functions):\n", stimc_thread_stack_usage.num);
 
-        if (h->event == event) {
-            size_t idx_last = thread->event_combination->num - 1;
+    for (size_t i = 0; i < stimc_thread_stack_usage.num; i++) {
+        struct stimc_thread_stack_usage_s *u = &(stimc_thread_stack_usage.entries[i]);
 
-            if (i == idx_last) {
-                thread->event_combination->num--;
-            } else {
-                thread->event_combination->events[i] = thread->event_combination->events[idx_last];
-                thread->event_combination->num--;
-            }
+        char symbol[256];
+        stimc_func_symbol (u->func, symbol, sizeof (symbol));
 
-            break;
-        }
+        vpi_printf ("  %s: threads: %zu, stack size: %zu, max. used: %zu (%zu%%)\n",
+                    symbol, u->num, u->size, u->used, (100 * u->used) / u->size);
     }
 }
 
-static inline bool stimc_thread_has_event_handle (struct stimc_thread_s *thread)
+#if defined(STIMC_PROFILE) || defined(STIMC_TRACE)
+static inline uint64_t stimc_wall_time (void)
 {
-    return (thread->event_combination->num > 0);
+    struct timespec ts;
+
+#ifdef CLOCK_MONOTONIC
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+#else
+    timespec_get (&ts, TIME_UTC);
+#endif
+
+    return ((uint64_t)ts.tv_sec * UINT64_C (1000000000)) + (uint64_t)ts.tv_nsec;
 }
+#endif
 
-static PLI_INT32 stimc_thread_callback_wrapper (struct t_cb_data *cb_data)
+#ifdef STIMC_PROFILE
+static inline enum stimc_profile_section stimc_profile_switch (enum stimc_profile_section section, uint64_t now)
 {
-    struct stimc_thread_s *thread = (struct stimc_thread_s *)cb_data->user_data;
+    enum stimc_profile_section prev = stimc_profile.section;
 
-    assert (thread);
-
-    stimc_thread_queue_enqueue (&stimc_main_queue, thread);
-
-    if (thread->call_handle != NULL) {
-        vpi_remove_cb (thread->call_handle);
-        thread->call_handle = NULL;
-    }
-    for (size_t i = 0; i < thread->event_combination->num; i++) {
-        struct stimc_event_handle_s *h = &(thread->event_combination->events[i]);
-        stimc_event_remove_thread (h->event, h->idx);
-        /* if event handle exists, this has to be a timeout callback */
-        thread->timeout = true;
+    /* first measurement starts now */
+    if (stimc_profile.section_start != 0) {
+        stimc_profile.section_time[prev] += now - stimc_profile.section_start;
     }
-    stimc_event_combination_clear (thread->event_combination);
 
-    stimc_main_queue_run_threads ();
+    stimc_profile.section       = section;
+    stimc_profile.section_start = now;
 
-    return 0;
+    return prev;
 }
 
-static void stimc_thread_wrap (STIMC_THREAD_ARG_DEF)
+static size_t stimc_profile_func_idx (void (*func)(void *data))
 {
-    struct stimc_thread_s *thread = stimc_current_thread;
+    for (size_t i = 0; i < stimc_profile.funcs_num; i++) {
+        if (stimc_profile.funcs[i].func == func) return i;
+    }
 
-    assert (thread);
+    if (stimc_profile.funcs_num == stimc_profile.funcs_max) {
+        stimc_profile.funcs_max = (stimc_profile.funcs_max == 0) ? 16 : 2 * stimc_profile.funcs_max;
+        stimc_profile.funcs     = (struct stimc_profile_func_s *)realloc (
+            stimc_profile.funcs, sizeof (struct stimc_profile_func_s) * stimc_profile.funcs_max);
+        assert (stimc_profile.funcs);
+    }
 
-    thread->state = STIMC_THREAD_STATE_RUNNING;
-    thread->func (thread->data);
+    size_t idx = stimc_profile.funcs_num;
+    stimc_profile.funcs_num++;
 
-    if (thread->state < STIMC_THREAD_STATE_FINISHED) {
-        thread->state = STIMC_THREAD_STATE_FINISHED;
-    }
-    stimc_suspend ();
-}
+    struct stimc_profile_func_s *f = &(stimc_profile.funcs[idx]);
 
-void stimc_register_startup_thread (void (*threadfunc)(void *userdata), void *userdata, size_t stacksize)
-{
-    stimc_spawn_thread (threadfunc, userdata, stacksize);
+    f->func    = func;
+    f->threads = 0;
+    f->resumes = 0;
+    f->time    = 0;
+
+    return idx;
 }
 
-void stimc_spawn_thread (void (*threadfunc)(void *userdata), void *userdata, size_t stacksize)
+static void stimc_profile_run_start (void)
 {
-    struct stimc_thread_s *thread = stimc_thread_create (threadfunc, userdata, stacksize);
+    uint64_t time = stimc_time_sim ();
 
-    assert (thread);
+    stimc_profile.run_calls++;
 
-    stimc_thread_queue_enqueue (&stimc_main_queue, thread);
+    if ((stimc_profile.time_steps > 0) && (time == stimc_profile.time_step_last)) return;
+
+    stimc_profile.time_steps++;
+    stimc_profile.time_step_last = time;
+    stimc_profile.time_step_iter = 0;
 }
 
-static inline void stimc_run (struct stimc_thread_s *thread)
+static inline void stimc_profile_run_iteration (void)
 {
-    stimc_current_thread = thread;
+    stimc_profile.run_iterations++;
+    stimc_profile.time_step_iter++;
 
-    stimc_thread_fence ();
-    stimc_thread_impl_run (thread->thread);
-    stimc_thread_fence ();
+    if (stimc_profile.time_step_iter > stimc_profile.time_step_iter_max) {
+        stimc_profile.time_step_iter_max = stimc_profile.time_step_iter;
+    }
+}
 
-    stimc_current_thread = NULL;
+static void stimc_profile_printf (FILE *f, const char *format, ...) __attribute__((format (printf, 2, 3)));
+static void stimc_profile_printf (FILE *f, const char *format, ...)
+{
+    va_list ap;
 
-    if (thread->state >= STIMC_THREAD_STATE_STOPPED_TO_FINISH
-        && thread->state < STIMC_THREAD_STATE_CLEANUP) {
-        stimc_thread_finish (thread);
+    va_start (ap, format);
+    if (f != NULL) {
+        vfprintf (f, format, ap);
+    } else {
+        char line[512];
+        vsnprintf (line, sizeof (line), format, ap);
+        vpi_printf ("%s", line);
     }
+    va_end (ap);
 }
 
-static inline void stimc_suspend (void)
+static double stimc_profile_ms (uint64_t ns)
 {
-    stimc_thread_fence ();
-    stimc_thread_impl_suspend ();
-    stimc_thread_fence ();
+    return 1e-6 * (double)ns;
 }
+#endif
 
-static void stimc_wait_time_int_exp (uint64_t time, int exp)
+void stimc_profile_report (const char *filename)
 {
-    /* thread data ... */
-    struct stimc_thread_s *thread = stimc_current_thread;
+#ifdef STIMC_PROFILE
+    FILE *f = NULL;
+
+    if (filename != NULL) {
+        f = fopen (filename, "w");
+        if (f == NULL) {
+            vpi_printf ("stimc: could not open profile report file \"%s\"\n", filename);
+            return;
+        }
+    }
 
-    assert (thread);
+    /* account time up to now to current section */
+    stimc_profile_switch (stimc_profile.section, stimc_wall_time ());
 
-    /* time ... */
-    uint64_t ltime        = time;
-    int      timeunit_raw = vpi_get (vpiTimeUnit, NULL);
+    const struct stimc_profile_s *p = &stimc_profile;
 
-    while (exp > timeunit_raw) {
-        ltime *= 10;
-        exp--;
+    uint64_t time_total = 0;
+    for (enum stimc_profile_section s = 0; s < STIMC_PROFILE__SIZE_; s++) {
+        time_total += p->section_time[s];
     }
-    while (exp < timeunit_raw) {
-        ltime /= 10;
-        exp++;
+    if (time_total == 0) time_total = 1;
+
+    uint64_t resumes = 0;
+    for (size_t i = 0; i < p->funcs_num; i++) {
+        resumes += p->funcs[i].resumes;
     }
-    uint64_t ltime_h = ltime >> 32;
-    uint64_t ltime_l = ltime & 0xffffffff;
 
-    /* add callback ... */
-    s_cb_data   data;
-    s_vpi_time  data_time;
-    s_vpi_value data_value;
+    stimc_profile_printf (f, "stimc profile:\n");
+    stimc_profile_printf (f, "  wall time [ms]: threads: %.3f (%.1f%%), methods: %.3f (%.1f%%), stimc: %.3f (%.1f%%), outside stimc: %.3f (%.1f%%)\n",
+                          stimc_profile_ms (p->section_time[STIMC_PROFILE_THREAD]),    (100.0 * (double)p->section_time[STIMC_PROFILE_THREAD])    / (double)time_total,
+                          stimc_profile_ms (p->section_time[STIMC_PROFILE_METHOD]),    (100.0 * (double)p->section_time[STIMC_PROFILE_METHOD])    / (double)time_total,
+                          stimc_profile_ms (p->section_time[STIMC_PROFILE_STIMC]),     (100.0 * (double)p->section_time[STIMC_PROFILE_STIMC])     / (double)time_total,
+                          stimc_profile_ms (p->section_time[STIMC_PROFILE_SIMULATOR]), (100.0 * (double)p->section_time[STIMC_PROFILE_SIMULATOR]) / (double)time_total);
+    stimc_profile_printf (f, "  vpi callbacks: registered: %" PRIu64 ", removed: %" PRIu64 ", executed: %" PRIu64 "\n",
+                          p->cb_registered, p->cb_removed, p->cb_executed);
+    stimc_profile_printf (f, "  main queue: runs: %" PRIu64 ", iterations: %" PRIu64 ", thread resumes: %" PRIu64
+                          ", time steps: %" PRIu64 ", iterations per time step: %.2f (max. %" PRIu64 ")\n",
+                          p->run_calls, p->run_iterations, resumes, p->time_steps,
+                          (p->time_steps > 0) ? (double)p->run_iterations / (double)p->time_steps : 0.0, p->time_step_iter_max);
+    stimc_profile_printf (f, "  events: triggered: %" PRIu64 ", waiters woken: %" PRIu64 ", methods called: %" PRIu64 "\n",
+                          p->events_triggered, p->waiters_woken, p->methods_called);
+    stimc_profile_printf (f, "  non-blocking assignments: flushes: %" PRIu64 ", nets: %" PRIu64 ", entries: %" PRIu64 "\n",
+                          p->nba_flushes, p->nba_nets, p->nba_entries);
+    stimc_profile_printf (f, "  thread functions (%zu):\n", p->funcs_num);
+
+    for (size_t i = 0; i < p->funcs_num; i++) {
+        const struct stimc_profile_func_s *pf = &(p->funcs[i]);
+
+        char symbol[256];
+        stimc_func_symbol (pf->func, symbol, sizeof (symbol));
+
+        stimc_profile_printf (f, "    %s: threads: %" PRIu64 ", context switches: %" PRIu64 ", time [ms]: %.3f (%.3f us per switch)\n",
+                              symbol, pf->threads, pf->resumes, stimc_profile_ms (pf->time),
+                              (pf->resumes > 0) ? (1e-3 * (double)pf->time) / (double)pf->resumes : 0.0);
+    }
 
-    data.reason        = cbAfterDelay;
-    data.cb_rtn        = stimc_thread_callback_wrapper;
-    data.obj           = NULL;
-    data.time          = &data_time;
-    data.time->type    = vpiSimTime;
-    data.time->high    = ltime_h;
-    data.time->low     = ltime_l;
-    data.time->real    = time;
-    data.value         = &data_value;
-    data.value->format = vpiSuppressVal;
-    data.index         = 0;
-    data.user_data     = (PLI_BYTE8 *)thread;
+    if (f != NULL) fclose (f);
+#else
+    (void)filename;
+    vpi_printf ("stimc profile not available (build with PROFILE enabled)\n");
+#endif
+}
 
-    vpiHandle wait_handle = vpi_register_cb (&data);
+void stimc_profile_set_report_file (const char *filename)
+{
+#ifdef STIMC_PROFILE
+    if (stimc_profile.report_file != NULL) free (stimc_profile.report_file);
+    stimc_profile.report_file = NULL;
 
-    assert (wait_handle);
+    if (filename != NULL) {
+        size_t len = strlen (filename) + 1;
 
-    thread->call_handle = wait_handle;
+        stimc_profile.report_file = (char *)malloc (len);
+        assert (stimc_profile.report_file);
+        memcpy (stimc_profile.report_file, filename, len);
+    }
+#else
+    (void)filename;
+#endif
+}
 
-    /* thread handling ... */
-    stimc_suspend ();
+#ifndef STIMC_DISABLE_CLEANUP
+static void stimc_profile_free (void)
+{
+#ifdef STIMC_PROFILE
+    if (stimc_profile.funcs != NULL) free (stimc_profile.funcs);
+    if (stimc_profile.report_file != NULL) free (stimc_profile.report_file);
+
+    memset (&stimc_profile, 0, sizeof (stimc_profile));
+#endif
 }
+#endif
 
-void stimc_wait_time (uint64_t time, enum stimc_time_unit exp)
+#ifdef STIMC_TRACE
+static inline bool stimc_trace_active (void)
 {
-    stimc_wait_time_int_exp (time, (int)exp);
+    return (stimc_trace.file != NULL);
 }
 
-void stimc_wait_time_seconds (double time)
+/* copy of name usable inside json strings */
+static char *stimc_trace_name_copy (const char *name)
 {
-    /* time ... */
-    int    timeunit_raw = vpi_get (vpiTimeUnit, NULL);
-    double timeunit     = timeunit_raw;
+    size_t len = strlen (name);
 
-    time *= pow (10, -timeunit);
-    uint64_t ltime = time;
+    if (len >= STIMC_TRACE_NAME_MAX) len = STIMC_TRACE_NAME_MAX - 1;
 
-    stimc_wait_time_int_exp (ltime, timeunit_raw);
+    char *result = (char *)malloc (len + 1);
+    assert (result);
+
+    for (size_t i = 0; i < len; i++) {
+        char c = name[i];
+        result[i] = ((c == '"') || (c == '\\') || ((unsigned char)c < 0x20)) ? '_' : c;
+    }
+    result[len] = '\0';
+
+    return result;
 }
 
-uint64_t stimc_time (enum stimc_time_unit exp)
+static size_t stimc_trace_module (vpiHandle mod)
 {
-    /* get time */
-    s_vpi_time time;
-    int        exp_int = (int)exp;
+    char *name = stimc_trace_name_copy (vpi_get_str (vpiFullName, mod));
 
-    time.type = vpiSimTime;
-    vpi_get_time (NULL, &time);
+    for (size_t i = 0; i < stimc_trace.modules_num; i++) {
+        if (strcmp (stimc_trace.modules[i].name, name) == 0) {
+            free (name);
+            return i + 1;
+        }
+    }
 
-    uint64_t ltime_h = time.high;
-    uint64_t ltime_l = time.low;
-    uint64_t ltime   = ((ltime_h << 32) | ltime_l);
+    if (stimc_trace.modules_num == stimc_trace.modules_max) {
+        stimc_trace.modules_max = (stimc_trace.modules_max == 0) ? 16 : 2 * stimc_trace.modules_max;
+        stimc_trace.modules     = (struct stimc_trace_module_s *)realloc (
+            stimc_trace.modules, sizeof (struct stimc_trace_module_s) * stimc_trace.modules_max);
+        assert (stimc_trace.modules);
+    }
 
-    /* timeunit */
-    int timeunit_raw = vpi_get (vpiTimeUnit, NULL);
+    struct stimc_trace_module_s *m = &(stimc_trace.modules[stimc_trace.modules_num]);
+    stimc_trace.modules_num++;
 
-    while (exp_int < timeunit_raw) {
-        ltime *= 10;
-        exp_int++;
-    }
-    while (exp_int > timeunit_raw) {
-        ltime /= 10;
-        exp_int--;
-    }
+    m->name    = name;
+    m->session = 0;
 
-    return ltime;
+    return stimc_trace.modules_num;
 }
 
-double stimc_time_seconds (void)
+static const char *stimc_trace_func_name (void (*func)(void *data))
 {
-    /* get time */
-    s_vpi_time time;
+    for (size_t i = 0; i < stimc_trace.funcs_num; i++) {
+        if (stimc_trace.funcs[i].func == func) return stimc_trace.funcs[i].name;
+    }
 
-    time.type = vpiSimTime;
-    vpi_get_time (NULL, &time);
+    if (stimc_trace.funcs_num == stimc_trace.funcs_max) {
+        stimc_trace.funcs_max = (stimc_trace.funcs_max == 0) ? 16 : 2 * stimc_trace.funcs_max;
+        stimc_trace.funcs     = (struct stimc_trace_func_s *)realloc (
+            stimc_trace.funcs, sizeof (struct stimc_trace_func_s) * stimc_trace.funcs_max);
+        assert (stimc_trace.funcs);
+    }
 
-    uint64_t ltime_h = time.high;
-    uint64_t ltime_l = time.low;
-    uint64_t ltime   = ((ltime_h << 32) | ltime_l);
+    struct stimc_trace_func_s *f = &(stimc_trace.funcs[stimc_trace.funcs_num]);
+    stimc_trace.funcs_num++;
 
-    /* timeunit */
-    int timeunit_raw = vpi_get (vpiTimeUnit, NULL);
+    char symbol[STIMC_TRACE_NAME_MAX];
+    stimc_func_symbol (func, symbol, sizeof (symbol));
 
-    double dtime = ltime;
-    double dunit = timeunit_raw;
+    f->func = func;
+    f->name = stimc_trace_name_copy (symbol);
 
-    dtime *= pow (10, dunit);
+    return f->name;
+}
 
-    return dtime;
+static void stimc_trace_flush (void)
+{
+    if (stimc_trace.len > 0) {
+        fwrite (stimc_trace.buf, 1, stimc_trace.len, stimc_trace.file);
+        stimc_trace.len = 0;
+    }
 }
 
-static inline void stimc_thread_queue_init (struct stimc_thread_queue_s *q)
+/* start new record in buffer: ensure space + separator */
+static void stimc_trace_record_open (void)
 {
-    q->max = 0;
-    q->num = 0;
+    if (stimc_trace.len + STIMC_TRACE_RECORD_MAX > STIMC_TRACE_BUFFER_SIZE) {
+        stimc_trace_flush ();
+    }
 
-    q->threads = NULL;
+    if (!stimc_trace.first) {
+        stimc_trace.buf[stimc_trace.len]     = ',';
+        stimc_trace.buf[stimc_trace.len + 1] = '\n';
+        stimc_trace.len                     += 2;
+    }
+    stimc_trace.first = false;
 }
 
-static void stimc_thread_queue_prepare (struct stimc_thread_queue_s *q, size_t min_len)
+/* formatted record (rare records like metadata) */
+static void stimc_trace_printf (const char *format, ...)
 {
-    if (min_len <= q->max) return;
+    stimc_trace_record_open ();
 
-    if (q->max == 0) {
-        q->max = 16;
-    }
-    while (min_len > q->max) {
-        q->max *= 2;
-        assert (q->max != 0);
-    }
+    va_list ap;
+
+    va_start (ap, format);
+    int len = vsnprintf (&(stimc_trace.buf[stimc_trace.len]), STIMC_TRACE_RECORD_MAX - 2, format, ap);
+    va_end (ap);
 
-    q->threads = (struct stimc_thread_s **)realloc (q->threads, sizeof (struct stimc_thread_s *) * (q->max));
-    assert (q->threads);
+    assert ((len > 0) && (len < STIMC_TRACE_RECORD_MAX - 2));
+    stimc_trace.len += (size_t)len;
 }
 
-static void stimc_thread_queue_free (struct stimc_thread_queue_s *q)
+/* frequent records are assembled directly in the buffer */
+static inline void stimc_trace_put (const char *str, size_t len)
 {
-    q->max = 0;
-    q->num = 0;
-    if (q->threads != NULL) free (q->threads);
+    memcpy (&(stimc_trace.buf[stimc_trace.len]), str, len);
+    stimc_trace.len += len;
+}
 
-    q->threads = NULL;
+#define STIMC_TRACE_PUT_LIT(str) stimc_trace_put ((str), sizeof (str) - 1)
+
+static inline void stimc_trace_put_str (const char *str)
+{
+    stimc_trace_put (str, strlen (str));
 }
 
-static size_t stimc_thread_queue_enqueue (struct stimc_thread_queue_s *q, struct stimc_thread_s *thread)
+static void stimc_trace_put_u64 (uint64_t value)
 {
-    stimc_thread_queue_prepare (q, q->num + 1);
+    char     digits[20];
+    unsigned n = 0;
 
-    size_t result_idx = q->num;
+    do {
+        digits[n] = (char)('0' + (value % 10));
+        value    /= 10;
+        n++;
+    } while (value > 0);
 
-    /* thread data ... */
-    q->threads[q->num] = thread;
-    q->num++;
+    char *buf = &(stimc_trace.buf[stimc_trace.len]);
 
-    return result_idx;
+    for (unsigned i = 0; i < n; i++) {
+        buf[i] = digits[n - 1 - i];
+    }
+    stimc_trace.len += n;
 }
 
-static void stimc_thread_queue_enqueue_all (struct stimc_thread_queue_s *q, struct stimc_thread_queue_s *source)
+/* time in ns as us with 3 decimals */
+static void stimc_trace_put_us (uint64_t ns)
 {
-    stimc_thread_queue_prepare (q, q->num + source->num);
+    stimc_trace_put_u64 (ns / 1000);
 
-    /* thread data ... */
-    for (size_t i = 0; i < source->num; i++) {
-        if (source->threads[i] != NULL) {
-            q->threads[q->num] = source->threads[i];
-            q->num++;
-        }
-    }
+    unsigned frac = (unsigned)(ns % 1000);
+    char    *buf  = &(stimc_trace.buf[stimc_trace.len]);
+
+    buf[0]           = '.';
+    buf[1]           = (char)('0' + (frac / 100));
+    buf[2]           = (char)('0' + ((frac / 10) % 10));
+    buf[3]           = (char)('0' + (frac % 10));
+    stimc_trace.len += 4;
 }
 
-static void stimc_thread_queue_clear (struct stimc_thread_queue_s *q)
+/* record up to time stamp, cat_ph: category and phase members */
+static void stimc_trace_record_begin (const char *name, const char *cat_ph, size_t module, uint64_t tid, uint64_t wall_time)
 {
-    q->num = 0;
+    stimc_trace_record_open ();
+
+    STIMC_TRACE_PUT_LIT ("{\"name\":\"");
+    stimc_trace_put_str (name);
+    STIMC_TRACE_PUT_LIT ("\",");
+    stimc_trace_put_str (cat_ph);
+    STIMC_TRACE_PUT_LIT (",\"pid\":");
+    stimc_trace_put_u64 (module);
+    STIMC_TRACE_PUT_LIT (",\"tid\":");
+    stimc_trace_put_u64 (tid);
+    STIMC_TRACE_PUT_LIT (",\"ts\":");
+    stimc_trace_put_us (wall_time - stimc_trace.start);
 }
 
-static void stimc_main_queue_run_threads ()
+/* process (module) and thread name records, written once per trace */
+static void stimc_trace_module_meta (size_t module)
 {
-    while (!stimc_finish_pending) {
-        if (stimc_main_queue.num == 0) break;
+    if (module == 0) return;
 
-        stimc_thread_queue_enqueue_all (&stimc_main_queue_shadow, &stimc_main_queue);
-        stimc_thread_queue_clear (&stimc_main_queue);
+    struct stimc_trace_module_s *m = &(stimc_trace.modules[module - 1]);
 
-        /* execute threads... */
-        assert (stimc_current_thread == NULL);
+    if (m->session == stimc_trace.session) return;
+    m->session = stimc_trace.session;
 
-        for (size_t i = 0; i < stimc_main_queue_shadow.num; i++) {
-            struct stimc_thread_s *thread = stimc_main_queue_shadow.threads[i];
+    stimc_trace_printf ("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%zu,\"args\":{\"name\":\"%s\"}}", module, m->name);
+    stimc_trace_printf ("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%zu,\"tid\":0,\"args\":{\"name\":\"methods\"}}", module);
+}
 
-            if (thread == NULL) continue;
+static void stimc_trace_thread_meta (struct stimc_thread_s *thread)
+{
+    stimc_trace_module_meta (thread->trace_module);
 
-            stimc_run (thread);
+    if (thread->trace_session == stimc_trace.session) return;
+    thread->trace_session = stimc_trace.session;
 
-            if (stimc_finish_pending) {
-                vpi_control (vpiFinish, 0);
-                break;
-            }
-        }
+    stimc_trace_printf ("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%zu,\"tid\":%" PRIu64 ",\"args\":{\"name\":\"%s #%" PRIu64 "\"}}",
+                        thread->trace_module, thread->trace_id, stimc_trace_func_name (thread->func), thread->trace_id);
+}
 
-        stimc_thread_queue_clear (&stimc_main_queue_shadow);
+static void stimc_trace_context (size_t *module, uint64_t *tid)
+{
+    struct stimc_thread_s *thread = stimc_current_thread;
+
+    if (thread != NULL) {
+        stimc_trace_thread_meta (thread);
+        *module = thread->trace_module;
+        *tid    = thread->trace_id;
+    } else {
+        stimc_trace_module_meta (stimc_trace.module);
+        *module = stimc_trace.module;
+        *tid    = 0;
     }
 }
 
-stimc_event stimc_event_create (void)
+static void stimc_trace_run (struct stimc_thread_s *thread, uint64_t start, uint64_t stop, uint64_t sim_time)
 {
-    stimc_event event = (stimc_event)malloc (sizeof (struct stimc_event_s));
+    stimc_trace_thread_meta (thread);
+
+    bool finished = (thread->state >= STIMC_THREAD_STATE_STOPPED_TO_FINISH);
+
+    stimc_trace_record_begin (stimc_trace_func_name (thread->func), "\"cat\":\"thread\",\"ph\":\"X\"",
+                              thread->trace_module, thread->trace_id, start);
+    STIMC_TRACE_PUT_LIT (",\"dur\":");
+    stimc_trace_put_us (stop - start);
+    STIMC_TRACE_PUT_LIT (",\"args\":{\"sim_time\":");
+    stimc_trace_put_u64 (sim_time);
+    if (finished) {
+        STIMC_TRACE_PUT_LIT (",\"finished\":true}}");
+    } else {
+        STIMC_TRACE_PUT_LIT (",\"finished\":false}}");
+    }
+}
 
-    assert (event);
+static void stimc_trace_method_call (const struct stimc_method_s *m)
+{
+    /* method list might be reallocated by method, m is invalid afterwards */
+    void (*func)(void *data) = m->func;
+    void  *data              = m->data;
+    size_t module            = m->trace_module;
+    size_t module_prev       = stimc_trace.module;
 
-    stimc_thread_queue_init (&event->queue);
+    stimc_trace.module = module;
 
-#ifndef STIMC_DISABLE_CLEANUP
-    /*
-     * Important: Start without cleanup data initialized.
-     *
-     * It is possible to create global events via stimc++ that
-     * lead to stimc_event_create calls at elaboration
-     * time which then triggers stimc_cleanup_init.
-     *
-     * Some simulators see it as an error to register an
-     * end-of-simulation callback during elaboration but
-     * at the same time need stimc module init-code to be present
-     * as otherwise stimc related verilog system tasks are undefined.
-     *
-     * This does not apply to modules or ports as they are
-     * only initialised during simulation time via their
-     * stimc system tasks.
-     */
-    event->cleanup_self = NULL;
-#endif
+    if (!stimc_trace_active ()) {
+        func (data);
+        stimc_trace.module = module_prev;
+        return;
+    }
 
-    return event;
-}
+    uint64_t sim_time = stimc_time_sim ();
+    uint64_t start    = stimc_wall_time ();
 
-static void stimc_event_thread_queue_free (stimc_event event)
-{
-    /* remove handles */
-    for (size_t i = 0; i < event->queue.num; i++) {
-        struct stimc_thread_s *thread = event->queue.threads[i];
+    func (data);
 
-        if (thread == NULL) continue;
+    uint64_t stop = stimc_wall_time ();
 
-        stimc_thread_remove_event_handle (thread, event);
-        if (stimc_thread_has_event_handle (thread)) continue;
+    stimc_trace.module = module_prev;
 
-        /* in case the thread can still be woken up by timeout,
-         * it will be a timeout */
-        if (thread->call_handle != NULL) {
-            thread->timeout = true;
-        }
-    }
+    if (!stimc_trace_active ()) return;
 
-    stimc_thread_queue_free (&event->queue);
+    stimc_trace_module_meta (module);
+
+    stimc_trace_record_begin (stimc_trace_func_name (func), "\"cat\":\"method\",\"ph\":\"X\"", module, 0, start);
+    STIMC_TRACE_PUT_LIT (",\"dur\":");
+    stimc_trace_put_us (stop - start);
+    STIMC_TRACE_PUT_LIT (",\"args\":{\"sim_time\":");
+    stimc_trace_put_u64 (sim_time);
+    STIMC_TRACE_PUT_LIT ("}}");
 }
 
-void stimc_event_free (stimc_event event)
+static void stimc_trace_trigger (stimc_event event)
 {
-    if (event == NULL) return;
-
-    stimc_event_thread_queue_free (event);
+    size_t   module;
+    uint64_t tid;
+
+    stimc_trace_context (&module, &tid);
+
+    stimc_trace_record_begin ("trigger", "\"cat\":\"event\",\"ph\":\"i\",\"s\":\"t\"", module, tid, stimc_wall_time ());
+    STIMC_TRACE_PUT_LIT (",\"args\":{\"sim_time\":");
+    stimc_trace_put_u64 (stimc_time_sim ());
+    STIMC_TRACE_PUT_LIT (",\"event\":");
+    stimc_trace_put_u64 ((uintptr_t)event);
+    STIMC_TRACE_PUT_LIT (",\"waiters\":");
+    stimc_trace_put_u64 (event->queue.num - event->queue.dead);
+    STIMC_TRACE_PUT_LIT (",\"methods\":");
+    stimc_trace_put_u64 (event->methods.num);
+    STIMC_TRACE_PUT_LIT ("}}");
+}
 
-#ifndef STIMC_DISABLE_CLEANUP
-    if (event->cleanup_self != NULL) {
-        event->cleanup_self->cancel = true;
+static void stimc_trace_timer (uint64_t delay, uint64_t time, bool new_slot)
+{
+    size_t   module;
+    uint64_t tid;
+
+    stimc_trace_context (&module, &tid);
+
+    stimc_trace_record_begin ("wait_time", "\"cat\":\"timer\",\"ph\":\"i\",\"s\":\"t\"", module, tid, stimc_wall_time ());
+    STIMC_TRACE_PUT_LIT (",\"args\":{\"sim_time\":");
+    stimc_trace_put_u64 (time - delay);
+    STIMC_TRACE_PUT_LIT (",\"delay\":");
+    stimc_trace_put_u64 (delay);
+    STIMC_TRACE_PUT_LIT (",\"wakeup\":");
+    stimc_trace_put_u64 (time);
+    if (new_slot) {
+        STIMC_TRACE_PUT_LIT (",\"new_slot\":true}}");
+    } else {
+        STIMC_TRACE_PUT_LIT (",\"new_slot\":false}}");
     }
-#endif
-
-    free (event);
 }
 
-stimc_event_combination stimc_event_combination_create (bool any)
+/* +stimc_trace=<file> starts tracing on first module initialization */
+static void stimc_trace_plusarg (void)
 {
-    stimc_event_combination combination = (stimc_event_combination)malloc (sizeof (struct stimc_event_combination_s));
+    static const char plusarg[] = "+stimc_trace=";
 
-    assert (combination);
+    s_vpi_vlog_info info = {0, NULL, NULL, NULL};
 
-    combination->any    = any;
-    combination->max    = 0;
-    combination->num    = 0;
-    combination->events = NULL;
+    if (!vpi_get_vlog_info (&info)) return;
 
-    return combination;
+    for (int i = 0; i < info.argc; i++) {
+        const char *arg = info.argv[i];
+
+        if ((arg != NULL) && (strncmp (arg, plusarg, sizeof (plusarg) - 1) == 0)) {
+            stimc_trace_start (&(arg[sizeof (plusarg) - 1]));
+        }
+    }
 }
 
-void stimc_event_combination_free (stimc_event_combination combination)
+/* trace is completed at end of simulation independent of cleanup */
+static PLI_INT32 stimc_trace_eos_callback (struct t_cb_data *cb_data __attribute__((unused)))
 {
-    if (combination == NULL) return;
+    stimc_trace_stop ();
 
-    if (combination->events != NULL) free (combination->events);
-    free (combination);
+    return 0;
 }
+#endif
 
-static inline void stimc_event_combination_clear (stimc_event_combination combination)
+bool stimc_trace_start (const char *filename)
 {
-    combination->num = 0;
-}
+#ifdef STIMC_TRACE
+    stimc_trace_stop ();
 
-static inline void stimc_event_combination_prepare (stimc_event_combination combination, size_t min_len)
-{
-    if (min_len <= combination->max) return;
+    FILE *f = fopen (filename, "w");
 
-    if (combination->max == 0) {
-        combination->max = 4;
-    }
-    while (min_len > combination->max) {
-        combination->max *= 2;
-        assert (combination->max != 0);
+    if (f == NULL) {
+        vpi_printf ("stimc: could not open trace file \"%s\"\n", filename);
+        return false;
     }
 
-    combination->events = (struct stimc_event_handle_s *)realloc (combination->events, sizeof (struct stimc_event_handle_s) * (combination->max));
-    assert (combination->events);
+    stimc_trace.buf = (char *)malloc (STIMC_TRACE_BUFFER_SIZE);
+    assert (stimc_trace.buf);
+
+    stimc_trace.file  = f;
+    stimc_trace.len   = 0;
+    stimc_trace.first = true;
+    stimc_trace.start = stimc_wall_time ();
+    stimc_trace.session++;
+
+    fputs ("[\n", f);
+
+    stimc_trace_printf ("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"stimc\"}}");
+    stimc_trace_printf ("{\"name\":\"process_labels\",\"ph\":\"M\",\"pid\":0,\"args\":{\"labels\":\"sim_time unit: 1e%d s\"}}",
+                        (int)vpi_get (vpiTimePrecision, NULL));
+
+#ifndef STIMC_DISABLE_CLEANUP
+    /* cleanup callback first: threads finished by cleanup are still traced */
+    stimc_cleanup_init ();
+#endif
+
+    s_cb_data data;
+
+    data.reason    = cbEndOfSimulation;
+    data.cb_rtn    = stimc_trace_eos_callback;
+    data.obj       = NULL;
+    data.time      = NULL;
+    data.value     = NULL;
+    data.index     = 0;
+    data.user_data = NULL;
+
+    stimc_trace.eos_cb = stimc_vpi_register_cb (&data);
+
+    return true;
+#else
+    (void)filename;
+    vpi_printf ("stimc trace not available (build with TRACE enabled)\n");
+    return false;
+#endif
 }
 
-static void stimc_event_combination_append_handle (stimc_event_combination combination, stimc_event event, size_t idx)
+void stimc_trace_stop (void)
 {
-    assert (combination);
-    stimc_event_combination_prepare (combination, combination->num + 1);
+#ifdef STIMC_TRACE
+    if (!stimc_trace_active ()) return;
 
-    combination->events[combination->num] = (struct stimc_event_handle_s) {
-        .event = event,
-        .idx   = idx
-    };
+    if (stimc_trace.eos_cb != NULL) {
+        stimc_vpi_remove_cb (stimc_trace.eos_cb);
+        stimc_trace.eos_cb = NULL;
+    }
 
-    combination->num++;
+    stimc_trace_flush ();
+    fputs ("\n]\n", stimc_trace.file);
+    fclose (stimc_trace.file);
+    free (stimc_trace.buf);
+
+    stimc_trace.file = NULL;
+    stimc_trace.buf  = NULL;
+#endif
 }
 
-void stimc_event_combination_append (stimc_event_combination combination, stimc_event event)
+#ifndef STIMC_DISABLE_CLEANUP
+static void stimc_trace_free (void)
 {
-    stimc_event_combination_append_handle (combination, event, 0);
+#ifdef STIMC_TRACE
+    /* handle is dropped if callbacks are not removed on cleanup */
+    if (!stimc_get_vlog_product_data ()->remove_callbacks) stimc_trace.eos_cb = NULL;
+    stimc_trace_stop ();
+
+    for (size_t i = 0; i < stimc_trace.modules_num; i++) {
+        free (stimc_trace.modules[i].name);
+    }
+    if (stimc_trace.modules != NULL) free (stimc_trace.modules);
+    stimc_trace.modules     = NULL;
+    stimc_trace.modules_num = 0;
+    stimc_trace.modules_max = 0;
+
+    for (size_t i = 0; i < stimc_trace.funcs_num; i++) {
+        free (stimc_trace.funcs[i].name);
+    }
+    if (stimc_trace.funcs != NULL) free (stimc_trace.funcs);
+    stimc_trace.funcs     = NULL;
+    stimc_trace.funcs_num = 0;
+    stimc_trace.funcs_max = 0;
+
+    stimc_trace.module = 0;
+#endif
 }
+#endif
 
-void stimc_event_combination_copy (stimc_event_combination dst, stimc_event_combination src)
+static void stimc_thread_finish (struct stimc_thread_s *thread)
 {
-    assert (dst);
-    stimc_event_combination_clear (dst);
-    if (src == NULL) return;
+    assert (thread);
 
-    stimc_event_combination_prepare (dst, src->max);
-    dst->any = src->any;
-    dst->num = src->num;
+#ifndef STIMC_DISABLE_CLEANUP
+    thread->cleanup_self->cancel = true;
+#endif
 
-    for (size_t i = 0; i < src->num; i++) {
-        dst->events[i] = src->events[i];
+    /* final resume ? */
+    bool final_resume = false;
+    if (thread->resume_on_finish
+        && thread->state > STIMC_THREAD_STATE_CREATED
+        && thread->state < STIMC_THREAD_STATE_FINISHED) {
+        final_resume = true;
+    }
+
+    thread->state = STIMC_THREAD_STATE_CLEANUP;
+
+    if (final_resume) {
+        stimc_run (thread);
+    }
+
+    /* remove resume callbacks */
+    if (thread->timer != NULL) {
+        stimc_timer_remove_thread (thread);
     }
+    for (size_t i = 0; i < thread->event_combination->num; i++) {
+        struct stimc_event_handle_s *h = &(thread->event_combination->events[i]);
+        stimc_event_remove_thread (h->event, h->idx);
+        h->event = NULL;
+    }
+
+#ifndef STIMC_DISABLE_CLEANUP
+    stimc_cleanup_run (&(thread->cleanup_queue));
+#endif
+
+    /* stackless thread: release its data (e.g. coroutine frame) */
+    if (thread->stackless && (thread->freefunc != NULL)) {
+        thread->freefunc (thread->data);
+    }
+
+    stimc_thread_impl ti = thread->thread;
+#ifdef STIMC_THREAD_STACK_WATERMARK
+    if (ti != NULL) stimc_thread_stack_usage_add (thread->func, ti);
+#endif
+    stimc_event_combination_free (thread->event_combination);
+    stimc_slab_free (&stimc_thread_slab, thread);
+    if (ti != NULL) stimc_thread_impl_delete (ti);
 }
 
-static inline void stimc_event_remove_thread (stimc_event event, size_t queue_idx)
+static void stimc_thread_remove_event_handle (struct stimc_thread_s *thread, size_t handle_idx)
 {
-    assert (event);
-    assert (event->queue.num > queue_idx);
+    stimc_event_combination combination = thread->event_combination;
+
+    assert (handle_idx < combination->num);
+
+    size_t idx_last = combination->num - 1;
 
-    event->queue.threads[queue_idx] = NULL;
+    if (handle_idx != idx_last) {
+        /* move last handle + update back reference of its event queue entry */
+        struct stimc_event_handle_s *h = &(combination->events[handle_idx]);
+
+        *h = combination->events[idx_last];
+        h->event->queue.entries[h->idx].ref = handle_idx;
+    }
+
+    combination->num--;
 }
 
-static inline void stimc_event_enqueue_thread (stimc_event event, struct stimc_thread_s *thread)
+static inline bool stimc_thread_has_event_handle (struct stimc_thread_s *thread)
 {
-#ifndef STIMC_DISABLE_CLEANUP
-    if (event->cleanup_self == NULL) {
-        event->cleanup_self = stimc_cleanup_add (stimc_cleanup_event, event);
+    return (thread->event_combination->num > 0);
+}
+
+static void stimc_thread_wrap (STIMC_THREAD_ARG_DEF)
+{
+    struct stimc_thread_s *thread = stimc_current_thread;
+
+    assert (thread);
+
+    thread->state = STIMC_THREAD_STATE_RUNNING;
+    thread->func (thread->data);
+
+    if (thread->state < STIMC_THREAD_STATE_FINISHED) {
+        thread->state = STIMC_THREAD_STATE_FINISHED;
+    }
+    stimc_suspend ();
+}
+
+void stimc_register_startup_thread (void (*threadfunc)(void *userdata), void *userdata, size_t stacksize)
+{
+    stimc_spawn_thread (threadfunc, userdata, stacksize);
+}
+
+void stimc_spawn_thread (void (*threadfunc)(void *userdata), void *userdata, size_t stacksize)
+{
+    struct stimc_thread_s *thread = stimc_thread_create (threadfunc, userdata, stacksize);
+
+    assert (thread);
+
+    stimc_thread_queue_enqueue (&stimc_main_queue, thread);
+}
+
+void stimc_spawn_stackless_thread (void (*resumefunc)(void *userdata), void (*freefunc)(void *userdata), void *userdata)
+{
+    struct stimc_thread_s *thread = stimc_thread_alloc (resumefunc, userdata);
+
+    thread->freefunc  = freefunc;
+    thread->stackless = true;
+
+    stimc_thread_queue_enqueue (&stimc_main_queue, thread);
+}
+
+static inline void stimc_run (struct stimc_thread_s *thread)
+{
+#ifdef STIMC_PROFILE
+    uint64_t                   profile_start   = stimc_wall_time ();
+    enum stimc_profile_section profile_section = stimc_profile_switch (STIMC_PROFILE_THREAD, profile_start);
+#endif
+#ifdef STIMC_TRACE
+    bool     trace       = stimc_trace_active ();
+    uint64_t trace_sim   = trace ? stimc_time_sim () : 0;
+    uint64_t trace_start = trace ? stimc_wall_time () : 0;
+#endif
+
+    stimc_current_thread = thread;
+
+    if (thread->stackless) {
+        /* no context switch: resume function returns on suspension */
+        if (thread->state == STIMC_THREAD_STATE_CREATED) {
+            thread->state = STIMC_THREAD_STATE_RUNNING;
+        }
+        thread->func (thread->data);
+    } else {
+        stimc_thread_fence ();
+        stimc_thread_impl_run (thread->thread);
+        stimc_thread_fence ();
+    }
+
+    stimc_current_thread = NULL;
+
+#ifdef STIMC_TRACE
+    if (trace && stimc_trace_active ()) {
+        stimc_trace_run (thread, trace_start, stimc_wall_time (), trace_sim);
     }
 #endif
+#ifdef STIMC_PROFILE
+    uint64_t profile_stop = stimc_wall_time ();
+    stimc_profile_switch (profile_section, profile_stop);
 
-    size_t event_idx = stimc_thread_queue_enqueue (&event->queue, thread);
+    struct stimc_profile_func_s *pf = &(stimc_profile.funcs[thread->profile_idx]);
+    pf->resumes++;
+    pf->time += profile_stop - profile_start;
+#endif
 
-    stimc_event_combination_append_handle (thread->event_combination, event, event_idx);
+    if (thread->state >= STIMC_THREAD_STATE_STOPPED_TO_FINISH
+        && thread->state < STIMC_THREAD_STATE_CLEANUP) {
+        stimc_thread_finish (thread);
+    }
 }
 
-static void stimc_event_combination_enqueue_thread (struct stimc_thread_s *thread, stimc_event_combination combination, bool consume)
+static inline void stimc_suspend (void)
 {
-    assert (combination);
+    /* stackless threads only schedule their wakeup
+     * and return from their resume function afterwards */
+    if (stimc_current_thread->stackless) return;
 
-    stimc_event_combination_prepare (thread->event_combination, combination->max);
-    stimc_event_combination_clear (thread->event_combination);
+    stimc_thread_fence ();
+    stimc_thread_impl_suspend ();
+    stimc_thread_fence ();
+}
 
-    thread->event_combination->any = combination->any;
+static inline void stimc_time_data_init (void)
+{
+    if (stimc_time_data.valid) return;
 
-    for (size_t i = 0; i < combination->num; i++) {
-        stimc_event_enqueue_thread (combination->events[i].event, thread);
+    int unit = vpi_get (vpiTimeUnit, NULL);
+
+    assert ((unit < 0 ? -unit : unit) < STIMC_POW10_NUM);
+
+    stimc_time_data.unit = unit;
+    if (unit < 0) {
+        stimc_time_data.scale     = 1.0 / stimc_pow10_double[-unit];
+        stimc_time_data.scale_inv = stimc_pow10_double[-unit];
+    } else {
+        stimc_time_data.scale     = stimc_pow10_double[unit];
+        stimc_time_data.scale_inv = 1.0 / stimc_pow10_double[unit];
     }
+    stimc_time_data.valid = true;
+}
 
-    if (consume) stimc_event_combination_free (combination);
+/* scale time by power of ten, saturating at UINT64_MAX on overflow */
+static inline uint64_t stimc_time_scale (uint64_t time, int shift)
+{
+    if (shift == 0) return time;
+
+    if (shift > 0) {
+        /* overflow */
+        if (time == 0) return 0;
+        if ((shift >= STIMC_POW10_NUM) || (time > UINT64_MAX / stimc_pow10_uint64[shift])) {
+            return UINT64_MAX;
+        }
+
+        return time * stimc_pow10_uint64[shift];
+    }
+
+    /* underflow */
+    if (-shift >= STIMC_POW10_NUM) return 0;
+
+    return time / stimc_pow10_uint64[-shift];
 }
 
-void stimc_wait_event (stimc_event event)
+static inline uint64_t stimc_time_sim (void)
 {
-    struct stimc_thread_s *thread = stimc_current_thread;
+    s_vpi_time time;
 
-    assert (thread);
+    time.type = vpiSimTime;
+    vpi_get_time (NULL, &time);
 
-    stimc_event_combination_clear (thread->event_combination);
-    stimc_event_enqueue_thread (event, thread);
+    uint64_t ltime_h = time.high;
+    uint64_t ltime_l = time.low;
 
-    /* thread handling ... */
-    stimc_suspend ();
+    return ((ltime_h << 32) | ltime_l);
 }
 
-void stimc_wait_event_combination (const stimc_event_combination combination, bool consume)
+static void stimc_wait_time_int_exp (uint64_t time, int exp)
 {
+    /* thread data ... */
     struct stimc_thread_s *thread = stimc_current_thread;
 
     assert (thread);
 
-    stimc_event_combination_enqueue_thread (thread, combination, consume);
+    /* time ... */
+    stimc_time_data_init ();
+    uint64_t ltime = stimc_time_scale (time, exp - stimc_time_data.unit);
+    if (ltime == UINT64_MAX) {
+        vpi_printf ("stimc: wait time overflow, clamped to maximum simulation time\n");
+    }
+
+    /* add to timer slot ... */
+    stimc_timer_enqueue_thread (thread, ltime);
 
     /* thread handling ... */
     stimc_suspend ();
 }
 
-bool stimc_wait_event_timeout (stimc_event event, uint64_t time, enum stimc_time_unit exp)
+void stimc_wait_time (uint64_t time, enum stimc_time_unit exp)
 {
-    struct stimc_thread_s *thread = stimc_current_thread;
+    stimc_wait_time_int_exp (time, (int)exp);
+}
 
-    assert (thread);
+void stimc_wait_time_seconds (double time)
+{
+    /* time ... */
+    stimc_time_data_init ();
 
-    thread->timeout = false;
-    stimc_event_enqueue_thread (event, thread);
+    time *= stimc_time_data.scale_inv;
 
-    stimc_wait_time (time, exp);
+    /* overflow / negative time */
+    uint64_t ltime;
+    if (!(time >= 0.0)) {
+        vpi_printf ("stimc: invalid wait time %g s, waiting for 0 s instead\n", time * stimc_time_data.scale);
+        ltime = 0;
+    } else if (time < 18446744073709551616.0) {
+        ltime = time;
+    } else {
+        ltime = UINT64_MAX;
+    }
 
-    return (thread->timeout);
+    stimc_wait_time_int_exp (ltime, stimc_time_data.unit);
 }
 
-bool stimc_wait_event_timeout_seconds (stimc_event event, double time)
+uint64_t stimc_time (enum stimc_time_unit exp)
 {
-    struct stimc_thread_s *thread = stimc_current_thread;
+    stimc_time_data_init ();
 
-    assert (thread);
+    return stimc_time_scale (stimc_time_sim (), stimc_time_data.unit - (int)exp);
+}
 
-    thread->timeout = false;
-    stimc_event_enqueue_thread (event, thread);
+double stimc_time_seconds (void)
+{
+    stimc_time_data_init ();
 
-    stimc_wait_time_seconds (time);
+    return (double)stimc_time_sim () * stimc_time_data.scale;
+}
 
-    return (thread->timeout);
+static inline void stimc_thread_queue_init (struct stimc_thread_queue_s *q)
+{
+    q->max  = 0;
+    q->num  = 0;
+    q->dead = 0;
+
+    q->entries = NULL;
 }
 
-bool stimc_wait_event_combination_timeout (const stimc_event_combination combination, bool consume, uint64_t time, enum stimc_time_unit exp)
+static void stimc_thread_queue_prepare (struct stimc_thread_queue_s *q, size_t min_len)
 {
-    struct stimc_thread_s *thread = stimc_current_thread;
+    if (min_len <= q->max) return;
 
-    assert (thread);
+    if (q->max == 0) {
+        q->max = 16;
+    }
+    while (min_len > q->max) {
+        q->max *= 2;
+        assert (q->max != 0);
+    }
 
-    thread->timeout = false;
-    stimc_event_combination_enqueue_thread (thread, combination, consume);
+    q->entries = (struct stimc_thread_queue_entry_s *)realloc (q->entries, sizeof (struct stimc_thread_queue_entry_s) * (q->max));
+    assert (q->entries);
+}
 
-    stimc_wait_time (time, exp);
+static void stimc_thread_queue_free (struct stimc_thread_queue_s *q)
+{
+    q->max  = 0;
+    q->num  = 0;
+    q->dead = 0;
+    if (q->entries != NULL) free (q->entries);
 
-    return (thread->timeout);
+    q->entries = NULL;
 }
 
-bool stimc_wait_event_combination_timeout_seconds (const stimc_event_combination combination, bool consume, double time)
+static size_t stimc_thread_queue_enqueue (struct stimc_thread_queue_s *q, struct stimc_thread_s *thread)
 {
-    struct stimc_thread_s *thread = stimc_current_thread;
+    stimc_thread_queue_prepare (q, q->num + 1);
 
-    assert (thread);
+    size_t result_idx = q->num;
 
-    thread->timeout = false;
-    stimc_event_combination_enqueue_thread (thread, combination, consume);
+    /* thread data ... */
+    q->entries[q->num].thread = thread;
+    q->entries[q->num].ref    = 0;
+    q->num++;
+
+    return result_idx;
+}
+
+static void stimc_thread_queue_enqueue_all (struct stimc_thread_queue_s *q, struct stimc_thread_queue_s *source)
+{
+    stimc_thread_queue_prepare (q, q->num + source->num);
+
+    /* thread data ... */
+    for (size_t i = 0; i < source->num; i++) {
+        if (source->entries[i].thread != NULL) {
+            q->entries[q->num] = source->entries[i];
+            q->num++;
+        }
+    }
+}
+
+static void stimc_thread_queue_clear (struct stimc_thread_queue_s *q)
+{
+    q->num  = 0;
+    q->dead = 0;
+}
+
+static void stimc_main_queue_run_threads ()
+{
+#ifdef STIMC_PROFILE
+    stimc_profile_run_start ();
+#endif
+
+    while (!stimc_finish_pending) {
+        if (stimc_main_queue.num == 0) break;
+
+#ifdef STIMC_PROFILE
+        stimc_profile_run_iteration ();
+#endif
+
+        stimc_thread_queue_enqueue_all (&stimc_main_queue_shadow, &stimc_main_queue);
+        stimc_thread_queue_clear (&stimc_main_queue);
+
+        /* execute threads... */
+        assert (stimc_current_thread == NULL);
+
+        for (size_t i = 0; i < stimc_main_queue_shadow.num; i++) {
+            struct stimc_thread_s *thread = stimc_main_queue_shadow.entries[i].thread;
+
+            if (thread == NULL) continue;
+
+            stimc_run (thread);
+
+            if (stimc_finish_pending) {
+                vpi_control (vpiFinish, 0);
+                break;
+            }
+        }
+
+        stimc_thread_queue_clear (&stimc_main_queue_shadow);
+    }
+}
+
+static inline size_t stimc_timer_hash (uint64_t time, size_t max)
+{
+    /* fibonacci hashing - max is a power of 2 */
+    return (size_t)((time * UINT64_C (0x9e3779b97f4a7c15)) >> 32) & (max - 1);
+}
+
+static struct stimc_timer_s *stimc_timer_get (uint64_t time, uint64_t delay)
+{
+    /* existing slot? */
+    if (stimc_timers.max > 0) {
+        for (struct stimc_timer_s *t = stimc_timers.buckets[stimc_timer_hash (time, stimc_timers.max)]; t != NULL; t = t->next) {
+            if (t->time == time) return t;
+        }
+    }
+
+    /* grow table */
+    if (stimc_timers.num >= stimc_timers.max) {
+        size_t                 max_new     = (stimc_timers.max == 0) ? 16 : (2 * stimc_timers.max);
+        struct stimc_timer_s **buckets_new = (struct stimc_timer_s **)calloc (max_new, sizeof (struct stimc_timer_s *));
+
+        assert (buckets_new);
+
+        for (size_t i = 0; i < stimc_timers.max; i++) {
+            while (stimc_timers.buckets[i] != NULL) {
+                struct stimc_timer_s *t = stimc_timers.buckets[i];
+                stimc_timers.buckets[i] = t->next;
+
+                size_t h = stimc_timer_hash (t->time, max_new);
+                t->next        = buckets_new[h];
+                buckets_new[h] = t;
+            }
+        }
+
+        if (stimc_timers.buckets != NULL) free (stimc_timers.buckets);
+        stimc_timers.buckets = buckets_new;
+        stimc_timers.max     = max_new;
+    }
+
+    /* new slot */
+    struct stimc_timer_s *timer = (struct stimc_timer_s *)stimc_slab_alloc (&stimc_timer_slab);
+
+    assert (timer);
+
+    timer->time   = time;
+    timer->active = 0;
+    stimc_thread_queue_init (&timer->queue);
+
+    size_t h = stimc_timer_hash (time, stimc_timers.max);
+    timer->next             = stimc_timers.buckets[h];
+    stimc_timers.buckets[h] = timer;
+    stimc_timers.num++;
+
+    /* add callback ... */
+    s_cb_data   data;
+    s_vpi_time  data_time;
+    s_vpi_value data_value;
+
+    data.reason        = cbAfterDelay;
+    data.cb_rtn        = stimc_timer_callback;
+    data.obj           = NULL;
+    data.time          = &data_time;
+    data.time->type    = vpiSimTime;
+    data.time->high    = delay >> 32;
+    data.time->low     = delay & 0xffffffff;
+    data.time->real    = delay;
+    data.value         = &data_value;
+    data.value->format = vpiSuppressVal;
+    data.index         = 0;
+    data.user_data     = (PLI_BYTE8 *)timer;
+
+    timer->cb_handle = stimc_vpi_register_cb (&data);
+
+    assert (timer->cb_handle);
+
+    return timer;
+}
+
+static void stimc_timer_unlink (struct stimc_timer_s *timer)
+{
+    struct stimc_timer_s **t = &(stimc_timers.buckets[stimc_timer_hash (timer->time, stimc_timers.max)]);
+
+    while (*t != timer) {
+        assert (*t);
+        t = &((*t)->next);
+    }
+
+    *t = timer->next;
+    stimc_timers.num--;
+}
+
+static void stimc_timer_enqueue_thread (struct stimc_thread_s *thread, uint64_t delay)
+{
+    uint64_t now = stimc_time_sim ();
+
+    /* saturate at maximum simulation time */
+    if (delay > UINT64_MAX - now) delay = UINT64_MAX - now;
+
+    uint64_t time = now + delay;
+
+    struct stimc_timer_s *timer = stimc_timer_get (time, delay);
+
+#ifdef STIMC_TRACE
+    if (stimc_trace_active ()) stimc_trace_timer (delay, time, (timer->active == 0));
+#endif
+
+    thread->timer     = timer;
+    thread->timer_idx = stimc_thread_queue_enqueue (&timer->queue, thread);
+    timer->active++;
+}
+
+static void stimc_timer_remove_thread (struct stimc_thread_s *thread)
+{
+    struct stimc_timer_s *timer = thread->timer;
+
+    assert (timer);
+    assert (timer->queue.entries[thread->timer_idx].thread == thread);
+
+    timer->queue.entries[thread->timer_idx].thread = NULL;
+    timer->queue.dead++;
+    thread->timer = NULL;
+
+    /* last thread in slot -> slot no longer needed */
+    timer->active--;
+    if (timer->active == 0) {
+        stimc_vpi_remove_cb (timer->cb_handle);
+        stimc_timer_unlink (timer);
+        stimc_thread_queue_free (&timer->queue);
+        stimc_slab_free (&stimc_timer_slab, timer);
+    }
+}
+
+static PLI_INT32 stimc_timer_callback (struct t_cb_data *cb_data)
+{
+    struct stimc_timer_s *timer = (struct stimc_timer_s *)cb_data->user_data;
+
+    assert (timer);
+
+    STIMC_PROFILE_ENTER (STIMC_PROFILE_STIMC);
+    STIMC_PROFILE_COUNT (cb_executed, 1);
+
+    stimc_vpi_remove_cb (timer->cb_handle);
+    timer->cb_handle = NULL;
+    stimc_timer_unlink (timer);
+
+    for (size_t i = 0; i < timer->queue.num; i++) {
+        struct stimc_thread_s *thread = timer->queue.entries[i].thread;
+
+        if (thread == NULL) continue;
+
+        thread->timer = NULL;
+
+        stimc_thread_queue_enqueue (&stimc_main_queue, thread);
+
+        for (size_t j = 0; j < thread->event_combination->num; j++) {
+            struct stimc_event_handle_s *h = &(thread->event_combination->events[j]);
+            stimc_event_remove_thread (h->event, h->idx);
+            /* if event handle exists, this has to be a timeout callback */
+            thread->timeout = true;
+        }
+        stimc_event_combination_clear (thread->event_combination);
+    }
+
+    stimc_thread_queue_free (&timer->queue);
+    stimc_slab_free (&stimc_timer_slab, timer);
+
+    stimc_main_queue_run_threads ();
+
+    STIMC_PROFILE_LEAVE ();
+
+    return 0;
+}
+
+static inline void stimc_method_list_init (struct stimc_method_list_s *l)
+{
+    l->max     = 0;
+    l->num     = 0;
+    l->methods = NULL;
+}
+
+static void stimc_method_list_append (struct stimc_method_list_s *l, void (*methodfunc)(void *userdata), void *userdata)
+{
+    if (l->num >= l->max) {
+        l->max     = (l->max == 0) ? 4 : (2 * l->max);
+        l->methods = (struct stimc_method_s *)realloc (l->methods, sizeof (struct stimc_method_s) * (l->max));
+        assert (l->methods);
+    }
+
+    l->methods[l->num].func = methodfunc;
+    l->methods[l->num].data = userdata;
+#ifdef STIMC_TRACE
+    l->methods[l->num].trace_module = (stimc_current_thread != NULL) ? stimc_current_thread->trace_module : stimc_trace.module;
+#endif
+    l->num++;
+}
+
+static void stimc_method_list_free (struct stimc_method_list_s *l)
+{
+    if (l->methods != NULL) free (l->methods);
+
+    stimc_method_list_init (l);
+}
+
+static void stimc_method_list_call (struct stimc_method_list_s *l)
+{
+    /* methods are not part of a thread (e.g. cannot wait) - also when called from a thread */
+    struct stimc_thread_s *thread = stimc_current_thread;
+
+    stimc_current_thread = NULL;
+
+    STIMC_PROFILE_ENTER (STIMC_PROFILE_METHOD);
+
+    /* list might be extended by methods */
+    for (size_t i = 0; i < l->num; i++) {
+        struct stimc_method_s *m = &(l->methods[i]);
+#ifdef STIMC_TRACE
+        stimc_trace_method_call (m);
+#else
+        m->func (m->data);
+#endif
+    }
+
+    STIMC_PROFILE_COUNT (methods_called, l->num);
+    STIMC_PROFILE_LEAVE ();
+
+    stimc_current_thread = thread;
+}
+
+stimc_event stimc_event_create (void)
+{
+    stimc_event event = (stimc_event)stimc_slab_alloc (&stimc_event_slab);
+
+    assert (event);
+
+    stimc_thread_queue_init (&event->queue);
+    stimc_method_list_init (&event->methods);
+    event->dispatch     = 0;
+    event->free_pending = false;
+
+#ifndef STIMC_DISABLE_CLEANUP
+    /*
+     * Important: Start without cleanup data initialized.
+     *
+     * It is possible to create global events via stimc++ that
+     * lead to stimc_event_create calls at elaboration
+     * time which then triggers stimc_cleanup_init.
+     *
+     * Some simulators see it as an error to register an
+     * end-of-simulation callback during elaboration but
+     * at the same time need stimc module init-code to be present
+     * as otherwise stimc related verilog system tasks are undefined.
+     *
+     * This does not apply to modules or ports as they are
+     * only initialised during simulation time via their
+     * stimc system tasks.
+     */
+    event->cleanup_self = NULL;
+#endif
+
+    return event;
+}
+
+static void stimc_event_thread_queue_free (stimc_event event)
+{
+    /* remove handles */
+    for (size_t i = 0; i < event->queue.num; i++) {
+        struct stimc_thread_s *thread = event->queue.entries[i].thread;
+
+        if (thread == NULL) continue;
+
+        stimc_thread_remove_event_handle (thread, event->queue.entries[i].ref);
+        if (stimc_thread_has_event_handle (thread)) continue;
+
+        /* in case the thread can still be woken up by timeout,
+         * it will be a timeout */
+        if (thread->timer != NULL) {
+            thread->timeout = true;
+        }
+    }
+
+    stimc_thread_queue_free (&event->queue);
+    stimc_method_list_free (&event->methods);
+}
+
+static void stimc_event_release (stimc_event event)
+{
+    stimc_event_thread_queue_free (event);
+
+#ifndef STIMC_DISABLE_CLEANUP
+    if (event->cleanup_self != NULL) {
+        event->cleanup_self->cancel = true;
+    }
+#endif
+
+    stimc_slab_free (&stimc_event_slab, event);
+}
+
+void stimc_event_free (stimc_event event)
+{
+    if (event == NULL) return;
+
+    /* freed from one of its own methods:
+     * skip remaining methods, release after dispatch */
+    if (event->dispatch > 0) {
+        event->free_pending = true;
+        event->methods.num  = 0;
+        return;
+    }
+
+    stimc_event_release (event);
+}
+
+stimc_event_combination stimc_event_combination_create (bool any)
+{
+    stimc_event_combination combination = (stimc_event_combination)stimc_slab_alloc (&stimc_combination_slab);
+
+    assert (combination);
+
+    combination->any    = any;
+    combination->max    = 0;
+    combination->num    = 0;
+    combination->events = NULL;
+
+    return combination;
+}
+
+void stimc_event_combination_free (stimc_event_combination combination)
+{
+    if (combination == NULL) return;
+
+    if (combination->events != NULL) free (combination->events);
+    stimc_slab_free (&stimc_combination_slab, combination);
+}
+
+static inline void stimc_event_combination_clear (stimc_event_combination combination)
+{
+    combination->num = 0;
+}
+
+static inline void stimc_event_combination_prepare (stimc_event_combination combination, size_t min_len)
+{
+    if (min_len <= combination->max) return;
+
+    if (combination->max == 0) {
+        combination->max = 4;
+    }
+    while (min_len > combination->max) {
+        combination->max *= 2;
+        assert (combination->max != 0);
+    }
+
+    combination->events = (struct stimc_event_handle_s *)realloc (combination->events, sizeof (struct stimc_event_handle_s) * (combination->max));
+    assert (combination->events);
+}
+
+static void stimc_event_combination_append_handle (stimc_event_combination combination, stimc_event event, size_t idx)
+{
+    assert (combination);
+    stimc_event_combination_prepare (combination, combination->num + 1);
+
+    combination->events[combination->num] = (struct stimc_event_handle_s) {
+        .event = event,
+        .idx   = idx
+    };
+
+    combination->num++;
+}
+
+void stimc_event_combination_append (stimc_event_combination combination, stimc_event event)
+{
+    stimc_event_combination_append_handle (combination, event, 0);
+}
+
+void stimc_event_combination_copy (stimc_event_combination dst, stimc_event_combination src)
+{
+    assert (dst);
+    stimc_event_combination_clear (dst);
+    if (src == NULL) return;
+
+    stimc_event_combination_prepare (dst, src->max);
+    dst->any = src->any;
+    dst->num = src->num;
+
+    for (size_t i = 0; i < src->num; i++) {
+        dst->events[i] = src->events[i];
+    }
+}
+
+static inline void stimc_event_remove_thread (stimc_event event, size_t queue_idx)
+{
+    assert (event);
+    assert (event->queue.num > queue_idx);
+
+    event->queue.entries[queue_idx].thread = NULL;
+    event->queue.dead++;
+}
+
+static void stimc_event_queue_compact (stimc_event event)
+{
+    struct stimc_thread_queue_s *q = &event->queue;
+
+    /* only waiters removed -> just clear */
+    if (q->dead == q->num) {
+        stimc_thread_queue_clear (q);
+        return;
+    }
+
+    /* keep order of remaining waiters, update their handles */
+    size_t n = 0;
+
+    for (size_t i = 0; i < q->num; i++) {
+        struct stimc_thread_queue_entry_s *e = &(q->entries[i]);
+
+        if (e->thread == NULL) continue;
+
+        if (i != n) {
+            q->entries[n] = *e;
+            q->entries[n].thread->event_combination->events[q->entries[n].ref].idx = n;
+        }
+        n++;
+    }
+
+    q->num  = n;
+    q->dead = 0;
+}
+
+static inline void stimc_event_enqueue_thread (stimc_event event, struct stimc_thread_s *thread)
+{
+#ifndef STIMC_DISABLE_CLEANUP
+    if (event->cleanup_self == NULL) {
+        event->cleanup_self = stimc_cleanup_add (stimc_cleanup_event, event);
+    }
+#endif
+
+    /* too many removed waiters (e.g. timeouts)? -> compact queue before it grows
+     * (not possible while the queue is iterated by trigger/free,
+     *  but those never enqueue) */
+    if ((event->queue.dead > 0) && (2 * event->queue.dead >= event->queue.num)) {
+        stimc_event_queue_compact (event);
+    }
+
+    size_t event_idx = stimc_thread_queue_enqueue (&event->queue, thread);
+
+    event->queue.entries[event_idx].ref = thread->event_combination->num;
+    stimc_event_combination_append_handle (thread->event_combination, event, event_idx);
+}
+
+static void stimc_event_combination_enqueue_thread (struct stimc_thread_s *thread, stimc_event_combination combination, bool consume)
+{
+    assert (combination);
+
+    stimc_event_combination_prepare (thread->event_combination, combination->max);
+    stimc_event_combination_clear (thread->event_combination);
+
+    thread->event_combination->any = combination->any;
+
+    for (size_t i = 0; i < combination->num; i++) {
+        stimc_event_enqueue_thread (combination->events[i].event, thread);
+    }
+
+    if (consume) stimc_event_combination_free (combination);
+}
+
+void stimc_wait_event (stimc_event event)
+{
+    struct stimc_thread_s *thread = stimc_current_thread;
+
+    assert (thread);
+
+    stimc_event_combination_clear (thread->event_combination);
+    stimc_event_enqueue_thread (event, thread);
+
+    /* thread handling ... */
+    stimc_suspend ();
+}
+
+void stimc_wait_event_combination (const stimc_event_combination combination, bool consume)
+{
+    struct stimc_thread_s *thread = stimc_current_thread;
+
+    assert (thread);
+
+    stimc_event_combination_enqueue_thread (thread, combination, consume);
+
+    /* thread handling ... */
+    stimc_suspend ();
+}
+
+bool stimc_wait_event_timeout (stimc_event event, uint64_t time, enum stimc_time_unit exp)
+{
+    struct stimc_thread_s *thread = stimc_current_thread;
+
+    assert (thread);
+
+    thread->timeout = false;
+    stimc_event_enqueue_thread (event, thread);
+
+    stimc_wait_time (time, exp);
+
+    return (thread->timeout);
+}
+
+bool stimc_wait_event_timeout_seconds (stimc_event event, double time)
+{
+    struct stimc_thread_s *thread = stimc_current_thread;
+
+    assert (thread);
+
+    thread->timeout = false;
+    stimc_event_enqueue_thread (event, thread);
+
+    stimc_wait_time_seconds (time);
+
+    return (thread->timeout);
+}
+
+bool stimc_wait_event_combination_timeout (const stimc_event_combination combination, bool consume, uint64_t time, enum stimc_time_unit exp)
+{
+    struct stimc_thread_s *thread = stimc_current_thread;
+
+    assert (thread);
+
+    thread->timeout = false;
+    stimc_event_combination_enqueue_thread (thread, combination, consume);
+
+    stimc_wait_time (time, exp);
+
+    return (thread->timeout);
+}
+
+bool stimc_wait_event_combination_timeout_seconds (const stimc_event_combination combination, bool consume, double time)
+{
+    struct stimc_thread_s *thread = stimc_current_thread;
+
+    assert (thread);
+
+    thread->timeout = false;
+    stimc_event_combination_enqueue_thread (thread, combination, consume);
+
+    stimc_wait_time_seconds (time);
+
+    return (thread->timeout);
+}
+
+void stimc_register_event_method (void (*methodfunc)(void *userdata), void *userdata, stimc_event event)
+{
+    assert (event);
+
+#ifndef STIMC_DISABLE_CLEANUP
+    if (event->cleanup_self == NULL) {
+        event->cleanup_self = stimc_cleanup_add (stimc_cleanup_event, event);
+    }
+#endif
+
+    stimc_method_list_append (&event->methods, methodfunc, userdata);
+}
+
+void stimc_trigger_event (stimc_event event)
+{
+    STIMC_PROFILE_COUNT (events_triggered, 1);
+
+#ifdef STIMC_TRACE
+    if (stimc_trace_active ()) stimc_trace_trigger (event);
+#endif
+
+    /* methods are called directly */
+    if (event->methods.num > 0) {
+        event->dispatch++;
+        stimc_method_list_call (&event->methods);
+        event->dispatch--;
+
+        if (event->free_pending) {
+            if (event->dispatch == 0) stimc_event_release (event);
+            return;
+        }
+    }
+
+    if (event->queue.num == 0) return;
+
+    /* disable timeouts, remove handles */
+    for (size_t i = 0; i < event->queue.num; i++) {
+        struct stimc_thread_s *thread = event->queue.entries[i].thread;
+
+        if (thread == NULL) continue;
+
+        stimc_thread_remove_event_handle (thread, event->queue.entries[i].ref);
+
+        /* was one of many to wait for? -> do not trigger */
+        if ((!thread->event_combination->any) && stimc_thread_has_event_handle (thread)) {
+            event->queue.entries[i].thread = NULL;
+            event->queue.dead++;
+            continue;
+        }
+
+        /* triggered by this event -> remove others */
+        for (size_t j = 0; j < thread->event_combination->num; j++) {
+            struct stimc_event_handle_s *h = &(thread->event_combination->events[j]);
+            stimc_event_remove_thread (h->event, h->idx);
+        }
+        stimc_event_combination_clear (thread->event_combination);
+
+        /* active timeout? -> remove + result */
+        if (thread->timer != NULL) {
+            stimc_timer_remove_thread (thread);
+            thread->timeout = false;
+        }
+
+        STIMC_PROFILE_COUNT (waiters_woken, 1);
+    }
+
+    /* enqueue threads... */
+    stimc_thread_queue_enqueue_all (&stimc_main_queue, &event->queue);
+
+    stimc_thread_queue_clear (&event->queue);
+}
+
+bool stimc_wait_timed_out (void)
+{
+    assert (stimc_current_thread);
+
+    return stimc_current_thread->timeout;
+}
+
+void stimc_finish (void)
+{
+    if (stimc_current_thread == NULL) {
+        vpi_control (vpiFinish, 0);
+    } else {
+        stimc_finish_pending = true;
+        if (stimc_current_thread->state < STIMC_THREAD_STATE_STOPPED_TO_FINISH) {
+            stimc_current_thread->state = STIMC_THREAD_STATE_STOPPED_TO_FINISH;
+        }
+        stimc_suspend ();
+    }
+}
+
+void stimc_module_init (stimc_module *m, void (*cleanfunc)(void *cleandata) STIMC_CLEANUP_ATTR, void *cleandata STIMC_CLEANUP_ATTR)
+{
+    assert (m);
+    vpiHandle mod = stimc_get_caller_scope ();
+
+    m->mod   = mod;
+    m->index = NULL;
+
+#ifndef STIMC_DISABLE_CLEANUP
+    if (cleanfunc != NULL) {
+        stimc_cleanup_add (cleanfunc, cleandata);
+    }
+#endif
+}
+
+void stimc_module_free (stimc_module *m)
+{
+    if (m->index == NULL) return;
+
+    free (m->index->entries);
+    free (m->index);
+    m->index = NULL;
+}
+
+static int stimc_module_register_init_cptf (PLI_BYTE8 *user_data __attribute__((unused)))
+{
+    return 0;
+}
+
+static int stimc_module_register_init_cltf (PLI_BYTE8 *user_data)
+{
+    void (*initfunc)(void) = (void (*)(void)) (uintptr_t) user_data;
+
+    STIMC_PROFILE_ENTER (STIMC_PROFILE_STIMC);
+
+#ifdef STIMC_TRACE
+    static bool trace_plusarg = false;
+    if (!trace_plusarg) {
+        trace_plusarg = true;
+        stimc_trace_plusarg ();
+    }
+
+    /* threads and methods created in init belong to calling module */
+    size_t trace_module = stimc_trace.module;
+    stimc_trace.module = stimc_trace_module (stimc_get_caller_scope ());
+#endif
+
+    initfunc ();
+
+    stimc_main_queue_run_threads ();
+
+#ifdef STIMC_TRACE
+    stimc_trace.module = trace_module;
+#endif
+
+    STIMC_PROFILE_LEAVE ();
+
+    return 0;
+}
+
+void stimc_module_register (const char *name, void (*initfunc)(void))
+{
+    const char *task_prefix = "$stimc_";
+    const char *task_suffix = "_init";
+
+    size_t task_name_len = strlen (task_prefix) + strlen (name) + strlen (task_suffix);
+
+    char *task_name = (char *)malloc (task_name_len + 1);
+
+    assert (task_name);
+    task_name[0] = '\0';
+
+    strcat (task_name, task_prefix);
+    strcat (task_name, name);
+    strcat (task_name, task_suffix);
+
+    s_vpi_systf_data tf_data;
+
+    tf_data.type      = vpiSysTask;
+    tf_data.tfname    = task_name;
+    tf_data.calltf    = stimc_module_register_init_cltf;
+    tf_data.compiletf = stimc_module_register_init_cptf;
+    tf_data.sizetf    = 0;
+    tf_data.user_data = (void *)(uintptr_t)initfunc;
+
+    vpi_register_systf (&tf_data);
+
+    free (task_name);
+}
+
+static uint32_t stimc_module_index_hash (const char *name)
+{
+    /* FNV-1a */
+    uint32_t hash = 2166136261u;
+
+    for (const char *c = name; *c != '\0'; c++) {
+        hash ^= (uint8_t)*c;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static void stimc_module_index_insert (struct stimc_module_index_s *index, vpiHandle handle, uint32_t hash, int type)
+{
+    /* keep load factor below 1/2 */
+    if (2 * (index->num + 1) > index->max) {
+        struct stimc_module_index_entry_s *old_entries = index->entries;
+        size_t                             old_max     = index->max;
+
+        index->max     = (old_max == 0) ? 64 : (2 * old_max);
+        index->num     = 0;
+        index->entries = (struct stimc_module_index_entry_s *)calloc (index->max, sizeof (struct stimc_module_index_entry_s));
+        assert (index->entries);
+
+        for (size_t i = 0; i < old_max; i++) {
+            if (old_entries[i].handle == NULL) continue;
+            stimc_module_index_insert (index, old_entries[i].handle, old_entries[i].hash, old_entries[i].type);
+        }
+
+        free (old_entries);
+    }
+
+    size_t mask = index->max - 1;
+    size_t i    = hash & mask;
+
+    while (index->entries[i].handle != NULL) {
+        i = (i + 1) & mask;
+    }
+
+    index->entries[i].handle = handle;
+    index->entries[i].hash   = hash;
+    index->entries[i].type   = type;
+    index->num++;
+}
+
+static void stimc_module_index_build (stimc_module *m)
+{
+    static const uint32_t types[] = {vpiNet, vpiReg, vpiRealVar, vpiParameter, vpiMemory, 0};
+
+    struct stimc_module_index_s *index = (struct stimc_module_index_s *)malloc (sizeof (struct stimc_module_index_s));
+
+    assert (index);
+
+    index->max     = 0;
+    index->num     = 0;
+    index->entries = NULL;
+
+    /* single pass over all objects of interest */
+    for (const uint32_t *t = types; *t != 0; t++) {
+        vpiHandle iterator = vpi_iterate (*t, m->mod);
+
+        if (iterator == NULL) continue;
+
+        for (vpiHandle h = vpi_scan (iterator); h != NULL; h = vpi_scan (iterator)) {
+            stimc_module_index_insert (index, h, stimc_module_index_hash (vpi_get_str (vpiName, h)), *t);
+        }
+    }
+
+    m->index = index;
+}
+
+static vpiHandle stimc_module_handle_init (stimc_module *m, const uint32_t *types, const char *name)
+{
+    if (m->index == NULL) {
+        stimc_module_index_build (m);
+    }
+
+    struct stimc_module_index_s *index = m->index;
+    vpiHandle                    h     = NULL;
+
+    if (index->num == 0) goto stimc_module_handle_init_found;
+
+    uint32_t hash = stimc_module_index_hash (name);
+    size_t   mask = index->max - 1;
+
+    for (size_t i = hash & mask; index->entries[i].handle != NULL; i = (i + 1) & mask) {
+        struct stimc_module_index_entry_s *e = &(index->entries[i]);
+
+        if (e->hash != hash) continue;
+
+        for (const uint32_t *t = types; *t != 0; t++) {
+            if ((uint32_t)e->type != *t) continue;
+
+            if (strcmp (vpi_get_str (vpiName, e->handle), name) == 0) {
+                h = e->handle;
+
+                goto stimc_module_handle_init_found;
+            }
+        }
+    }
+
+stimc_module_handle_init_found:
+    assert (h);
+
+    return h;
+}
+
+stimc_port stimc_port_init (stimc_module *m, const char *name)
+{
+    static const uint32_t types[] = {vpiNet, vpiReg, vpiRealVar, 0};
+
+    vpiHandle handle = stimc_module_handle_init (m, types, name);
+
+    stimc_port result = (stimc_port)malloc (sizeof (struct stimc_net_s));
+
+    assert (result);
+
+    result->net       = handle;
+    result->size      = vpi_get (vpiSize, handle);
+    result->type      = vpi_get (vpiType, handle);
+    result->is_signed = (vpi_get (vpiSigned, handle) == 1);
+    result->nba       = NULL;
+    result->methods   = NULL;
+    result->cache     = NULL;
+
+    return result;
+}
+
+void stimc_port_free (stimc_port p)
+{
+    stimc_net_methods_free (p);
+
+    if (p->nba != NULL) {
+        if (p->nba->num > 0) {
+            stimc_net_nba_dirty_remove (p);
+        }
+
+        if (p->nba->queue != NULL) {
+            stimc_net_nba_entries_free (p->nba->queue, p->nba->num);
+            free (p->nba->queue);
+        }
+
+        free (p->nba);
+    }
+
+    free (p);
+}
+
+stimc_parameter stimc_parameter_init (stimc_module *m, const char *name)
+{
+    static const uint32_t types[] = {vpiParameter, 0};
+
+    return stimc_module_handle_init (m, types, name);
+}
+
+void stimc_parameter_free (stimc_parameter p __attribute__((unused)))
+{
+    /* nothing to do, yet*/
+}
+
+stimc_memory stimc_memory_init (stimc_module *m, const char *name)
+{
+    static const uint32_t types[] = {vpiMemory, 0};
+
+    vpiHandle handle;
+
+    if (strchr (name, '.') == NULL) {
+        handle = stimc_module_handle_init (m, types, name);
+    } else {
+        /* hierarchical name relative to module or absolute */
+        handle = vpi_handle_by_name ((PLI_BYTE8 *)name, m->mod);
+        if (handle == NULL) handle = vpi_handle_by_name ((PLI_BYTE8 *)name, NULL);
+        assert (handle);
+    }
+
+    stimc_memory mem = (stimc_memory)malloc (sizeof (struct stimc_memory_s));
+
+    assert (mem);
+
+    mem->mem   = handle;
+    mem->depth = vpi_get (vpiSize, handle);
+    mem->base  = 0;
+
+    vpiHandle left  = vpi_handle (vpiLeftRange, handle);
+    vpiHandle right = vpi_handle (vpiRightRange, handle);
+
+    if ((left != NULL) && (right != NULL)) {
+        s_vpi_value v_left;
+        s_vpi_value v_right;
+
+        v_left.format  = vpiIntVal;
+        v_right.format = vpiIntVal;
+        vpi_get_value (left, &v_left);
+        vpi_get_value (right, &v_right);
+
+        mem->base = (v_left.value.integer < v_right.value.integer) ? v_left.value.integer : v_right.value.integer;
+    }
+
+    assert (mem->depth > 0);
+    mem->words = (vpiHandle *)calloc (mem->depth, sizeof (vpiHandle));
+    assert (mem->words);
+
+    mem->width = vpi_get (vpiSize, stimc_memory_word (mem, mem->base));
+
+    return mem;
+}
+
+void stimc_memory_free (stimc_memory mem)
+{
+    free (mem->words);
+    free (mem);
+}
+
+unsigned stimc_memory_width (stimc_memory mem)
+{
+    return mem->width;
+}
+
+unsigned stimc_memory_depth (stimc_memory mem)
+{
+    return mem->depth;
+}
+
+int32_t stimc_memory_base (stimc_memory mem)
+{
+    return mem->base;
+}
+
+static inline vpiHandle stimc_memory_word (stimc_memory mem, int32_t addr)
+{
+    assert ((addr >= mem->base) && ((uint32_t)(addr - mem->base) < mem->depth));
+
+    vpiHandle *word = &(mem->words[addr - mem->base]);
+
+    if (*word == NULL) {
+        *word = vpi_handle_by_index (mem->mem, addr);
+        assert (*word);
+    }
+
+    return *word;
+}
+
+static void stimc_memory_word_put (stimc_memory mem, int32_t addr, s_vpi_vecval *vec)
+{
+    s_vpi_value v;
+
+    if (mem->width == 1) {
+        v.format       = vpiScalarVal;
+        v.value.scalar = stimc_vecval_scalar[(vec[0].aval & 1) | ((vec[0].bval & 1) << 1)];
+    } else {
+        v.format       = vpiVectorVal;
+        v.value.vector = vec;
+    }
+
+    vpi_put_value (stimc_memory_word (mem, addr), &v, NULL, vpiNoDelay);
+}
+
+void stimc_memory_set_uint64 (stimc_memory mem, int32_t addr, uint64_t value)
+{
+    unsigned words = ((mem->width - 1) / 32) + 1;
+
+    s_vpi_vecval  vec_static[STIMC_VALVECTOR_MAX_STATIC];
+    s_vpi_vecval *vec = &(vec_static[0]);
+
+    if (words > STIMC_VALVECTOR_MAX_STATIC) {
+        vec = (s_vpi_vecval *)malloc (words * sizeof (s_vpi_vecval));
+        assert (vec);
+    }
+
+    for (unsigned j = 0; j < words; j++) {
+        vec[j].aval = (j < 2) ? (PLI_INT32)(uint32_t)(value >> (32 * j)) : 0;
+        vec[j].bval = 0;
+    }
+
+    stimc_memory_word_put (mem, addr, vec);
+
+    if (vec != &(vec_static[0])) free (vec);
+}
+
+uint64_t stimc_memory_get_uint64 (stimc_memory mem, int32_t addr)
+{
+    s_vpi_value v;
+
+    v.format = vpiVectorVal;
+    vpi_get_value (stimc_memory_word (mem, addr), &v);
+
+    uint64_t result = 0;
+    unsigned words  = ((mem->width - 1) / 32) + 1;
+
+    for (unsigned i = 0; (i < words) && (i < 2); i++) {
+        /* prevent sign extension */
+        result |= (((uint64_t)(unsigned)v.value.vector[i].aval & ~((uint64_t)(unsigned)v.value.vector[i].bval)) << (32 * i));
+    }
+
+    return result;
+}
+
+void stimc_memory_write (stimc_memory mem, int32_t addr, unsigned num, const uint32_t *data)
+{
+    unsigned words = ((mem->width - 1) / 32) + 1;
+
+    s_vpi_vecval  vec_static[STIMC_VALVECTOR_MAX_STATIC];
+    s_vpi_vecval *vec = &(vec_static[0]);
+
+    if (words > STIMC_VALVECTOR_MAX_STATIC) {
+        vec = (s_vpi_vecval *)malloc (words * sizeof (s_vpi_vecval));
+        assert (vec);
+    }
+
+    for (unsigned i = 0; i < num; i++) {
+        for (unsigned j = 0; j < words; j++) {
+            vec[j].aval = (PLI_INT32)data[i * words + j];
+            vec[j].bval = 0;
+        }
 
-    stimc_wait_time_seconds (time);
+        stimc_memory_word_put (mem, addr + (int32_t)i, vec);
+    }
 
-    return (thread->timeout);
+    if (vec != &(vec_static[0])) free (vec);
 }
 
-void stimc_trigger_event (stimc_event event)
+void stimc_memory_read (stimc_memory mem, int32_t addr, unsigned num, uint32_t *data)
 {
-    if (event->queue.num == 0) return;
-
-    /* disable timeouts, remove handles */
-    for (size_t i = 0; i < event->queue.num; i++) {
-        struct stimc_thread_s *thread = event->queue.threads[i];
+    unsigned words = ((mem->width - 1) / 32) + 1;
 
-        if (thread == NULL) continue;
+    for (unsigned i = 0; i < num; i++) {
+        s_vpi_value v;
 
-        stimc_thread_remove_event_handle (thread, event);
+        v.format = vpiVectorVal;
+        vpi_get_value (stimc_memory_word (mem, addr + (int32_t)i), &v);
 
-        /* was one of many to wait for? -> do not trigger */
-        if ((!thread->event_combination->any) && stimc_thread_has_event_handle (thread)) {
-            event->queue.threads[i] = NULL;
-            continue;
+        for (unsigned j = 0; j < words; j++) {
+            data[i * words + j] = (uint32_t)v.value.vector[j].aval & ~(uint32_t)v.value.vector[j].bval;
         }
+    }
+}
 
-        /* triggered by this event -> remove others */
-        for (size_t j = 0; j < thread->event_combination->num; j++) {
-            struct stimc_event_handle_s *h = &(thread->event_combination->events[j]);
-            stimc_event_remove_thread (h->event, h->idx);
+/* parse hex word (digits as in $readmemh) into vector value */
+static bool stimc_memory_hex_word (s_vpi_vecval *vec, unsigned width, const char *digits, size_t len)
+{
+    unsigned words = ((width - 1) / 32) + 1;
+
+    for (unsigned j = 0; j < words; j++) {
+        vec[j].aval = 0;
+        vec[j].bval = 0;
+    }
+
+    /* least significant digit last */
+    unsigned pos = 0;
+
+    for (size_t i = len; i > 0; i--) {
+        char     c = digits[i - 1];
+        uint32_t a;
+        uint32_t b;
+
+        if (c == '_') continue;
+
+        if ((c >= '0') && (c <= '9')) {
+            a = c - '0';
+            b = 0x0;
+        } else if ((c >= 'a') && (c <= 'f')) {
+            a = c - 'a' + 10;
+            b = 0x0;
+        } else if ((c >= 'A') && (c <= 'F')) {
+            a = c - 'A' + 10;
+            b = 0x0;
+        } else if ((c == 'x') || (c == 'X')) {
+            a = 0xf;
+            b = 0xf;
+        } else if ((c == 'z') || (c == 'Z') || (c == '?')) {
+            a = 0x0;
+            b = 0xf;
+        } else {
+            return false;
         }
-        stimc_event_combination_clear (thread->event_combination);
 
-        /* active timeout? -> remove + result */
-        if (thread->call_handle != NULL) {
-            vpi_remove_cb (thread->call_handle);
-            thread->call_handle = NULL;
-            thread->timeout     = false;
+        /* excess digits are truncated */
+        if (pos < width) {
+            vec[pos / 32].aval = (PLI_INT32)((uint32_t)vec[pos / 32].aval | (a << (pos % 32)));
+            vec[pos / 32].bval = (PLI_INT32)((uint32_t)vec[pos / 32].bval | (b << (pos % 32)));
         }
+        pos += 4;
     }
 
-    /* enqueue threads... */
-    stimc_thread_queue_enqueue_all (&stimc_main_queue, &event->queue);
+    if (width % 32 != 0) {
+        uint32_t mask = ((uint32_t)1 << (width % 32)) - 1;
 
-    stimc_thread_queue_clear (&event->queue);
+        vec[words - 1].aval = (PLI_INT32)((uint32_t)vec[words - 1].aval & mask);
+        vec[words - 1].bval = (PLI_INT32)((uint32_t)vec[words - 1].bval & mask);
+    }
+
+    return true;
 }
 
-bool stimc_wait_timed_out (void)
+/* read-only view of complete file (NULL on error) */
+static const char *stimc_memory_file_map (const char *filename, size_t *len)
 {
-    assert (stimc_current_thread);
+#ifdef STIMC_MEMORY_FILE_MMAP
+    int fd = open (filename, O_RDONLY);
 
-    return stimc_current_thread->timeout;
-}
+    if (fd < 0) return NULL;
 
-void stimc_finish (void)
-{
-    if (stimc_current_thread == NULL) {
-        vpi_control (vpiFinish, 0);
-    } else {
-        stimc_finish_pending = true;
-        if (stimc_current_thread->state < STIMC_THREAD_STATE_STOPPED_TO_FINISH) {
-            stimc_current_thread->state = STIMC_THREAD_STATE_STOPPED_TO_FINISH;
+    struct stat st;
+
+    if (fstat (fd, &st) != 0) {
+        close (fd);
+        return NULL;
+    }
+
+    *len = (size_t)st.st_size;
+
+    if (*len == 0) {
+        close (fd);
+        return "";
+    }
+
+    void *data = mmap (NULL, *len, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    close (fd);
+
+    if (data == MAP_FAILED) return NULL;
+
+    return (const char *)data;
+#else
+    FILE *f = fopen (filename, "rb");
+
+    if (f == NULL) return NULL;
+
+    char  *data = NULL;
+    size_t max  = 0;
+
+    *len = 0;
+
+    for (;;) {
+        if (*len == max) {
+            max  = (max == 0) ? 65536 : (2 * max);
+            data = (char *)realloc (data, max);
+            assert (data);
         }
-        stimc_suspend ();
+
+        size_t n = fread (&(data[*len]), 1, max - *len, f);
+
+        if (n == 0) break;
+        *len += n;
     }
-}
 
-void stimc_module_init (stimc_module *m, void (*cleanfunc)(void *cleandata) STIMC_CLEANUP_ATTR, void *cleandata STIMC_CLEANUP_ATTR)
-{
-    assert (m);
-    vpiHandle mod = stimc_get_caller_scope ();
+    bool error = (ferror (f) != 0);
 
-    m->mod = mod;
+    fclose (f);
 
-#ifndef STIMC_DISABLE_CLEANUP
-    if (cleanfunc != NULL) {
-        stimc_cleanup_add (cleanfunc, cleandata);
+    if (error) {
+        free (data);
+        return NULL;
     }
+
+    return data;
 #endif
 }
 
-void stimc_module_free (stimc_module *m __attribute__((unused)))
-{}
-
-static int stimc_module_register_init_cptf (PLI_BYTE8 *user_data __attribute__((unused)))
+static void stimc_memory_file_unmap (const char *data, size_t len)
 {
-    return 0;
+#ifdef STIMC_MEMORY_FILE_MMAP
+    if (len == 0) return;
+
+    munmap ((void *)data, len);
+#else
+    (void)len;
+    free ((void *)data);
+#endif
 }
 
-static int stimc_module_register_init_cltf (PLI_BYTE8 *user_data)
+bool stimc_memory_load (stimc_memory mem, const char *filename, enum stimc_memory_format format, int32_t addr, unsigned num)
 {
-    void (*initfunc)(void) = (void (*)(void)) (uintptr_t) user_data;
-
-    initfunc ();
+    int64_t end = (int64_t)mem->base + mem->depth;
 
-    stimc_main_queue_run_threads ();
-
-    return 0;
-}
+    if ((num > 0) && ((int64_t)addr + num < end)) end = (int64_t)addr + num;
 
-void stimc_module_register (const char *name, void (*initfunc)(void))
-{
-    const char *task_prefix = "$stimc_";
-    const char *task_suffix = "_init";
+    assert ((addr >= mem->base) && (addr < end));
 
-    size_t task_name_len = strlen (task_prefix) + strlen (name) + strlen (task_suffix);
+    size_t      len;
+    const char *data = stimc_memory_file_map (filename, &len);
 
-    char *task_name = (char *)malloc (task_name_len + 1);
+    if (data == NULL) return false;
 
-    assert (task_name);
-    task_name[0] = '\0';
+    unsigned words = ((mem->width - 1) / 32) + 1;
 
-    strcat (task_name, task_prefix);
-    strcat (task_name, name);
-    strcat (task_name, task_suffix);
+    s_vpi_vecval  vec_static[STIMC_VALVECTOR_MAX_STATIC];
+    s_vpi_vecval *vec = &(vec_static[0]);
 
-    s_vpi_systf_data tf_data;
+    if (words > STIMC_VALVECTOR_MAX_STATIC) {
+        vec = (s_vpi_vecval *)malloc (words * sizeof (s_vpi_vecval));
+        assert (vec);
+    }
 
-    tf_data.type      = vpiSysTask;
-    tf_data.tfname    = task_name;
-    tf_data.calltf    = stimc_module_register_init_cltf;
-    tf_data.compiletf = stimc_module_register_init_cptf;
-    tf_data.sizetf    = 0;
-    tf_data.user_data = (void *)(uintptr_t)initfunc;
+    bool    result = true;
+    int64_t a      = addr;
 
-    vpi_register_systf (&tf_data);
+    if (format == STIMC_MEMORY_FORMAT_BIN) {
+        size_t bytes = (mem->width + 7) / 8;
 
-    free (task_name);
-}
+        for (size_t i = 0; (i + bytes <= len) && (a < end); i += bytes, a++) {
+            for (unsigned j = 0; j < words; j++) {
+                vec[j].aval = 0;
+                vec[j].bval = 0;
+            }
+            for (size_t k = 0; k < bytes; k++) {
+                vec[k / 4].aval = (PLI_INT32)((uint32_t)vec[k / 4].aval | ((uint32_t)(uint8_t)data[i + k] << (8 * (k % 4))));
+            }
+            if (mem->width % 32 != 0) {
+                vec[words - 1].aval = (PLI_INT32)((uint32_t)vec[words - 1].aval & (((uint32_t)1 << (mem->width % 32)) - 1));
+            }
 
-static vpiHandle stimc_module_handle_init (stimc_module *m, const uint32_t *types, const char *name)
-{
-    vpiHandle h = NULL;
+            stimc_memory_word_put (mem, (int32_t)a, vec);
+        }
+    } else {
+        size_t i = 0;
 
-    for (const uint32_t *t = types; *t != 0; t++) {
-        vpiHandle iterator = vpi_iterate (*t, m->mod);
+        while (i < len) {
+            char c = data[i];
 
-        if (iterator == NULL) continue;
+            if (isspace ((unsigned char)c)) {
+                i++;
+                continue;
+            }
 
-        for (h = vpi_scan (iterator); h != NULL; h = vpi_scan (iterator)) {
-            const char *h_name = vpi_get_str (vpiName, h);
+            /* comments */
+            if ((c == '/') && (i + 1 < len) && (data[i + 1] == '/')) {
+                while ((i < len) && (data[i] != '\n')) i++;
+                continue;
+            }
+            if ((c == '/') && (i + 1 < len) && (data[i + 1] == '*')) {
+                for (i += 3; (i < len) && !((data[i - 1] == '*') && (data[i] == '/')); i++) {}
+                if (i >= len) {
+                    /* unterminated comment */
+                    result = false;
+                    break;
+                }
+                i++;
+                continue;
+            }
+            if (c == '/') {
+                result = false;
+                break;
+            }
 
-            if (strcmp (h_name, name) == 0) {
-                vpi_free_object (iterator);
+            /* token */
+            size_t start = (c == '@') ? (i + 1) : i;
+
+            for (i = start; (i < len) && !isspace ((unsigned char)data[i]) && (data[i] != '/'); i++) {}
+
+            if (c == '@') {
+                /* address marker */
+                char *stop;
+                char  address[24];
+                if ((i - start == 0) || (i - start >= sizeof (address))) {
+                    result = false;
+                    break;
+                }
+                memcpy (address, &(data[start]), i - start);
+                address[i - start] = '\0';
+                a                  = strtoll (address, &stop, 16);
+                if (*stop != '\0') {
+                    result = false;
+                    break;
+                }
+                continue;
+            }
 
-                goto stimc_module_handle_init_found;
+            if ((a >= addr) && (a < end)) {
+                if (!stimc_memory_hex_word (vec, mem->width, &(data[start]), i - start)) {
+                    result = false;
+                    break;
+                }
+                stimc_memory_word_put (mem, (int32_t)a, vec);
             }
+            a++;
         }
     }
 
-stimc_module_handle_init_found:
-    assert (h);
+    if (vec != &(vec_static[0])) free (vec);
 
-    return h;
+    stimc_memory_file_unmap (data, len);
+
+    return result;
 }
 
-stimc_port stimc_port_init (stimc_module *m, const char *name)
+bool stimc_memory_dump (stimc_memory mem, const char *filename, enum stimc_memory_format format, int32_t addr, unsigned num)
 {
-    static const uint32_t types[] = {vpiNet, vpiReg, vpiRealVar, 0};
+    int64_t end = (int64_t)mem->base + mem->depth;
 
-    vpiHandle handle = stimc_module_handle_init (m, types, name);
+    if ((num > 0) && ((int64_t)addr + num < end)) end = (int64_t)addr + num;
 
-    stimc_port result = (stimc_port)malloc (sizeof (struct stimc_net_s));
+    assert ((addr >= mem->base) && (addr < end));
 
-    assert (result);
+    FILE *f = fopen (filename, (format == STIMC_MEMORY_FORMAT_BIN) ? "wb" : "w");
 
-    result->net = handle;
-    result->nba = NULL;
+    if (f == NULL) return false;
 
-    return result;
-}
+    unsigned width = mem->width;
+    unsigned bytes = (width + 7) / 8;
+    unsigned nibs  = (width + 3) / 4;
 
-void stimc_port_free (stimc_port p)
-{
-    if (p->nba != NULL) {
-        if (p->nba->cb_handle != NULL) {
-            vpi_remove_cb (p->nba->cb_handle);
-        }
+    for (int64_t a = addr; a < end; a++) {
+        s_vpi_value v;
 
-        free (p->nba->queue);
+        v.format = vpiVectorVal;
+        vpi_get_value (stimc_memory_word (mem, (int32_t)a), &v);
 
-        free (p->nba);
-    }
+        const s_vpi_vecval *vec = v.value.vector;
 
-    free (p);
-}
+        if (format == STIMC_MEMORY_FORMAT_BIN) {
+            for (unsigned k = 0; k < bytes; k++) {
+                uint32_t word = (uint32_t)vec[k / 4].aval & ~(uint32_t)vec[k / 4].bval;
 
-stimc_parameter stimc_parameter_init (stimc_module *m, const char *name)
-{
-    static const uint32_t types[] = {vpiParameter, 0};
+                fputc ((int)((word >> (8 * (k % 4))) & 0xff), f);
+            }
+        } else {
+            for (unsigned k = nibs; k > 0; k--) {
+                unsigned pos  = 4 * (k - 1);
+                uint32_t mask = (width - pos < 4) ? (((uint32_t)1 << (width - pos)) - 1) : 0xf;
+                uint32_t a_n  = ((uint32_t)vec[pos / 32].aval >> (pos % 32)) & mask;
+                uint32_t b_n  = ((uint32_t)vec[pos / 32].bval >> (pos % 32)) & mask;
+
+                if (b_n == 0) {
+                    fputc ("0123456789abcdef"[a_n], f);
+                } else if ((b_n == mask) && (a_n == 0)) {
+                    fputc ('z', f);
+                } else {
+                    fputc ('x', f);
+                }
+            }
+            fputc ('\n', f);
+        }
+    }
 
-    return stimc_module_handle_init (m, types, name);
-}
+    bool result = (ferror (f) == 0);
 
-void stimc_parameter_free (stimc_parameter p __attribute__((unused)))
-{
-    /* nothing to do, yet*/
+    if (fclose (f) != 0) result = false;
+
+    return result;
 }
 
 static void stimc_net_nba_queue_append (stimc_net net, struct stimc_nba_queue_entry_s *entry_new)
@@ -1302,24 +3503,41 @@ static void stimc_net_nba_queue_append (stimc_net net, struct stimc_nba_queue_en
         nba->num   = 0;
         assert (nba->queue);
 
-        nba->cb_handle = NULL;
-
         net->nba = nba;
     } else {
         /* resize if necessary */
         if (nba->num + 1 > nba->max) {
-            nba->max  *= 2;
+            nba->max   = (nba->max == 0) ? 4 : (2 * nba->max);
             nba->queue = (struct stimc_nba_queue_entry_s *)realloc (nba->queue, nba->max * sizeof (struct stimc_nba_queue_entry_s));
             assert (nba->queue);
         }
     }
 
+    /* first assignment in current time step */
+    if (nba->num == 0) {
+        stimc_net_nba_dirty_add (net);
+    }
+
     /* add new entry */
     nba->queue[nba->num] = *entry_new;
     nba->num++;
+}
+
+static void stimc_net_nba_dirty_add (stimc_net net)
+{
+    struct stimc_nba_net_list_s *l = &stimc_nba_dirty;
+
+    if (l->num >= l->max) {
+        l->max  = (l->max == 0) ? 16 : (2 * l->max);
+        l->nets = (stimc_net *)realloc (l->nets, l->max * sizeof (stimc_net));
+        assert (l->nets);
+    }
+
+    l->nets[l->num] = net;
+    l->num++;
 
     /* add handler, if not yet created */
-    if (nba->cb_handle != NULL) return;
+    if (stimc_nba_cb_handle != NULL) return;
 
     /* new callback */
     s_cb_data   cb_data;
@@ -1337,58 +3555,271 @@ static void stimc_net_nba_queue_append (stimc_net net, struct stimc_nba_queue_en
     cb_data.value         = &cb_data_value;
     cb_data.value->format = vpiSuppressVal;
     cb_data.index         = 0;
-    cb_data.user_data     = (PLI_BYTE8 *)net;
+    cb_data.user_data     = NULL;
+
+    stimc_nba_cb_handle = stimc_vpi_register_cb (&cb_data);
+    assert (stimc_nba_cb_handle);
+}
+
+static void stimc_net_nba_dirty_remove (stimc_net net)
+{
+    struct stimc_nba_net_list_s *lists[] = {&stimc_nba_dirty, &stimc_nba_flushing};
 
-    nba->cb_handle = vpi_register_cb (&cb_data);
-    assert (nba->cb_handle);
+    for (size_t i = 0; i < sizeof (lists) / sizeof (lists[0]); i++) {
+        for (size_t j = 0; j < lists[i]->num; j++) {
+            if (lists[i]->nets[j] == net) lists[i]->nets[j] = NULL;
+        }
+    }
 }
 
-static PLI_INT32 stimc_net_nba_callback_wrapper (struct t_cb_data *cb_data)
+#ifndef STIMC_DISABLE_CLEANUP
+static void stimc_net_nba_dirty_free (void)
 {
-    stimc_net net = (stimc_net)cb_data->user_data;
+    /* pending assignments are dropped */
+    for (size_t i = 0; i < stimc_nba_dirty.num; i++) {
+        stimc_net net = stimc_nba_dirty.nets[i];
 
-    for (size_t i = 0; i < net->nba->num; i++) {
-        struct stimc_nba_queue_entry_s *e = &(net->nba->queue[i]);
+        if (net == NULL) continue;
 
-        switch (e->type) {
+        stimc_net_nba_entries_free (net->nba->queue, net->nba->num);
+        net->nba->num = 0;
+    }
+
+    if (stimc_nba_dirty.nets != NULL) free (stimc_nba_dirty.nets);
+    if (stimc_nba_flushing.nets != NULL) free (stimc_nba_flushing.nets);
+
+    stimc_nba_dirty.nets    = NULL;
+    stimc_nba_dirty.max     = 0;
+    stimc_nba_dirty.num     = 0;
+    stimc_nba_flushing.nets = NULL;
+    stimc_nba_flushing.max  = 0;
+    stimc_nba_flushing.num  = 0;
+}
+#endif
+
+static PLI_INT32 stimc_net_nba_callback_wrapper (struct t_cb_data *cb_data __attribute__((unused)))
+{
+    STIMC_PROFILE_ENTER (STIMC_PROFILE_STIMC);
+    STIMC_PROFILE_COUNT (cb_executed, 1);
+    STIMC_PROFILE_COUNT (nba_flushes, 1);
+
+    stimc_vpi_remove_cb (stimc_nba_cb_handle);
+    stimc_nba_cb_handle = NULL;
+
+    /* assignments caused by flushing are collected for next callback */
+    struct stimc_nba_net_list_s l = stimc_nba_flushing;
+
+    stimc_nba_flushing = stimc_nba_dirty;
+    stimc_nba_dirty    = l;
+
+    for (size_t i = 0; i < stimc_nba_flushing.num; i++) {
+        stimc_net net = stimc_nba_flushing.nets[i];
+
+        if (net == NULL) continue;
+
+        struct stimc_nba_data_s        *nba   = net->nba;
+        struct stimc_nba_queue_entry_s *queue = nba->queue;
+        size_t                          num   = nba->num;
+        size_t                          max   = nba->max;
+
+        /* detach queue, so it remains valid while flushing */
+        nba->queue = NULL;
+        nba->max   = 0;
+        nba->num   = 0;
+
+        /* entries before the last full assignment are overwritten anyway */
+        size_t start = 0;
+
+        for (size_t j = num; j > 0; j--) {
+            enum stimc_nba_type type = queue[j - 1].type;
+
+            if ((type != STIMC_NBA_Z_BITS) && (type != STIMC_NBA_X_BITS) && (type != STIMC_NBA_VAL_BITS)) {
+                start = j - 1;
+                break;
+            }
+        }
+
+        stimc_net_nba_flush (net, &(queue[start]), num - start);
+        stimc_net_nba_entries_free (queue, num);
+
+        STIMC_PROFILE_COUNT (nba_nets, 1);
+        STIMC_PROFILE_COUNT (nba_entries, num);
+
+        if (nba->queue == NULL) {
+            nba->queue = queue;
+            nba->max   = max;
+        } else {
+            free (queue);
+        }
+    }
+
+    stimc_nba_flushing.num = 0;
+
+    STIMC_PROFILE_LEAVE ();
+
+    return 0;
+}
+
+/* release data of queued assignments */
+static void stimc_net_nba_entries_free (struct stimc_nba_queue_entry_s *queue, size_t num)
+{
+    for (size_t i = 0; i < num; i++) {
+        if (queue[i].type == STIMC_NBA_VAL_ALL_VECTOR) free (queue[i].vector);
+    }
+}
+
+/* assign bits msb..lsb of vector value (aval/bval replicated per word or shifted to lsb) */
+static inline void stimc_vecval_set_bits (s_vpi_vecval *vec, unsigned vsize, unsigned msb, unsigned lsb, uint64_t aval, uint64_t bval, bool replicate)
+{
+    unsigned jstart = lsb / 32;
+    unsigned jstop  = msb / 32;
+
+    for (unsigned j = jstart; (j < vsize) && (j <= jstop); j++) {
+        uint32_t i_mask = 0xffffffff;
+        uint32_t i_aval;
+        uint32_t i_bval;
+
+        if (j == jstart) i_mask &= 0xffffffff << (lsb % 32);
+        if (j == jstop)  i_mask &= 0xffffffff >> (31 - (msb % 32));
+
+        if (replicate) {
+            i_aval = (uint32_t)aval;
+            i_bval = (uint32_t)bval;
+        } else if (j == jstart) {
+            i_aval = (uint32_t)(aval << (lsb % 32));
+            i_bval = (uint32_t)(bval << (lsb % 32));
+        } else {
+            unsigned shift = 32 * j - lsb;
+
+            i_aval = (shift < 64 ? (uint32_t)(aval >> shift) : 0);
+            i_bval = (shift < 64 ? (uint32_t)(bval >> shift) : 0);
+        }
+
+        vec[j].aval = (PLI_INT32)(((uint32_t)vec[j].aval & ~i_mask) | (i_aval & i_mask));
+        vec[j].bval = (PLI_INT32)(((uint32_t)vec[j].bval & ~i_mask) | (i_bval & i_mask));
+    }
+}
+
+/* fold queued assignments (only the first one might be a full assignment) into a single value assignment */
+static void stimc_net_nba_flush (stimc_net net, const struct stimc_nba_queue_entry_s *queue, size_t num)
+{
+    if (num == 0) return;
+
+    unsigned size = net->size;
+
+    static s_vpi_value v;
+
+    int32_t flags = vpiNoDelay;
+
+    unsigned vsize = ((size - 1) / 32) + 1;
+
+    size_t i    = 0;
+    bool   init = true;
+
+    /* full assignments not representable as vector value are applied directly */
+    if ((queue[0].type == STIMC_NBA_VAL_REAL) || ((queue[0].type == STIMC_NBA_VAL_ALL_INT32) && (size > 32))) {
+        if (queue[0].type == STIMC_NBA_VAL_REAL) {
+            stimc_net_set_double (net, queue[0].real_value);
+        } else {
+            stimc_net_set_int32 (net, (int32_t)queue[0].value);
+        }
+
+        if (num == 1) return;
+
+        i    = 1;
+        init = false;
+    }
+
+    s_vpi_vecval  vec_static[STIMC_VALVECTOR_MAX_STATIC];
+    s_vpi_vecval *vec = &(vec_static[0]);
+
+    if (vsize > STIMC_VALVECTOR_MAX_STATIC) {
+        vec = (s_vpi_vecval *)malloc (vsize * sizeof (s_vpi_vecval));
+        assert (vec);
+    }
+
+    if (init) {
+        switch (queue[0].type) {
             case STIMC_NBA_Z_ALL:
-                stimc_net_set_z (net);
+                stimc_vecval_set_bits (vec, vsize, size - 1, 0, 0x00000000, 0xffffffff, true);
+                i = 1;
                 break;
             case STIMC_NBA_X_ALL:
-                stimc_net_set_x (net);
+                stimc_vecval_set_bits (vec, vsize, size - 1, 0, 0xffffffff, 0xffffffff, true);
+                i = 1;
                 break;
             case STIMC_NBA_VAL_ALL_INT32:
-                stimc_net_set_int32 (net, e->value);
+            case STIMC_NBA_VAL_ALL_UINT64: {
+                uint64_t value = queue[0].value;
+
+                /* same as stimc_net_set_uint64: any non-zero value sets a single bit */
+                if ((size == 1) && (queue[0].type == STIMC_NBA_VAL_ALL_UINT64)) value = (value != 0);
+
+                stimc_vecval_set_bits (vec, vsize, size - 1, 0, 0, 0, true);
+                stimc_vecval_set_bits (vec, vsize, (size < 64 ? size - 1 : 63), 0, value, 0, false);
+                i = 1;
+                break;
+            }
+            case STIMC_NBA_VAL_ALL_VECTOR:
+                memcpy (vec, queue[0].vector, vsize * sizeof (s_vpi_vecval));
+                i = 1;
                 break;
-            case STIMC_NBA_VAL_ALL_UINT64:
-                stimc_net_set_uint64 (net, e->value);
+            default:
+                init = false;
                 break;
+        }
+    }
+
+    /* bit assignments on top of current value */
+    if (!init) {
+        v.format = vpiVectorVal;
+        vpi_get_value (net->net, &v);
+
+        for (unsigned j = 0; j < vsize; j++) {
+            vec[j] = v.value.vector[j];
+        }
+    }
+
+    for (; i < num; i++) {
+        const struct stimc_nba_queue_entry_s *e = &(queue[i]);
+
+        unsigned msb = e->msb;
+        unsigned lsb = e->lsb;
+
+        if (msb < lsb) continue;
+
+        switch (e->type) {
             case STIMC_NBA_Z_BITS:
-                stimc_net_set_bits_z (net, e->msb, e->lsb);
+                stimc_vecval_set_bits (vec, vsize, msb, lsb, 0x00000000, 0xffffffff, true);
                 break;
             case STIMC_NBA_X_BITS:
-                stimc_net_set_bits_x (net, e->msb, e->lsb);
+                stimc_vecval_set_bits (vec, vsize, msb, lsb, 0xffffffff, 0xffffffff, true);
                 break;
             case STIMC_NBA_VAL_BITS:
-                stimc_net_set_bits_uint64 (net, e->msb, e->lsb, e->value);
+                if ((msb - lsb) > 63) msb = lsb + 63;
+                stimc_vecval_set_bits (vec, vsize, msb, lsb, e->value, 0, false);
                 break;
-            case STIMC_NBA_VAL_REAL:
-                stimc_net_set_double (net, e->real_value);
+            default:
+                assert (false);
                 break;
         }
     }
 
-    vpi_remove_cb (net->nba->cb_handle);
-
-    net->nba->cb_handle = NULL;
-    net->nba->num       = 0;
+    if (size == 1) {
+        v.format       = vpiScalarVal;
+        v.value.scalar = stimc_vecval_scalar[(vec[0].aval & 1) | ((vec[0].bval & 1) << 1)];
+    } else {
+        v.format       = vpiVectorVal;
+        v.value.vector = vec;
+    }
+    vpi_put_value (net->net, &v, NULL, flags);
 
-    return 0;
+    if (vec != &(vec_static[0])) free (vec);
 }
 
 static inline void stimc_net_set_xz (stimc_net net, int val)
 {
-    unsigned size = vpi_get (vpiSize, net->net);
+    unsigned size = net->size;
 
     static s_vpi_value v;
 
@@ -1433,7 +3864,7 @@ static inline void stimc_net_set_bits_xz (stimc_net net, unsigned msb, unsigned
 {
     if (msb < lsb) return;
 
-    unsigned size = vpi_get (vpiSize, net->net);
+    unsigned size = net->size;
 
     static s_vpi_value v;
 
@@ -1441,36 +3872,10 @@ static inline void stimc_net_set_bits_xz (stimc_net net, unsigned msb, unsigned
 
     unsigned vsize = ((size - 1) / 32) + 1;
 
-    unsigned jstart = lsb / 32;
-    unsigned s0     = lsb % 32;
-    unsigned jstop  = msb / 32;
-    unsigned se     = msb % 32;
-
     v.format = vpiVectorVal;
     vpi_get_value (net->net, &v);
 
-    for (unsigned j = jstart; (j < vsize) && (j <= jstop); j++) {
-        uint32_t i_mask;
-
-        if (j == jstop) {
-            i_mask = (2 << se);
-        } else {
-            i_mask = 0;
-        }
-
-        if (j == jstart) {
-            i_mask -= (1 << s0);
-        } else {
-            i_mask -= 1;
-        }
-
-        if (val == vpiZ) {
-            v.value.vector[j].aval &= ~i_mask;
-        } else {
-            v.value.vector[j].aval |= i_mask;
-        }
-        v.value.vector[j].bval |= i_mask;
-    }
+    stimc_vecval_set_bits (v.value.vector, vsize, msb, lsb, (val == vpiZ ? 0x00000000 : 0xffffffff), 0xffffffff, true);
 
     vpi_put_value (net->net, &v, NULL, flags);
 }
@@ -1486,11 +3891,11 @@ void stimc_net_set_x (stimc_net net)
 
 bool stimc_net_is_xz (stimc_net net)
 {
-    unsigned size = vpi_get (vpiSize, net->net);
+    unsigned size = net->size;
 
     s_vpi_value v;
 
-    if (size == 1) {
+    if ((size == 1) && (net->cache == NULL)) {
         v.format = vpiScalarVal;
         vpi_get_value (net->net, &v);
         if ((v.value.scalar == vpiX) || (v.value.scalar == vpiZ)) {
@@ -1502,10 +3907,10 @@ bool stimc_net_is_xz (stimc_net net)
 
     unsigned vsize = ((size - 1) / 32) + 1;
 
-    v.format = vpiVectorVal;
-    vpi_get_value (net->net, &v);
+    const s_vpi_vecval *vec = stimc_net_vecval (net);
+
     for (unsigned i = 0; i < vsize; i++) {
-        if (v.value.vector[i].bval != 0) return true;
+        if (vec[i].bval != 0) return true;
     }
     return false;
 }
@@ -1524,9 +3929,7 @@ bool stimc_net_bits_are_xz (stimc_net net, unsigned msb, unsigned lsb)
 {
     if (msb < lsb) return false;
 
-    unsigned size = vpi_get (vpiSize, net->net);
-
-    static s_vpi_value v;
+    unsigned size = net->size;
 
     unsigned vsize = ((size - 1) / 32) + 1;
 
@@ -1535,8 +3938,7 @@ bool stimc_net_bits_are_xz (stimc_net net, unsigned msb, unsigned lsb)
     unsigned jstop  = msb / 32;
     unsigned se     = msb % 32;
 
-    v.format = vpiVectorVal;
-    vpi_get_value (net->net, &v);
+    const s_vpi_vecval *vec = stimc_net_vecval (net);
 
     for (unsigned j = jstart; (j < vsize) && (j <= jstop); j++) {
         uint32_t i_mask;
@@ -1553,7 +3955,7 @@ bool stimc_net_bits_are_xz (stimc_net net, unsigned msb, unsigned lsb)
             i_mask -= 1;
         }
 
-        if ((v.value.vector[j].bval & i_mask) != 0) return true;
+        if ((vec[j].bval & i_mask) != 0) return true;
     }
 
     return false;
@@ -1563,7 +3965,7 @@ void stimc_net_set_bits_uint64 (stimc_net net, unsigned msb, unsigned lsb, uint6
 {
     if (msb < lsb) return;
 
-    unsigned size = vpi_get (vpiSize, net->net);
+    unsigned size = net->size;
 
     static s_vpi_value v;
 
@@ -1576,42 +3978,18 @@ void stimc_net_set_bits_uint64 (stimc_net net, unsigned msb, unsigned lsb, uint6
 
     if ((msb - lsb) > 63) msb = lsb + 63;
 
-    unsigned jstart = lsb / 32;
-    unsigned s0     = lsb % 32;
-    unsigned jstop  = msb / 32;
-
-    uint64_t mask = (lsb == msb ? 1 : ((2 << (msb - lsb)) - 1));
-
-    for (unsigned i = 0, j = jstart; (j < vsize) && (j <= jstop) && (i < 3); i++, j++) {
-        uint64_t i_mask;
-        uint64_t i_val;
-
-        if (i == 0) {
-            i_mask = mask << s0;
-            i_val  = (value & mask) << s0;
-        } else {
-            i_mask = mask           >> (32 * i - s0);
-            i_val  = (value & mask) >> (32 * i - s0);
-        }
-
-        v.value.vector[j].aval &= ~i_mask;
-        v.value.vector[j].aval |=  i_val;
-        v.value.vector[j].bval &= ~i_mask;
-    }
+    stimc_vecval_set_bits (v.value.vector, vsize, msb, lsb, value, 0, false);
 
     vpi_put_value (net->net, &v, NULL, flags);
 }
 
 uint64_t stimc_net_get_bits_uint64 (stimc_net net, unsigned msb, unsigned lsb)
 {
-    unsigned size = vpi_get (vpiSize, net->net);
-
-    s_vpi_value v;
+    unsigned size = net->size;
 
     unsigned vsize = ((size - 1) / 32) + 1;
 
-    v.format = vpiVectorVal;
-    vpi_get_value (net->net, &v);
+    const s_vpi_vecval *vec = stimc_net_vecval (net);
 
     uint64_t result = 0;
 
@@ -1622,10 +4000,10 @@ uint64_t stimc_net_get_bits_uint64 (stimc_net net, unsigned msb, unsigned lsb)
     for (unsigned i = 0, j = jstart; (j < vsize) && (j <= jstop) && (i < 3); i++, j++) {
         if (i == 0) {
             /* prevent sign extension */
-            result |= (((uint64_t)(unsigned)v.value.vector[j].aval & ~((uint64_t)(unsigned)v.value.vector[j].bval)) >> s0);
+            result |= (((uint64_t)(unsigned)vec[j].aval & ~((uint64_t)(unsigned)vec[j].bval)) >> s0);
         } else {
             /* prevent sign extension */
-            result |= (((uint64_t)(unsigned)v.value.vector[j].aval & ~((uint64_t)(unsigned)v.value.vector[j].bval)) << (32 * i - s0));
+            result |= (((uint64_t)(unsigned)vec[j].aval & ~((uint64_t)(unsigned)vec[j].bval)) << (32 * i - s0));
         }
     }
 
@@ -1636,7 +4014,7 @@ uint64_t stimc_net_get_bits_uint64 (stimc_net net, unsigned msb, unsigned lsb)
 
 void stimc_net_set_uint64 (stimc_net net, uint64_t value)
 {
-    unsigned size = vpi_get (vpiSize, net->net);
+    unsigned size = net->size;
 
     static s_vpi_value v;
 
@@ -1687,25 +4065,83 @@ void stimc_net_set_uint64 (stimc_net net, uint64_t value)
 
 uint64_t stimc_net_get_uint64 (stimc_net net)
 {
-    unsigned size = vpi_get (vpiSize, net->net);
-
-    s_vpi_value v;
+    unsigned size = net->size;
 
     unsigned vsize = ((size - 1) / 32) + 1;
 
-    v.format = vpiVectorVal;
-    vpi_get_value (net->net, &v);
+    const s_vpi_vecval *vec = stimc_net_vecval (net);
 
     uint64_t result = 0;
 
     for (unsigned i = 0; (i < vsize) && (i < 2); i++) {
         /* prevent sign extension */
-        result |= (((uint64_t)(unsigned)v.value.vector[i].aval & ~((uint64_t)(unsigned)v.value.vector[i].bval)) << (32 * i));
+        result |= (((uint64_t)(unsigned)vec[i].aval & ~((uint64_t)(unsigned)vec[i].bval)) << (32 * i));
     }
 
     return result;
 }
 
+void stimc_net_set_vector (stimc_net net, const uint32_t *aval, const uint32_t *bval, unsigned words)
+{
+    unsigned size = net->size;
+
+    static s_vpi_value v;
+
+    int32_t flags = vpiNoDelay;
+
+    unsigned vsize = ((size - 1) / 32) + 1;
+
+    s_vpi_vecval  vec_static[STIMC_VALVECTOR_MAX_STATIC];
+    s_vpi_vecval *vec = &(vec_static[0]);
+
+    if (vsize > STIMC_VALVECTOR_MAX_STATIC) {
+        vec = (s_vpi_vecval *)malloc (vsize * sizeof (s_vpi_vecval));
+        assert (vec);
+    }
+
+    for (unsigned i = 0; i < vsize; i++) {
+        if (i < words) {
+            vec[i].aval = (PLI_INT32)aval[i];
+            vec[i].bval = (bval != NULL ? (PLI_INT32)bval[i] : 0);
+        } else {
+            vec[i].aval = 0;
+            vec[i].bval = 0;
+        }
+    }
+
+    v.format       = vpiVectorVal;
+    v.value.vector = vec;
+    vpi_put_value (net->net, &v, NULL, flags);
+
+    if (vec != &(vec_static[0])) free (vec);
+}
+
+void stimc_net_get_vector (stimc_net net, uint32_t *aval, uint32_t *bval, unsigned words)
+{
+    unsigned size = net->size;
+
+    unsigned vsize = ((size - 1) / 32) + 1;
+
+    const s_vpi_vecval *vec = stimc_net_vecval (net);
+
+    for (unsigned i = 0; i < words; i++) {
+        uint32_t a = 0;
+        uint32_t b = 0;
+
+        if (i < vsize) {
+            a = (uint32_t)vec[i].aval;
+            b = (uint32_t)vec[i].bval;
+        }
+
+        if (bval != NULL) {
+            aval[i] = a;
+            bval[i] = b;
+        } else {
+            aval[i] = a & ~b;
+        }
+    }
+}
+
 void stimc_net_set_z_nonblock (stimc_net net)
 {
     struct stimc_nba_queue_entry_s assign = {
@@ -1788,6 +4224,320 @@ void stimc_net_set_double_nonblock (stimc_net net, double value)
     stimc_net_nba_queue_append (net, &assign);
 }
 
+/* vector value as single non-blocking assignment */
+static void stimc_net_set_vecval_nonblock (stimc_net net, const s_vpi_vecval *vec)
+{
+    unsigned vsize = ((net->size - 1) / 32) + 1;
+
+    /* up to 64 bit without x/z: plain value */
+    bool plain = (vsize <= 2);
+
+    for (unsigned j = 0; plain && (j < vsize); j++) {
+        if (vec[j].bval != 0) plain = false;
+    }
+
+    if (plain) {
+        struct stimc_nba_queue_entry_s assign = {
+            .value = (uint64_t)(uint32_t)vec[0].aval | ((vsize > 1) ? ((uint64_t)(uint32_t)vec[1].aval << 32) : 0),
+            .type  = STIMC_NBA_VAL_ALL_UINT64,
+        };
+
+        stimc_net_nba_queue_append (net, &assign);
+        return;
+    }
+
+    /* otherwise copy of all words */
+    struct stimc_nba_queue_entry_s assign = {
+        .vector = (s_vpi_vecval *)malloc (vsize * sizeof (s_vpi_vecval)),
+        .type   = STIMC_NBA_VAL_ALL_VECTOR,
+    };
+
+    assert (assign.vector);
+    memcpy (assign.vector, vec, vsize * sizeof (s_vpi_vecval));
+
+    stimc_net_nba_queue_append (net, &assign);
+}
+
+stimc_port_bundle stimc_port_bundle_init (void)
+{
+    stimc_port_bundle bundle = (stimc_port_bundle)malloc (sizeof (struct stimc_port_bundle_s));
+
+    assert (bundle);
+
+    bundle->num       = 0;
+    bundle->max       = 0;
+    bundle->words     = 0;
+    bundle->words_max = 0;
+    bundle->entries   = NULL;
+    bundle->buffer    = NULL;
+
+    return bundle;
+}
+
+void stimc_port_bundle_free (stimc_port_bundle bundle)
+{
+    if (bundle->entries != NULL) free (bundle->entries);
+    if (bundle->buffer != NULL) free (bundle->buffer);
+
+    free (bundle);
+}
+
+unsigned stimc_port_bundle_add (stimc_port_bundle bundle, stimc_port port)
+{
+    assert (port->type != vpiRealVar);
+
+    unsigned words = ((port->size - 1) / 32) + 1;
+
+    if (bundle->num >= bundle->max) {
+        bundle->max     = (bundle->max == 0) ? 8 : (2 * bundle->max);
+        bundle->entries = (struct stimc_port_bundle_entry_s *)realloc (bundle->entries, bundle->max * sizeof (struct stimc_port_bundle_entry_s));
+        assert (bundle->entries);
+    }
+
+    if (bundle->words + words > bundle->words_max) {
+        while (bundle->words + words > bundle->words_max) {
+            bundle->words_max = (bundle->words_max == 0) ? 16 : (2 * bundle->words_max);
+        }
+        bundle->buffer = (s_vpi_vecval *)realloc (bundle->buffer, bundle->words_max * sizeof (s_vpi_vecval));
+        assert (bundle->buffer);
+    }
+
+    struct stimc_port_bundle_entry_s *e = &(bundle->entries[bundle->num]);
+
+    e->port     = port;
+    e->offset   = bundle->words;
+    e->words    = words;
+    e->known    = false;
+    e->modified = false;
+
+    for (unsigned j = 0; j < words; j++) {
+        bundle->buffer[e->offset + j].aval = 0;
+        bundle->buffer[e->offset + j].bval = 0;
+    }
+
+    bundle->words += words;
+
+    return bundle->num++;
+}
+
+unsigned stimc_port_bundle_snapshot (stimc_port_bundle bundle)
+{
+    unsigned transfers = 0;
+
+    for (size_t i = 0; i < bundle->num; i++) {
+        struct stimc_port_bundle_entry_s *e = &(bundle->entries[i]);
+
+        const s_vpi_vecval *vec = e->port->cache;
+
+        if (vec == NULL) {
+            s_vpi_value v;
+
+            v.format = vpiVectorVal;
+            vpi_get_value (e->port->net, &v);
+            vec = v.value.vector;
+            transfers++;
+        }
+
+        s_vpi_vecval *buf = &(bundle->buffer[e->offset]);
+
+        for (unsigned j = 0; j < e->words; j++) {
+            buf[j] = vec[j];
+        }
+
+        /* bits beyond port width are kept 0 for comparison */
+        unsigned size = e->port->size;
+        if (size % 32 != 0) {
+            uint32_t mask = ((uint32_t)1 << (size % 32)) - 1;
+
+            buf[e->words - 1].aval = (PLI_INT32)((uint32_t)buf[e->words - 1].aval & mask);
+            buf[e->words - 1].bval = (PLI_INT32)((uint32_t)buf[e->words - 1].bval & mask);
+        }
+
+        e->known    = true;
+        e->modified = false;
+    }
+
+    return transfers;
+}
+
+unsigned stimc_port_bundle_commit (stimc_port_bundle bundle)
+{
+    unsigned transfers = 0;
+
+    for (size_t i = 0; i < bundle->num; i++) {
+        struct stimc_port_bundle_entry_s *e = &(bundle->entries[i]);
+
+        if (!e->modified) continue;
+
+        s_vpi_vecval *vec = &(bundle->buffer[e->offset]);
+        s_vpi_value   v;
+
+        if (e->port->size == 1) {
+            v.format       = vpiScalarVal;
+            v.value.scalar = stimc_vecval_scalar[(vec[0].aval & 1) | ((vec[0].bval & 1) << 1)];
+        } else {
+            v.format       = vpiVectorVal;
+            v.value.vector = vec;
+        }
+        vpi_put_value (e->port->net, &v, NULL, vpiNoDelay);
+        transfers++;
+
+        e->known    = true;
+        e->modified = false;
+    }
+
+    return transfers;
+}
+
+unsigned stimc_port_bundle_commit_nonblock (stimc_port_bundle bundle)
+{
+    unsigned scheduled = 0;
+
+    for (size_t i = 0; i < bundle->num; i++) {
+        struct stimc_port_bundle_entry_s *e = &(bundle->entries[i]);
+
+        if (!e->modified) continue;
+
+        stimc_net_set_vecval_nonblock (e->port, &(bundle->buffer[e->offset]));
+        scheduled++;
+
+        e->known    = true;
+        e->modified = false;
+    }
+
+    return scheduled;
+}
+
+uint64_t stimc_port_bundle_get_uint64 (stimc_port_bundle bundle, unsigned idx)
+{
+    assert (idx < bundle->num);
+
+    struct stimc_port_bundle_entry_s *e   = &(bundle->entries[idx]);
+    const s_vpi_vecval               *vec = &(bundle->buffer[e->offset]);
+
+    uint64_t result = 0;
+
+    for (unsigned i = 0; (i < e->words) && (i < 2); i++) {
+        /* prevent sign extension */
+        result |= (((uint64_t)(unsigned)vec[i].aval & ~((uint64_t)(unsigned)vec[i].bval)) << (32 * i));
+    }
+
+    return result;
+}
+
+bool stimc_port_bundle_is_xz (stimc_port_bundle bundle, unsigned idx)
+{
+    assert (idx < bundle->num);
+
+    struct stimc_port_bundle_entry_s *e   = &(bundle->entries[idx]);
+    const s_vpi_vecval               *vec = &(bundle->buffer[e->offset]);
+
+    for (unsigned i = 0; i < e->words; i++) {
+        if (vec[i].bval != 0) return true;
+    }
+    return false;
+}
+
+void stimc_port_bundle_get_vector (stimc_port_bundle bundle, unsigned idx, uint32_t *aval, uint32_t *bval, unsigned words)
+{
+    assert (idx < bundle->num);
+
+    struct stimc_port_bundle_entry_s *e   = &(bundle->entries[idx]);
+    const s_vpi_vecval               *vec = &(bundle->buffer[e->offset]);
+
+    for (unsigned i = 0; i < words; i++) {
+        uint32_t a = 0;
+        uint32_t b = 0;
+
+        if (i < e->words) {
+            a = (uint32_t)vec[i].aval;
+            b = (uint32_t)vec[i].bval;
+        }
+
+        if (bval != NULL) {
+            aval[i] = a;
+            bval[i] = b;
+        } else {
+            aval[i] = a & ~b;
+        }
+    }
+}
+
+static inline void stimc_port_bundle_word_set (stimc_port_bundle bundle, struct stimc_port_bundle_entry_s *e, unsigned j, uint32_t aval, uint32_t bval)
+{
+    unsigned size = e->port->size;
+
+    if ((j == e->words - 1) && (size % 32 != 0)) {
+        uint32_t mask = ((uint32_t)1 << (size % 32)) - 1;
+
+        aval &= mask;
+        bval &= mask;
+    }
+
+    s_vpi_vecval *w = &(bundle->buffer[e->offset + j]);
+
+    if (e->known && ((uint32_t)w->aval == aval) && ((uint32_t)w->bval == bval)) return;
+
+    w->aval     = (PLI_INT32)aval;
+    w->bval     = (PLI_INT32)bval;
+    e->modified = true;
+}
+
+void stimc_port_bundle_set_uint64 (stimc_port_bundle bundle, unsigned idx, uint64_t value)
+{
+    assert (idx < bundle->num);
+
+    struct stimc_port_bundle_entry_s *e = &(bundle->entries[idx]);
+
+    /* same as stimc_net_set_uint64: any non-zero value sets a single bit */
+    if (e->port->size == 1) value = (value != 0);
+
+    for (unsigned j = 0; j < e->words; j++) {
+        stimc_port_bundle_word_set (bundle, e, j, (j < 2) ? (uint32_t)(value >> (32 * j)) : 0, 0);
+    }
+}
+
+void stimc_port_bundle_set_z (stimc_port_bundle bundle, unsigned idx)
+{
+    assert (idx < bundle->num);
+
+    struct stimc_port_bundle_entry_s *e = &(bundle->entries[idx]);
+
+    for (unsigned j = 0; j < e->words; j++) {
+        stimc_port_bundle_word_set (bundle, e, j, 0x00000000, 0xffffffff);
+    }
+}
+
+void stimc_port_bundle_set_x (stimc_port_bundle bundle, unsigned idx)
+{
+    assert (idx < bundle->num);
+
+    struct stimc_port_bundle_entry_s *e = &(bundle->entries[idx]);
+
+    for (unsigned j = 0; j < e->words; j++) {
+        stimc_port_bundle_word_set (bundle, e, j, 0xffffffff, 0xffffffff);
+    }
+}
+
+void stimc_port_bundle_set_vector (stimc_port_bundle bundle, unsigned idx, const uint32_t *aval, const uint32_t *bval, unsigned words)
+{
+    assert (idx < bundle->num);
+
+    struct stimc_port_bundle_entry_s *e = &(bundle->entries[idx]);
+
+    for (unsigned j = 0; j < e->words; j++) {
+        uint32_t a = 0;
+        uint32_t b = 0;
+
+        if (j < words) {
+            a = aval[j];
+            b = (bval != NULL) ? bval[j] : 0;
+        }
+
+        stimc_port_bundle_word_set (bundle, e, j, a, b);
+    }
+}
+
 
 #ifndef STIMC_DISABLE_CLEANUP
 static void stimc_cleanup_init (void)
@@ -1808,7 +4558,7 @@ static void stimc_cleanup_init (void)
         data.index     = 0;
         data.user_data = (void *)(uintptr_t)i;
 
-        stimc_cleanup_data.cb_list[i] = vpi_register_cb (&data);
+        stimc_cleanup_data.cb_list[i] = stimc_vpi_register_cb (&data);
         assert (stimc_cleanup_data.cb_list[i]);
     }
 }
@@ -1830,7 +4580,7 @@ static void stimc_cleanup_run (struct stimc_cleanup_entry_s **queue)
     while (q != NULL) {
         struct stimc_cleanup_entry_s *e = q;
         q = e->next;
-        free (e);
+        stimc_slab_free (&stimc_cleanup_entry_slab, e);
     }
 
     *queue = NULL;
@@ -1846,7 +4596,7 @@ static struct stimc_cleanup_entry_s *stimc_cleanup_add (void (*callback)(void *u
 
 static inline struct stimc_cleanup_entry_s *stimc_cleanup_add_internal (struct stimc_cleanup_entry_s *queue, void (*callback)(void *userdata), void *userdata)
 {
-    struct stimc_cleanup_entry_s *e = (struct stimc_cleanup_entry_s *)malloc (sizeof (struct stimc_cleanup_entry_s));
+    struct stimc_cleanup_entry_s *e = (struct stimc_cleanup_entry_s *)stimc_slab_alloc (&stimc_cleanup_entry_slab);
 
     assert (e);
 
@@ -1870,7 +4620,7 @@ static void stimc_cleanup_internal (enum stimc_cleanup_reason reason __attribute
         for (enum stimc_cleanup_reason i = 0; i < STIMC_CUR__SIZE_; i++) {
             vpiHandle cb = stimc_cleanup_data.cb_list[i];
 
-            if (cb != NULL) vpi_remove_cb (cb);
+            if (cb != NULL) stimc_vpi_remove_cb (cb);
 
             stimc_cleanup_data.cb_list[i] = NULL;
         }
@@ -1880,6 +4630,47 @@ static void stimc_cleanup_internal (enum stimc_cleanup_reason reason __attribute
     stimc_thread_queue_free (&stimc_main_queue);
     stimc_thread_queue_free (&stimc_main_queue_shadow);
 
+    /* timer table */
+    assert (stimc_timers.num == 0);
+    if (stimc_timers.buckets != NULL) free (stimc_timers.buckets);
+    stimc_timers.buckets = NULL;
+    stimc_timers.max     = 0;
+
+    /* time unit might change on reset */
+    stimc_time_data.valid = false;
+
+    /* pending non-blocking assignments */
+    if ((stimc_nba_cb_handle != NULL) && p_data->remove_callbacks) {
+        stimc_vpi_remove_cb (stimc_nba_cb_handle);
+    }
+    stimc_nba_cb_handle = NULL;
+    stimc_net_nba_dirty_free ();
+
+    /* stack usage of all threads (finished now) */
+#ifdef STIMC_THREAD_STACK_WATERMARK
+    stimc_thread_stack_report ();
+#endif
+    stimc_thread_stack_usage_free ();
+
+    /* scheduler trace ends with simulation */
+    stimc_trace_free ();
+
+    /* scheduler profile */
+#ifdef STIMC_PROFILE
+    stimc_profile_report (stimc_profile.report_file);
+#endif
+    stimc_profile_free ();
+
+    /* pooled thread stacks */
+    stimc_thread_impl_cleanup ();
+
+    /* internal object allocators */
+    stimc_slab_reset (&stimc_thread_slab);
+    stimc_slab_reset (&stimc_event_slab);
+    stimc_slab_reset (&stimc_combination_slab);
+    stimc_slab_reset (&stimc_timer_slab);
+    stimc_slab_reset (&stimc_cleanup_entry_slab);
+
     stimc_finish_pending = false;
 }
 
@@ -1894,12 +4685,12 @@ static PLI_INT32 stimc_cleanup_callback (struct t_cb_data *cb_data)
     return 0;
 }
 
-static void stimc_cleanup_callback_wrap (void *userdata)
+static void stimc_cleanup_net_methods (void *userdata)
 {
-    struct stimc_callback_wrap_s *wrap = (struct stimc_callback_wrap_s *)userdata;
+    stimc_net net = (stimc_net)userdata;
 
-    vpi_remove_cb (wrap->cb_handle);
-    free (wrap);
+    net->methods->cleanup_self = NULL;
+    stimc_net_methods_free (net);
 }
 
 static void stimc_cleanup_thread (void *userdata)
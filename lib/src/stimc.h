@@ -55,8 +55,13 @@ extern const char *const stimc_version;        /**< @brief stimc version as stri
  */
 struct stimc_net_s {
     vpiHandle net;              /**< @brief vpi handle for access to net/port object */
+    unsigned  size;             /**< @brief Width of net/port in bits (fixed after elaboration) */
+    int       type;             /**< @brief vpi object type of net/port (vpiNet, vpiReg, ...) */
+    bool      is_signed;        /**< @brief Net/port is declared signed (sign extension of integer values) */
 
-    struct stimc_nba_data_s *nba; /**< @brief Data for scheduled non-blocking assignments */
+    struct stimc_nba_data_s    *nba;     /**< @brief Data for scheduled non-blocking assignments */
+    struct stimc_net_methods_s *methods; /**< @brief Data for registered value change methods */
+    s_vpi_vecval               *cache;   /**< @brief Cached value (see @ref stimc_net_enable_cache) or NULL */
 };
 typedef struct stimc_net_s *stimc_net;  /**< @brief Net base type. */
 typedef struct stimc_net_s *stimc_port; /**< @brief Port base type. */
@@ -144,6 +149,24 @@ stimc_register_startup_thread (void (*threadfunc)(void *userdata), void *userdat
  */
 void stimc_spawn_thread (void (*threadfunc)(void *userdata), void *userdata, size_t stacksize);
 
+/**
+ * @brief Enqueue a stackless thread (e.g. a C++20 coroutine).
+ * @param resumefunc Callback function accepting a single pointer as argument, called to run/resume the thread.
+ * @param freefunc Callback function to release userdata when the thread is removed (can be NULL).
+ * @param userdata Data argument to be handed to resumefunc and freefunc on call.
+ *
+ * A stackless thread has no stack and no context of its own, it is scheduled like
+ * a thread created by @ref stimc_spawn_thread, but run by calling resumefunc.
+ * The wait functions, @ref stimc_thread_halt, @ref stimc_thread_exit and @ref stimc_finish
+ * do not suspend a stackless thread: they only schedule its next resume
+ * and return immediately, so resumefunc must return afterwards without calling further wait functions.
+ * The result of a wait with timeout is available via @ref stimc_wait_timed_out on the next resume.
+ *
+ * freefunc is called when the thread is removed, either after it called @ref stimc_thread_exit
+ * or because simulation finished.
+ */
+void stimc_spawn_stackless_thread (void (*resumefunc)(void *userdata), void (*freefunc)(void *userdata), void *userdata);
+
 /**
  * @brief Register a function to be called when the current thread is terminated.
  * @param cleanfunc Callback function accepting a single pointer as argument.
@@ -202,6 +225,70 @@ void stimc_thread_resume_on_finish (bool resume);
  */
 bool stimc_thread_is_finished (void);
 
+/**
+ * @brief Query usage statistics of the thread stack pool.
+ * @param hits Pointer to store number of thread stacks reused from the pool (can be NULL).
+ * @param misses Pointer to store number of thread stacks newly allocated (can be NULL).
+ *
+ * Stacks of finished threads are kept in a pool (bucketed by size)
+ * up to a configurable number and are reused for newly spawned threads.
+ */
+void stimc_thread_stack_pool_stats (uint64_t *hits, uint64_t *misses);
+
+/**
+ * @brief Print maximum stack usage of finished threads per thread function.
+ *
+ * Only available if stimc is built with stack usage measurement (THREAD_STACK_WATERMARK),
+ * otherwise no threads are listed. Stacks are painted on creation
+ * and checked for the deepest overwritten address when the thread is finished
+ * (excluding the coroutine context pcl and libco keep at the low end of the stack).
+ * The report is printed automatically on end-of-simulation cleanup, after all remaining
+ * threads have been finished.
+ */
+void stimc_thread_stack_report (void);
+
+/**
+ * @brief Print scheduler profile.
+ * @param filename File to write the report to, NULL for the simulator console.
+ *
+ * Only available if stimc is built with profiling (PROFILE), otherwise
+ * a note is printed. The profile contains counters of vpi callbacks, main queue runs
+ * per time step, triggered events, woken threads, called methods and flushed
+ * non-blocking assignments, the wall time spent in user thread code, user method code,
+ * stimc bookkeeping and outside of stimc, and context switches per thread function.
+ * The report is printed automatically on end-of-simulation cleanup
+ * (see @ref stimc_profile_set_report_file).
+ */
+void stimc_profile_report (const char *filename);
+
+/**
+ * @brief Select destination of the end-of-simulation profile report.
+ * @param filename File to write the report to, NULL for the simulator console (default).
+ *
+ * Applies to the next automatic report from end-of-simulation cleanup.
+ */
+void stimc_profile_set_report_file (const char *filename);
+
+/**
+ * @brief Start tracing of thread scheduling.
+ * @param filename File to write the trace to (Chrome trace event JSON).
+ * @return false if not available or the file could not be opened.
+ *
+ * Only available if stimc is built with tracing (TRACE). Records every thread run
+ * (resume until suspend), event trigger, timer registration and method call
+ * with host wall-clock time and simulation time. Modules are shown as processes,
+ * stimc threads as threads named by their thread function (methods of a module
+ * share one track). The trace can be loaded in Perfetto or chrome://tracing.
+ * It is also started by the plusarg @c +stimc_trace=<file> on the first module initialization
+ * and is stopped at end of simulation (also if stimc is built without cleanup).
+ */
+bool stimc_trace_start (const char *filename);
+
+/**
+ * @brief Stop tracing, flush and close the trace file.
+ */
+void stimc_trace_stop (void);
+
 
 /******************************************************************************************************/
 /* time/wait */
@@ -226,6 +313,7 @@ enum stimc_time_unit {
  *
  * Suspends the current thread (created with @ref stimc_spawn_thread)
  * for the specified amount of simulation time.
+ * Times beyond the maximum simulation time are clamped to it (with a message).
  */
 void stimc_wait_time (uint64_t time, enum stimc_time_unit exp);
 
@@ -235,6 +323,8 @@ void stimc_wait_time (uint64_t time, enum stimc_time_unit exp);
  *
  * Suspends the current thread (created with @ref stimc_spawn_thread)
  * for the specified amount of simulation time in seconds.
+ * Times beyond the maximum simulation time are clamped to it,
+ * negative times are reported and treated as 0.
  */
 void stimc_wait_time_seconds (double time);
 
@@ -279,6 +369,9 @@ stimc_event stimc_event_create (void);
 /**
  * @brief Free resources of a @ref stimc_event.
  * @param event The event to free.
+ *
+ * Can be called from a method registered to the event while it is triggered:
+ * remaining methods are skipped and the event is released after the method returns.
  */
 void stimc_event_free (stimc_event event);
 
@@ -397,9 +490,24 @@ bool stimc_wait_event_combination_timeout_seconds (stimc_event_combination combi
 /**
  * @brief Trigger a @ref stimc_event.
  * @param event The event to trigger.
+ *
+ * Methods registered via @ref stimc_register_event_method are called directly,
+ * waiting threads are resumed afterwards within the current simulation time step.
  */
 void stimc_trigger_event (stimc_event event);
 
+/**
+ * @brief Register a callback on trigger of specified @ref stimc_event.
+ * @param methodfunc Callback function accepting a single pointer as argument.
+ * @param userdata Data argument to be handed to methodfunc on call.
+ * @param event @ref stimc_event to observe.
+ *
+ * The callback function will be called directly by @ref stimc_trigger_event and not in a separate thread.
+ * This means it cannot make use of wait functions, but does not require a stack or thread switch.
+ * In case you need to combine the event with a thread you might use a separate thread waiting for the event.
+ */
+void stimc_register_event_method (void (*methodfunc)(void *userdata), void *userdata, stimc_event event);
+
 /**
  * @brief Check, whether last wait with timeout returned due to timeout.
  *
@@ -457,11 +565,21 @@ void stimc_net_set_int32_nonblock (stimc_net net, int32_t value);
 /**
  * @brief Get port/net value.
  * @param net The port/net to assign.
- * @return Value as 32 bit integer.
+ * @return Value as 32 bit integer (sign extended for signed nets narrower than 32 bits).
  * @see @ref stimc_net_get_uint64, @ref stimc_net_get_bits_uint64.
  */
 static inline int32_t stimc_net_get_int32 (stimc_net net)
 {
+    if (net->cache != NULL) {
+        uint32_t value = net->cache[0].aval & ~net->cache[0].bval;
+
+        if (net->is_signed && (net->size < 32) && ((value >> (net->size - 1)) & 1)) {
+            value |= UINT32_MAX << net->size;
+        }
+
+        return (int32_t)value;
+    }
+
     s_vpi_value v;
 
     v.format = vpiIntVal;
@@ -477,7 +595,7 @@ static inline int32_t stimc_net_get_int32 (stimc_net net)
  */
 static inline unsigned stimc_net_size (stimc_net net)
 {
-    return vpi_get (vpiSize, net->net);
+    return net->size;
 }
 
 /**
@@ -740,6 +858,49 @@ static inline void stimc_net_set_double (stimc_net net, double value)
  */
 uint64_t stimc_net_get_uint64 (stimc_net net);
 
+/**
+ * @brief Keep a cached copy of the port/net value.
+ * @param net Port/net to cache.
+ *
+ * Registers a value change callback keeping the latest value of @c net,
+ * so reading @c net (e.g. via @ref stimc_net_get_uint64 or @ref stimc_net_is_xz)
+ * does not need a simulator access. The cache is updated before methods and threads
+ * waiting for the change are run.
+ * Meant for frequently read input ports that change rarely.
+ * Edge methods of a cached net are triggered by its least significant bit.
+ */
+void stimc_net_enable_cache (stimc_net net);
+
+/**
+ * @brief Immediate assignment of arbitrary width.
+ * @param net Port/net to assign.
+ * @param aval Value words (32 bit each, least significant word first).
+ * @param bval x/z words corresponding to @c aval or NULL for 2-state values.
+ * @param words Number of words in @c aval (and @c bval).
+ * @see @ref stimc_net_set_uint64.
+ *
+ * Sets port/net to specified value similar to using a verilog blocking assignment
+ * with a single simulator value transfer. Bits are encoded as in vpi vector values:
+ * aval/bval bit pairs of 0/0 for 0, 1/0 for 1, 0/1 for z and 1/1 for x.
+ * Missing words are assigned 0, words beyond the width of @c net are ignored.
+ */
+void stimc_net_set_vector (stimc_net net, const uint32_t *aval, const uint32_t *bval, unsigned words);
+
+/**
+ * @brief Value read of arbitrary width.
+ * @param net Port/net to read.
+ * @param aval Buffer for value words (32 bit each, least significant word first).
+ * @param bval Buffer for x/z words corresponding to @c aval or NULL.
+ * @param words Number of words in @c aval (and @c bval).
+ * @see @ref stimc_net_get_uint64.
+ *
+ * Reads port/net with a single simulator value transfer.
+ * In case @c bval is NULL, x/z bits are read as 0 in @c aval,
+ * otherwise the encoding is as described in @ref stimc_net_set_vector.
+ * Words beyond the width of @c net are filled with 0.
+ */
+void stimc_net_get_vector (stimc_net net, uint32_t *aval, uint32_t *bval, unsigned words);
+
 /**
  * @brief Real value read.
  * @param net Port/net to read.
@@ -756,6 +917,254 @@ static inline double stimc_net_get_double (stimc_net net)
 }
 
 
+/******************************************************************************************************/
+/* port bundles */
+/******************************************************************************************************/
+
+/**
+ * @brief Port bundle type.
+ *
+ * Groups ports (e.g. of a bus interface) for reading them in a single pass
+ * into a contiguous value buffer (@ref stimc_port_bundle_snapshot) and writing
+ * modified values back in a single pass (@ref stimc_port_bundle_commit).
+ */
+typedef struct stimc_port_bundle_s *stimc_port_bundle;
+
+/**
+ * @brief Create an empty port bundle.
+ * @return the new bundle.
+ */
+stimc_port_bundle stimc_port_bundle_init (void);
+
+/**
+ * @brief Port bundle free function.
+ * @param bundle Bundle to free.
+ *
+ * Does not free the ports added to the bundle.
+ */
+void stimc_port_bundle_free (stimc_port_bundle bundle);
+
+/**
+ * @brief Add port to bundle.
+ * @param bundle Bundle to extend.
+ * @param port Port to add (not a real valued port).
+ * @return index of @c port within @c bundle.
+ *
+ * The port must remain valid as long as the bundle is used.
+ */
+unsigned stimc_port_bundle_add (stimc_port_bundle bundle, stimc_port port);
+
+/**
+ * @brief Read all ports of bundle.
+ * @param bundle Bundle to read.
+ * @return number of simulator value transfers.
+ *
+ * Reads the current values of all ports into the bundle buffer.
+ * Ports with enabled value cache (@ref stimc_net_enable_cache) are
+ * copied from their cache without simulator access.
+ * Values set but not yet committed are discarded.
+ */
+unsigned stimc_port_bundle_snapshot (stimc_port_bundle bundle);
+
+/**
+ * @brief Immediate assignment of modified ports of bundle.
+ * @param bundle Bundle to write.
+ * @return number of simulator value transfers.
+ *
+ * Writes all ports, whose buffered value was changed by a set function
+ * since the last snapshot or commit, similar to verilog blocking assignments.
+ * Setting a port to the value already in the buffer does not mark it modified.
+ */
+unsigned stimc_port_bundle_commit (stimc_port_bundle bundle);
+
+/**
+ * @brief Non-blocking assignment of modified ports of bundle.
+ * @param bundle Bundle to write.
+ * @return number of ports scheduled for assignment.
+ * @see @ref stimc_port_bundle_commit.
+ *
+ * Similar to @ref stimc_port_bundle_commit, but the assignments occur
+ * similar to verilog non-blocking assignments after current simulator cycle.
+ */
+unsigned stimc_port_bundle_commit_nonblock (stimc_port_bundle bundle);
+
+/**
+ * @brief Buffered port value.
+ * @param bundle Bundle of port.
+ * @param idx Index of port as returned by @ref stimc_port_bundle_add.
+ * @return Value as 64 bit unsigned integer (x/z bits are read as 0).
+ */
+uint64_t stimc_port_bundle_get_uint64 (stimc_port_bundle bundle, unsigned idx);
+
+/**
+ * @brief Check buffered port value for x/z bits.
+ * @param bundle Bundle of port.
+ * @param idx Index of port as returned by @ref stimc_port_bundle_add.
+ * @return true in case buffered value contains x or z bits.
+ */
+bool stimc_port_bundle_is_xz (stimc_port_bundle bundle, unsigned idx);
+
+/**
+ * @brief Buffered port value of arbitrary width.
+ * @param bundle Bundle of port.
+ * @param idx Index of port as returned by @ref stimc_port_bundle_add.
+ * @param aval Buffer for value words.
+ * @param bval Buffer for x/z words or NULL.
+ * @param words Number of words in @c aval (and @c bval).
+ * @see @ref stimc_net_get_vector for encoding.
+ */
+void stimc_port_bundle_get_vector (stimc_port_bundle bundle, unsigned idx, uint32_t *aval, uint32_t *bval, unsigned words);
+
+/**
+ * @brief Set buffered port value.
+ * @param bundle Bundle of port.
+ * @param idx Index of port as returned by @ref stimc_port_bundle_add.
+ * @param value Value as 64 bit unsigned integer.
+ *
+ * Takes effect on next commit.
+ */
+void stimc_port_bundle_set_uint64 (stimc_port_bundle bundle, unsigned idx, uint64_t value);
+
+/**
+ * @brief Set buffered port value to z.
+ * @param bundle Bundle of port.
+ * @param idx Index of port as returned by @ref stimc_port_bundle_add.
+ *
+ * Takes effect on next commit.
+ */
+void stimc_port_bundle_set_z (stimc_port_bundle bundle, unsigned idx);
+
+/**
+ * @brief Set buffered port value to x.
+ * @param bundle Bundle of port.
+ * @param idx Index of port as returned by @ref stimc_port_bundle_add.
+ *
+ * Takes effect on next commit.
+ */
+void stimc_port_bundle_set_x (stimc_port_bundle bundle, unsigned idx);
+
+/**
+ * @brief Set buffered port value of arbitrary width.
+ * @param bundle Bundle of port.
+ * @param idx Index of port as returned by @ref stimc_port_bundle_add.
+ * @param aval Value words.
+ * @param bval x/z words or NULL for 2-state values.
+ * @param words Number of words in @c aval (and @c bval).
+ * @see @ref stimc_net_set_vector for encoding.
+ *
+ * Takes effect on next commit.
+ */
+void stimc_port_bundle_set_vector (stimc_port_bundle bundle, unsigned idx, const uint32_t *aval, const uint32_t *bval, unsigned words);
+
+
+/******************************************************************************************************/
+/* memories */
+/******************************************************************************************************/
+
+/**
+ * @brief Memory (verilog reg array) handle type.
+ * @see @ref stimc_memory_init.
+ *
+ * Words are addressed by their verilog index.
+ */
+typedef struct stimc_memory_s *stimc_memory;
+
+/**
+ * @brief File formats for memory load/dump.
+ */
+enum stimc_memory_format {
+    STIMC_MEMORY_FORMAT_HEX, /**< @brief Text file as used by verilog @c $readmemh / @c $writememh (one word per line on dump). */
+    STIMC_MEMORY_FORMAT_BIN, /**< @brief Binary file of consecutive words, each little endian with width rounded up to full bytes. */
+};
+
+/**
+ * @brief Memory word width.
+ * @param mem Memory handle.
+ * @return Width of memory words in bits.
+ */
+unsigned stimc_memory_width (stimc_memory mem);
+
+/**
+ * @brief Memory depth.
+ * @param mem Memory handle.
+ * @return Number of memory words.
+ */
+unsigned stimc_memory_depth (stimc_memory mem);
+
+/**
+ * @brief Memory base address.
+ * @param mem Memory handle.
+ * @return Lowest verilog index of memory words.
+ */
+int32_t stimc_memory_base (stimc_memory mem);
+
+/**
+ * @brief Immediate assignment of memory word.
+ * @param mem Memory handle.
+ * @param addr Word address.
+ * @param value Value as 64 bit unsigned integer (upper bits of wider words are set to 0).
+ */
+void stimc_memory_set_uint64 (stimc_memory mem, int32_t addr, uint64_t value);
+
+/**
+ * @brief Memory word read.
+ * @param mem Memory handle.
+ * @param addr Word address.
+ * @return Value as 64 bit unsigned integer (x/z bits are read as 0).
+ */
+uint64_t stimc_memory_get_uint64 (stimc_memory mem, int32_t addr);
+
+/**
+ * @brief Immediate assignment of memory word range.
+ * @param mem Memory handle.
+ * @param addr Address of first word.
+ * @param num Number of words.
+ * @param data Word values, each word occupying (width + 31) / 32 consecutive 32 bit words (least significant first).
+ */
+void stimc_memory_write (stimc_memory mem, int32_t addr, unsigned num, const uint32_t *data);
+
+/**
+ * @brief Memory word range read.
+ * @param mem Memory handle.
+ * @param addr Address of first word.
+ * @param num Number of words.
+ * @param data Buffer for word values in layout as for @ref stimc_memory_write (x/z bits are read as 0).
+ *
+ * Large memories can be read in a streaming manner by reading consecutive ranges
+ * into a buffer of limited size.
+ */
+void stimc_memory_read (stimc_memory mem, int32_t addr, unsigned num, uint32_t *data);
+
+/**
+ * @brief Load memory from file.
+ * @param mem Memory handle.
+ * @param filename File to load.
+ * @param format File format.
+ * @param addr Address of first word to load.
+ * @param num Maximum number of words to load or 0 for loading up to the end of the memory.
+ * @return false in case the file could not be read or contains invalid data, true otherwise.
+ *
+ * The file is mapped into memory (where supported) and all words are assigned
+ * in a single pass. Hex files may contain comments, @c x / @c z digits and
+ * @c \@address markers (addresses outside the range given are skipped).
+ */
+bool stimc_memory_load (stimc_memory mem, const char *filename, enum stimc_memory_format format, int32_t addr, unsigned num);
+
+/**
+ * @brief Dump memory to file.
+ * @param mem Memory handle.
+ * @param filename File to write.
+ * @param format File format.
+ * @param addr Address of first word to dump.
+ * @param num Number of words to dump or 0 for dumping up to the end of the memory.
+ * @return false in case the file could not be written, true otherwise.
+ *
+ * Words are streamed to the file one at a time.
+ * In binary files x/z bits are written as 0.
+ */
+bool stimc_memory_dump (stimc_memory mem, const char *filename, enum stimc_memory_format format, int32_t addr, unsigned num);
+
+
 /******************************************************************************************************/
 /* modules */
 /******************************************************************************************************/
@@ -764,7 +1173,8 @@ static inline double stimc_net_get_double (stimc_net net)
  * @brief Module type.
  */
 typedef struct stimc_module_s {
-    vpiHandle mod; /**< @brief vpi handle for access. */
+    vpiHandle                   mod;   /**< @brief vpi handle for access. */
+    struct stimc_module_index_s *index; /**< @brief Name lookup index for ports and parameters (built on first lookup). */
 } stimc_module;
 
 /**
@@ -827,6 +1237,20 @@ stimc_parameter stimc_parameter_init (stimc_module *m, const char *name);
  */
 void stimc_parameter_free (stimc_parameter p);
 
+/**
+ * @brief Memory creation function.
+ * @param m Pointer to module instance the memory belongs to.
+ * @param name Memory name or hierarchical name (relative to module or absolute) e.g. for memories inside the DUT.
+ * @return a newly created memory handle for the specified memory.
+ */
+stimc_memory stimc_memory_init (stimc_module *m, const char *name);
+
+/**
+ * @brief Memory handle free function.
+ * @param mem memory handle.
+ */
+void stimc_memory_free (stimc_memory mem);
+
 /**
  * @brief module initialization routine macro.
  *
@@ -0,0 +1,142 @@
+/*
+ *  stimc is a lightweight verilog-vpi wrapper for stimuli generation.
+ *  Copyright (C) 2019-2022  Andreas Dixius, Felix Neumärker
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file
+ * @brief stimc fixed-size slab allocator for internal objects.
+ */
+
+#ifndef STIMC_SLAB_INL
+#define STIMC_SLAB_INL
+
+#ifndef STIMC_USE_INTERNAL_HEADER
+#error "stimc internal header should not be included outside of stimc core"
+#endif
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <assert.h>
+
+/* number of objects allocated at once */
+#define STIMC_SLAB_CHUNK_OBJS 64
+
+/* object alignment */
+#define STIMC_SLAB_ALIGN 16
+
+struct stimc_slab_chunk_s {
+    struct stimc_slab_chunk_s *next;
+};
+
+#define STIMC_SLAB_CHUNK_HEADER_SIZE (((sizeof (struct stimc_slab_chunk_s) - 1) / STIMC_SLAB_ALIGN + 1) * STIMC_SLAB_ALIGN)
+
+struct stimc_slab_free_s {
+    struct stimc_slab_free_s *next;
+};
+
+struct stimc_slab_s {
+    size_t                     size;   /* object size (aligned) */
+    size_t                     used;   /* number of objects in use */
+    struct stimc_slab_free_s  *free;   /* free objects */
+    struct stimc_slab_chunk_s *chunks; /* allocated chunks */
+};
+
+/* static initializer for a slab of objects of given type */
+#define STIMC_SLAB_INIT(type) {(((sizeof (type) - 1) / STIMC_SLAB_ALIGN + 1) * STIMC_SLAB_ALIGN), 0, NULL, NULL}
+
+#ifndef STIMC_DISABLE_SLAB_ALLOC
+static inline void stimc_slab_grow (struct stimc_slab_s *slab)
+{
+    struct stimc_slab_chunk_s *c = (struct stimc_slab_chunk_s *)malloc (STIMC_SLAB_CHUNK_HEADER_SIZE + STIMC_SLAB_CHUNK_OBJS * slab->size);
+
+    assert (c);
+
+    c->next      = slab->chunks;
+    slab->chunks = c;
+
+    char *objs = (char *)c + STIMC_SLAB_CHUNK_HEADER_SIZE;
+
+    for (size_t i = STIMC_SLAB_CHUNK_OBJS; i > 0; i--) {
+        struct stimc_slab_free_s *f = (struct stimc_slab_free_s *)(objs + (i - 1) * slab->size);
+        f->next    = slab->free;
+        slab->free = f;
+    }
+}
+
+static inline void *stimc_slab_alloc (struct stimc_slab_s *slab)
+{
+    if (slab->free == NULL) stimc_slab_grow (slab);
+
+    struct stimc_slab_free_s *f = slab->free;
+    slab->free = f->next;
+    slab->used++;
+
+    return (void *)f;
+}
+
+static inline void stimc_slab_free (struct stimc_slab_s *slab, void *ptr)
+{
+    if (ptr == NULL) return;
+
+    assert (slab->used > 0);
+
+    struct stimc_slab_free_s *f = (struct stimc_slab_free_s *)ptr;
+    f->next    = slab->free;
+    slab->free = f;
+    slab->used--;
+}
+
+/* release all chunks at once - only possible if no object is in use anymore
+ * (e.g. global events created via stimc++ might outlive the simulation) */
+static inline void stimc_slab_reset (struct stimc_slab_s *slab)
+{
+    if (slab->used != 0) return;
+
+    while (slab->chunks != NULL) {
+        struct stimc_slab_chunk_s *c = slab->chunks;
+        slab->chunks = c->next;
+        free (c);
+    }
+
+    slab->free = NULL;
+}
+#else
+static inline void *stimc_slab_alloc (struct stimc_slab_s *slab)
+{
+    void *ptr = malloc (slab->size);
+
+    assert (ptr);
+    slab->used++;
+
+    return ptr;
+}
+
+static inline void stimc_slab_free (struct stimc_slab_s *slab, void *ptr)
+{
+    if (ptr == NULL) return;
+
+    slab->used--;
+    free (ptr);
+}
+
+static inline void stimc_slab_reset (struct stimc_slab_s *slab __attribute__((unused)))
+{}
+#endif
+
+#endif
+
@@ -30,6 +30,9 @@
 #endif
 
 #include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
 
 /*******************************************************************************/
 /* implementation variants - default: pcl */
@@ -111,6 +114,9 @@ stimc_thread_impl STIMC_INTERNAL_ATTR stimc_thread_impl_create (void (*func)(STI
 void STIMC_INTERNAL_ATTR              stimc_thread_impl_run (stimc_thread_impl t);
 void STIMC_INTERNAL_ATTR              stimc_thread_impl_suspend (void);
 void STIMC_INTERNAL_ATTR              stimc_thread_impl_delete (stimc_thread_impl t);
+void STIMC_INTERNAL_ATTR              stimc_thread_impl_cleanup (void);
+void STIMC_INTERNAL_ATTR              stimc_thread_impl_stack_pool_stats (uint64_t *hits, uint64_t *misses);
+void STIMC_INTERNAL_ATTR              stimc_thread_impl_stack_usage (stimc_thread_impl t, size_t *used, size_t *size);
 
 #ifdef __cplusplus
 /* *auto-indent-off* */
@@ -120,6 +126,257 @@ void STIMC_INTERNAL_ATTR              stimc_thread_impl_delete (stimc_thread_imp
 #endif
 
 
+/*******************************************************************************/
+/* stack pool - used by all implementations defined in current unit */
+/*******************************************************************************/
+#if defined(STIMC_THREAD_IMPL_INLINE) || defined(STIMC_THREAD_IMPL_EXTERNAL_DEF)
+
+#ifndef STIMC_THREAD_STACK_POOL_MAX
+/* default number of finished stacks kept for reuse */
+#define STIMC_THREAD_STACK_POOL_MAX 64
+#endif
+
+#ifdef STIMC_DISABLE_THREAD_STACK_POOL
+#undef STIMC_THREAD_STACK_POOL_MAX
+#define STIMC_THREAD_STACK_POOL_MAX 0
+#endif
+
+/* stacks are mapped on demand with guard page where available */
+#if !defined(STIMC_DISABLE_THREAD_STACK_MMAP) && (defined(__unix__) || defined(__APPLE__))
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(MAP_ANONYMOUS)
+#define STIMC_THREAD_STACK_MMAP
+#define STIMC_THREAD_STACK_MAP_ANONYMOUS MAP_ANONYMOUS
+#elif defined(MAP_ANON)
+#define STIMC_THREAD_STACK_MMAP
+#define STIMC_THREAD_STACK_MAP_ANONYMOUS MAP_ANON
+#endif
+
+#ifdef MAP_NORESERVE
+#define STIMC_THREAD_STACK_MAP_NORESERVE MAP_NORESERVE
+#else
+#define STIMC_THREAD_STACK_MAP_NORESERVE 0
+#endif
+
+#ifdef MAP_STACK
+#define STIMC_THREAD_STACK_MAP_STACK MAP_STACK
+#else
+#define STIMC_THREAD_STACK_MAP_STACK 0
+#endif
+#endif
+
+/* reused stacks might still be poisoned by frames of the previous thread */
+#if defined(__SANITIZE_ADDRESS__)
+#include <sanitizer/asan_interface.h>
+#define STIMC_THREAD_STACK_UNPOISON(addr, size) ASAN_UNPOISON_MEMORY_REGION (addr, size)
+#define STIMC_THREAD_STACK_NO_ASAN              __attribute__((no_sanitize_address))
+#else
+#define STIMC_THREAD_STACK_UNPOISON(addr, size) ((void)(addr), (void)(size))
+#define STIMC_THREAD_STACK_NO_ASAN
+#endif
+
+#ifdef STIMC_THREAD_STACK_WATERMARK
+/* pattern stacks are painted with for usage measurement (commits the whole stack memory) */
+#define STIMC_THREAD_STACK_PAINT UINT64_C(0x5354494d43535441)
+/* stacks grow downwards, lowest bytes are used by the coroutine context:
+ * pcl places its coroutine struct (holding a ucontext_t) there, libco only a few registers */
+#ifdef STIMC_THREAD_IMPL_PCL
+#include <ucontext.h>
+#define STIMC_THREAD_STACK_PAINT_SKIP (sizeof (ucontext_t) + 512)
+#else
+#define STIMC_THREAD_STACK_PAINT_SKIP 512
+#endif
+#endif
+
+/* stacks are bucketed by size rounded up to the next power of 2 */
+#define STIMC_THREAD_STACK_BUCKET_MIN 12
+#define STIMC_THREAD_STACK_BUCKET_NUM (sizeof (size_t) * 8)
+
+/* stack header - placed in front of the actual stack memory (malloc)
+ * or behind it (mmap: guard page | stack memory | header) */
+struct stimc_thread_stack_s {
+    struct stimc_thread_stack_s *next;   /* next free stack in bucket */
+    size_t                       size;   /* usable stack size */
+    unsigned                     bucket; /* pool bucket */
+    void                        *co;     /* coroutine handle (inline implementations) */
+    bool                         co_own; /* coroutine runs on its own stack (libco without co_derive) */
+};
+
+#define STIMC_THREAD_STACK_HEADER_SIZE (((sizeof (struct stimc_thread_stack_s) - 1) / 64 + 1) * 64)
+
+struct stimc_thread_stack_pool_s {
+    struct stimc_thread_stack_s *free[STIMC_THREAD_STACK_BUCKET_NUM];
+    size_t                       num;
+    size_t                       max;
+    uint64_t                     hits;
+    uint64_t                     misses;
+};
+
+static struct stimc_thread_stack_pool_s stimc_thread_stack_pool = {{NULL}, 0, STIMC_THREAD_STACK_POOL_MAX, 0, 0};
+
+static inline void *stimc_thread_stack_mem (struct stimc_thread_stack_s *s)
+{
+#ifdef STIMC_THREAD_STACK_MMAP
+    return (void *)((char *)s - s->size);
+#else
+    return (void *)((char *)s + STIMC_THREAD_STACK_HEADER_SIZE);
+#endif
+}
+
+/* stack header from top of stack memory */
+static inline struct stimc_thread_stack_s *stimc_thread_stack_from_top (void *top, size_t size)
+{
+#ifdef STIMC_THREAD_STACK_MMAP
+    (void)size;
+    return (struct stimc_thread_stack_s *)top;
+#else
+    return (struct stimc_thread_stack_s *)((char *)top - size - STIMC_THREAD_STACK_HEADER_SIZE);
+#endif
+}
+
+#ifdef STIMC_THREAD_STACK_MMAP
+static inline size_t stimc_thread_stack_page_size (void)
+{
+    static size_t page_size = 0;
+
+    if (page_size == 0) {
+        long result = sysconf (_SC_PAGESIZE);
+        assert (result > 0);
+        page_size = (size_t)result;
+    }
+
+    return page_size;
+}
+#endif
+
+/* allocate new stack of given bucket's size
+ * mmap: memory is only committed by the kernel when used, overflows hit the guard page */
+static inline struct stimc_thread_stack_s *stimc_thread_stack_alloc (unsigned bucket)
+{
+    struct stimc_thread_stack_s *s;
+
+#ifdef STIMC_THREAD_STACK_MMAP
+    size_t page_size = stimc_thread_stack_page_size ();
+    size_t map_size  = (((size_t)1 << bucket) + STIMC_THREAD_STACK_HEADER_SIZE + page_size - 1) / page_size * page_size;
+
+    char *map = (char *)mmap (NULL, page_size + map_size, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | STIMC_THREAD_STACK_MAP_ANONYMOUS | STIMC_THREAD_STACK_MAP_NORESERVE | STIMC_THREAD_STACK_MAP_STACK,
+                              -1, 0);
+    assert (map != MAP_FAILED);
+
+    int result = mprotect (map, page_size, PROT_NONE);
+    assert (result == 0);
+    (void)result;
+
+    s       = (struct stimc_thread_stack_s *)(map + page_size + map_size - STIMC_THREAD_STACK_HEADER_SIZE);
+    s->size = map_size - STIMC_THREAD_STACK_HEADER_SIZE;
+#else
+    s = (struct stimc_thread_stack_s *)malloc (STIMC_THREAD_STACK_HEADER_SIZE + ((size_t)1 << bucket));
+    assert (s);
+
+    s->size = (size_t)1 << bucket;
+#endif
+
+    s->bucket = bucket;
+
+    return s;
+}
+
+static inline void stimc_thread_stack_free (struct stimc_thread_stack_s *s)
+{
+#ifdef STIMC_THREAD_STACK_MMAP
+    size_t page_size = stimc_thread_stack_page_size ();
+
+    int result = munmap ((char *)stimc_thread_stack_mem (s) - page_size, page_size + s->size + STIMC_THREAD_STACK_HEADER_SIZE);
+    assert (result == 0);
+    (void)result;
+#else
+    free (s);
+#endif
+}
+
+static inline struct stimc_thread_stack_s *stimc_thread_stack_get (size_t size)
+{
+    unsigned bucket = STIMC_THREAD_STACK_BUCKET_MIN;
+
+    while (((size_t)1 << bucket) < size) {
+        bucket++;
+        assert (bucket < STIMC_THREAD_STACK_BUCKET_NUM);
+    }
+
+    struct stimc_thread_stack_s *s = stimc_thread_stack_pool.free[bucket];
+
+    if (s != NULL) {
+        stimc_thread_stack_pool.free[bucket] = s->next;
+        stimc_thread_stack_pool.num--;
+        stimc_thread_stack_pool.hits++;
+
+        STIMC_THREAD_STACK_UNPOISON (stimc_thread_stack_mem (s), s->size);
+    } else {
+        s = stimc_thread_stack_alloc (bucket);
+        stimc_thread_stack_pool.misses++;
+    }
+
+    s->next   = NULL;
+    s->co     = NULL;
+    s->co_own = false;
+
+#ifdef STIMC_THREAD_STACK_WATERMARK
+    uint64_t *paint = (uint64_t *)stimc_thread_stack_mem (s);
+    for (size_t i = 0; i < s->size / sizeof (uint64_t); i++) {
+        paint[i] = STIMC_THREAD_STACK_PAINT;
+    }
+#endif
+
+    return s;
+}
+
+/* maximum stack usage since creation (0 if not measured) */
+static inline size_t STIMC_THREAD_STACK_NO_ASAN stimc_thread_stack_used (struct stimc_thread_stack_s *s)
+{
+#ifdef STIMC_THREAD_STACK_WATERMARK
+    const uint64_t *paint = (const uint64_t *)stimc_thread_stack_mem (s);
+    size_t          num   = s->size / sizeof (uint64_t);
+    size_t          i     = STIMC_THREAD_STACK_PAINT_SKIP / sizeof (uint64_t);
+
+    while ((i < num) && (paint[i] == STIMC_THREAD_STACK_PAINT)) i++;
+
+    return s->size - i * sizeof (uint64_t);
+#else
+    (void)s;
+    return 0;
+#endif
+}
+
+static inline void stimc_thread_stack_put (struct stimc_thread_stack_s *s)
+{
+    if (stimc_thread_stack_pool.num >= stimc_thread_stack_pool.max) {
+        stimc_thread_stack_free (s);
+        return;
+    }
+
+    s->next = stimc_thread_stack_pool.free[s->bucket];
+    stimc_thread_stack_pool.free[s->bucket] = s;
+    stimc_thread_stack_pool.num++;
+}
+
+static inline void stimc_thread_stack_pool_clear (void)
+{
+    for (unsigned i = 0; i < STIMC_THREAD_STACK_BUCKET_NUM; i++) {
+        while (stimc_thread_stack_pool.free[i] != NULL) {
+            struct stimc_thread_stack_s *s = stimc_thread_stack_pool.free[i];
+            stimc_thread_stack_pool.free[i] = s->next;
+            stimc_thread_stack_free (s);
+        }
+    }
+
+    stimc_thread_stack_pool.num = 0;
+}
+#endif
+
+
 /*******************************************************************************/
 /* PCL + LIBCO threads - inline definition */
 /*******************************************************************************/
@@ -130,12 +387,12 @@ void STIMC_INTERNAL_ATTR              stimc_thread_impl_delete (stimc_thread_imp
 #include <limits.h>
 
 #define STIMC_STACKSIZE_MAX (size_t)INT_MAX
-typedef coroutine_t stimc_thread_impl;
+typedef coroutine_t stimc_thread_impl_co;
 
-#define STIMC_CO_CREATE(func, stacksize) co_create  (func, NULL, NULL, stacksize)
-#define STIMC_CO_CURRENT()               co_current ()
-#define STIMC_CO_SWITCH(thread)          co_call    (thread)
-#define STIMC_CO_DELETE(thread)          co_delete  (thread)
+#define STIMC_CO_CREATE(func, t, stacksize) co_create  (func, NULL, stimc_thread_stack_mem (t), (t)->size)
+#define STIMC_CO_CURRENT()                  co_current ()
+#define STIMC_CO_SWITCH(thread)             co_call    (thread)
+#define STIMC_CO_DELETE(t)                  co_delete  ((coroutine_t)(t)->co)
 #endif
 
 #ifdef STIMC_THREAD_IMPL_LIBCO
@@ -144,36 +401,66 @@ typedef coroutine_t stimc_thread_impl;
 #include <limits.h>
 
 #define STIMC_STACKSIZE_MAX (size_t)UINT_MAX
-typedef cothread_t stimc_thread_impl;
+typedef cothread_t stimc_thread_impl_co;
+
+/* co_derive keeps the libco context within the provided (pooled) memory - nothing to delete besides the stack itself.
+ * Without co_derive (older libco versions, checked at configuration) or if it is not supported by the
+ * libco backend (returns NULL, e.g. windows fibers) co_create allocates a separate stack deleted with the thread. */
+static inline cothread_t stimc_thread_libco_create (void (*func)(void), struct stimc_thread_stack_s *t, size_t stacksize)
+{
+    cothread_t co = NULL;
 
-#define STIMC_CO_CREATE(func, stacksize) co_create (stacksize, func)
-#define STIMC_CO_CURRENT()               co_active ()
-#define STIMC_CO_SWITCH(thread)          co_switch (thread)
-#define STIMC_CO_DELETE(thread)          co_delete (thread)
+#ifndef STIMC_THREAD_LIBCO_NO_DERIVE
+    co = co_derive (stimc_thread_stack_mem (t), t->size, func);
+#endif
+    if (co == NULL) {
+        co        = co_create (stacksize, func);
+        t->co_own = true;
+    }
+
+    return co;
+}
+
+static inline void stimc_thread_libco_delete (struct stimc_thread_stack_s *t)
+{
+    if (t->co_own) co_delete ((cothread_t)t->co);
+}
+
+#define STIMC_CO_CREATE(func, t, stacksize) stimc_thread_libco_create (func, t, stacksize)
+#define STIMC_CO_CURRENT()                  co_active ()
+#define STIMC_CO_SWITCH(thread)             co_switch (thread)
+#define STIMC_CO_DELETE(t)                  stimc_thread_libco_delete (t)
 #endif
 
 #ifdef STIMC_THREAD_IMPL_LIBCO_PCL
-#include <assert.h>
+typedef struct stimc_thread_stack_s *stimc_thread_impl;
 
-static stimc_thread_impl stimc_thread_impl_main = NULL;
+static stimc_thread_impl_co stimc_thread_impl_main = NULL;
 
 static inline stimc_thread_impl stimc_thread_impl_create (void (*func)(STIMC_THREAD_ARG_DECL), size_t stacksize)
 {
-    if (stacksize > STIMC_STACKSIZE_MAX) stacksize = STIMC_STACKSIZE_MAX;
+    if (stacksize > STIMC_STACKSIZE_MAX / 2) stacksize = STIMC_STACKSIZE_MAX / 2;
 
-    stimc_thread_impl t = STIMC_CO_CREATE (func, stacksize);
+#ifdef STIMC_THREAD_LIBCO_NO_DERIVE
+    /* coroutine gets its own stack, pooled memory is only used for the header */
+    stimc_thread_impl t = stimc_thread_stack_get (0);
+#else
+    stimc_thread_impl t = stimc_thread_stack_get (stacksize);
+#endif
+
+    t->co = STIMC_CO_CREATE (func, t, stacksize);
 
-    assert (t);
+    assert (t->co);
     return t;
 }
 
 static inline void stimc_thread_impl_run (stimc_thread_impl t)
 {
-    stimc_thread_impl prev = stimc_thread_impl_main;
+    stimc_thread_impl_co prev = stimc_thread_impl_main;
 
     stimc_thread_impl_main = STIMC_CO_CURRENT ();
 
-    STIMC_CO_SWITCH (t);
+    STIMC_CO_SWITCH ((stimc_thread_impl_co)t->co);
 
     stimc_thread_impl_main = prev;
 }
@@ -188,6 +475,25 @@ static inline void stimc_thread_impl_suspend (void)
 static inline void stimc_thread_impl_delete (stimc_thread_impl t)
 {
     STIMC_CO_DELETE (t);
+    stimc_thread_stack_put (t);
+}
+
+static inline void stimc_thread_impl_cleanup (void)
+{
+    stimc_thread_stack_pool_clear ();
+}
+
+static inline void stimc_thread_impl_stack_pool_stats (uint64_t *hits, uint64_t *misses)
+{
+    if (hits   != NULL) *hits   = stimc_thread_stack_pool.hits;
+    if (misses != NULL) *misses = stimc_thread_stack_pool.misses;
+}
+
+static inline void stimc_thread_impl_stack_usage (stimc_thread_impl t, size_t *used, size_t *size)
+{
+    /* separately allocated stacks are not measured */
+    *used = t->co_own ? 0 : stimc_thread_stack_used (t);
+    *size = t->co_own ? 0 : t->size;
 }
 #endif
 
@@ -56,9 +56,66 @@ using coro_t = boost::coroutines2::coroutine<void (*)(void)>;
 
 /* internal header */
 #define STIMC_USE_INTERNAL_HEADER
+#define STIMC_THREAD_IMPL_EXTERNAL_DEF
 #include "stimc_thread.inl"
 #undef STIMC_USE_INTERNAL_HEADER
 
+/*******************************************************************************/
+/* pooled stack allocators */
+/*******************************************************************************/
+/* stack allocated last - boost allocates on coroutine creation */
+static struct stimc_thread_stack_s *stimc_thread_impl_stack_last = nullptr;
+
+#ifdef STIMC_THREAD_IMPL_BOOST1
+class stimc_thread_impl_stack_allocator {
+    public:
+        void allocate (boost::coroutines::stack_context &sctx, std::size_t size)
+        {
+            struct stimc_thread_stack_s *s = stimc_thread_stack_get (size);
+
+            sctx.size = s->size;
+            sctx.sp   = (char *)stimc_thread_stack_mem (s) + s->size;
+
+            stimc_thread_impl_stack_last = s;
+        }
+
+        void deallocate (boost::coroutines::stack_context &sctx)
+        {
+            stimc_thread_stack_put (stimc_thread_stack_from_top (sctx.sp, sctx.size));
+        }
+};
+#endif
+
+#ifdef STIMC_THREAD_IMPL_BOOST2
+class stimc_thread_impl_stack_allocator {
+    private:
+        std::size_t size;
+
+    public:
+        stimc_thread_impl_stack_allocator (std::size_t s) :
+            size (s)
+        {}
+
+        boost::context::stack_context allocate ()
+        {
+            struct stimc_thread_stack_s  *s = stimc_thread_stack_get (size);
+            boost::context::stack_context sctx;
+
+            sctx.size = s->size;
+            sctx.sp   = (char *)stimc_thread_stack_mem (s) + s->size;
+
+            stimc_thread_impl_stack_last = s;
+
+            return sctx;
+        }
+
+        void deallocate (boost::context::stack_context &sctx) noexcept
+        {
+            stimc_thread_stack_put (stimc_thread_stack_from_top (sctx.sp, sctx.size));
+        }
+};
+#endif
+
 using stimc_thread_impl_func = void (*)(void);
 
 struct stimc_thread_impl_s {
@@ -66,12 +123,14 @@ struct stimc_thread_impl_s {
     coro_t::pull_type                 *main;
     stimc_thread_impl_func             func;
     const size_t                       stacksize;
+    struct stimc_thread_stack_s       *stack;
 
     stimc_thread_impl_s (stimc_thread_impl_func f, size_t s) :
         thread    (nullptr),
         main      (nullptr),
         func      (f),
-        stacksize (s)
+        stacksize (s),
+        stack     (nullptr)
     {}
 
     stimc_thread_impl_s            (const stimc_thread_impl_s &t) = delete;
@@ -104,15 +163,23 @@ static inline void stimc_thread_impl_boost_init (stimc_thread_impl_boost t)
 {
     if (t->thread != nullptr) return;
 
-    t->thread.reset (new coro_t::push_type (
-                         stimc_thread_impl_boost_wrap
 #ifdef STIMC_THREAD_IMPL_BOOST1
-                         ,
-                         boost::coroutines::attributes (t->stacksize)
+    t->thread.reset (new coro_t::push_type (
+                         stimc_thread_impl_boost_wrap,
+                         boost::coroutines::attributes (t->stacksize),
+                         stimc_thread_impl_stack_allocator ()
+                         ));
 #endif
+#ifdef STIMC_THREAD_IMPL_BOOST2
+    t->thread.reset (new coro_t::push_type (
+                         stimc_thread_impl_stack_allocator (t->stacksize),
+                         stimc_thread_impl_boost_wrap
                          ));
+#endif
 
     assert (t->thread != nullptr);
+
+    t->stack = stimc_thread_impl_stack_last;
 }
 
 extern "C" stimc_thread_impl stimc_thread_impl_create (stimc_thread_impl_func func, size_t stacksize)
@@ -153,5 +220,31 @@ extern "C" void stimc_thread_impl_delete (stimc_thread_impl t_ext)
 
     delete t;
 }
+
+extern "C" void stimc_thread_impl_cleanup (void)
+{
+    stimc_thread_stack_pool_clear ();
+}
+
+extern "C" void stimc_thread_impl_stack_pool_stats (uint64_t *hits, uint64_t *misses)
+{
+    if (hits   != nullptr) *hits   = stimc_thread_stack_pool.hits;
+    if (misses != nullptr) *misses = stimc_thread_stack_pool.misses;
+}
+
+extern "C" void stimc_thread_impl_stack_usage (stimc_thread_impl t_ext, size_t *used, size_t *size)
+{
+    stimc_thread_impl_boost t = static_cast<stimc_thread_impl_boost>(t_ext);
+
+    /* stack only allocated on first run */
+    if (t->stack == nullptr) {
+        *used = 0;
+        *size = 0;
+        return;
+    }
+
+    *used = stimc_thread_stack_used (t->stack);
+    *size = t->stack->size;
+}
 #endif
 
@@ -0,0 +1,1418 @@
+/*
+ *  stimc is a lightweight verilog-vpi wrapper for stimuli generation.
+ *  Copyright (C) 2019-2022  Andreas Dixius, Felix Neumärker
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file
+ * @brief vpimock implementation.
+ */
+
+#include "vpi_mock.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <math.h>
+#include <assert.h>
+
+/******************************************************************************************************/
+/* types */
+/******************************************************************************************************/
+struct __vpiHandle {
+    PLI_INT32 type;
+    char     *name;
+    char     *fullname;
+
+    /* hierarchy */
+    vpiHandle parent;
+    vpiHandle children;
+    vpiHandle children_tail;
+    vpiHandle sibling;
+
+    /* value objects (nets, parameters, memory words, constants) */
+    struct {
+        unsigned      size;
+        bool          is_signed;
+        s_vpi_vecval *vec;
+        double        real;
+        vpiHandle     cbs;
+    } value;
+
+    /* memories */
+    struct {
+        unsigned   width;
+        PLI_INT32  left;
+        PLI_INT32  right;
+        vpiHandle *words;
+        vpiHandle  range[2];
+    } memory;
+
+    /* iterators */
+    struct {
+        vpiHandle pos;
+        PLI_INT32 type;
+    } iter;
+
+    /* callbacks */
+    struct {
+        s_cb_data   data;
+        s_vpi_time  time;
+        s_vpi_value value;
+        uint64_t    serial;
+        bool        removed;
+        bool        released;
+        vpiHandle   next;
+        vpiHandle   garbage;
+    } cb;
+};
+
+enum vpi_mock_event_type {
+    VPI_MOCK_EVENT_PROCESS,
+    VPI_MOCK_EVENT_CALLBACK,
+    VPI_MOCK_EVENT_SYNCH,
+    VPI_MOCK_EVENT_PUT,
+};
+
+struct vpi_mock_event_s {
+    uint64_t                 time;
+    uint64_t                 seq;
+    enum vpi_mock_event_type type;
+
+    vpi_mock_process_t func;
+    void              *data;
+
+    vpiHandle     obj;
+    s_vpi_vecval *vec;
+    double        real;
+};
+
+struct vpi_mock_event_queue_s {
+    size_t                   num;
+    size_t                   max;
+    struct vpi_mock_event_s *entries;
+};
+
+struct vpi_mock_cb_list_s {
+    vpiHandle head;
+    vpiHandle tail;
+};
+
+struct vpi_mock_systf_s {
+    char     *name;
+    PLI_INT32 (*calltf)(PLI_BYTE8 *);
+    PLI_INT32 (*compiletf)(PLI_BYTE8 *);
+    PLI_BYTE8 *user_data;
+};
+
+/******************************************************************************************************/
+/* global variables */
+/******************************************************************************************************/
+static struct {
+    vpiHandle top;
+    vpiHandle top_tail;
+
+    uint64_t time;
+    uint64_t seq;
+    uint64_t cb_serial;
+    int      precision;
+    bool     started;
+    bool     finished;
+    bool     ended;
+
+    const char *product;
+    int         argc;
+    char      **argv;
+
+    /* scheduling */
+    struct vpi_mock_event_queue_s events;
+    struct vpi_mock_event_queue_s nba;
+    struct vpi_mock_cb_list_s     rw_synch;
+    struct vpi_mock_cb_list_s     ro_synch;
+    struct vpi_mock_cb_list_s     next_time;
+    struct vpi_mock_cb_list_s     sim_control;
+    vpiHandle                     garbage;
+    vpiHandle                     fired;
+
+    /* system tasks */
+    size_t                   systf_num;
+    struct vpi_mock_systf_s *systf;
+    struct __vpiHandle       systf_call;
+
+    /* value return buffers */
+    s_vpi_vecval *vec_buf;
+    size_t        vec_buf_len;
+    char         *str_buf;
+    size_t        str_buf_len;
+
+    uint64_t stats[VPI_MOCK_STAT__SIZE_];
+} vpi_mock = {
+    .precision = -12,
+    .product   = "vpimock",
+};
+
+/******************************************************************************************************/
+/* helpers */
+/******************************************************************************************************/
+static inline unsigned vpi_mock_words (unsigned size)
+{
+    return (size + 31) / 32;
+}
+
+static char *vpi_mock_strdup (const char *str)
+{
+    char *result = (char *)malloc (strlen (str) + 1);
+
+    assert (result);
+    strcpy (result, str);
+
+    return result;
+}
+
+static vpiHandle vpi_mock_object (PLI_INT32 type)
+{
+    vpiHandle obj = (vpiHandle)calloc (1, sizeof (struct __vpiHandle));
+
+    assert (obj);
+    obj->type = type;
+
+    return obj;
+}
+
+static void vpi_mock_object_name (vpiHandle obj, vpiHandle parent, const char *name)
+{
+    obj->name   = vpi_mock_strdup (name);
+    obj->parent = parent;
+
+    if (parent == NULL) {
+        obj->fullname = vpi_mock_strdup (name);
+        return;
+    }
+
+    size_t len = strlen (parent->fullname) + strlen (name) + 2;
+
+    obj->fullname = (char *)malloc (len);
+    assert (obj->fullname);
+    snprintf (obj->fullname, len, "%s.%s", parent->fullname, name);
+}
+
+static void vpi_mock_object_append (vpiHandle parent, vpiHandle obj)
+{
+    vpiHandle *head = (parent == NULL) ? &vpi_mock.top      : &parent->children;
+    vpiHandle *tail = (parent == NULL) ? &vpi_mock.top_tail : &parent->children_tail;
+
+    if (*tail == NULL) {
+        *head = obj;
+    } else {
+        (*tail)->sibling = obj;
+    }
+    *tail = obj;
+}
+
+static void vpi_mock_value_init (vpiHandle obj, unsigned size)
+{
+    unsigned words = vpi_mock_words (size);
+
+    obj->value.size      = size;
+    obj->value.is_signed = false;
+    obj->value.vec       = (s_vpi_vecval *)malloc (sizeof (s_vpi_vecval) * (words > 0 ? words : 1));
+    assert (obj->value.vec);
+
+    /* x */
+    for (unsigned i = 0; i < words; i++) {
+        obj->value.vec[i].aval = -1;
+        obj->value.vec[i].bval = -1;
+    }
+    if (size % 32 != 0) {
+        PLI_INT32 mask = (PLI_INT32)((UINT32_C (1) << (size % 32)) - 1);
+        obj->value.vec[words - 1].aval &= mask;
+        obj->value.vec[words - 1].bval &= mask;
+    }
+}
+
+static bool vpi_mock_is_value (vpiHandle obj)
+{
+    return (obj != NULL) && (obj->value.vec != NULL);
+}
+
+static uint64_t vpi_mock_delay (const s_vpi_time *time)
+{
+    if (time == NULL) return 0;
+
+    if (time->type == vpiScaledRealTime) {
+        /* module timescale equals precision */
+        return (uint64_t)llround (time->real);
+    }
+
+    return (((uint64_t)time->high) << 32) | time->low;
+}
+
+static void vpi_mock_set_time (s_vpi_time *time)
+{
+    time->high = (PLI_UINT32)(vpi_mock.time >> 32);
+    time->low  = (PLI_UINT32)(vpi_mock.time & 0xffffffff);
+    time->real = (double)vpi_mock.time;
+}
+
+static void *vpi_mock_buffer (void **buf, size_t *len, size_t size)
+{
+    if (*len < size) {
+        *buf = realloc (*buf, size);
+        assert (*buf);
+        *len = size;
+    }
+
+    return *buf;
+}
+
+/******************************************************************************************************/
+/* event queue (binary heap ordered by time and scheduling order) */
+/******************************************************************************************************/
+static inline bool vpi_mock_event_before (const struct vpi_mock_event_s *a, const struct vpi_mock_event_s *b)
+{
+    if (a->time != b->time) return a->time < b->time;
+    return a->seq < b->seq;
+}
+
+static void vpi_mock_event_push (struct vpi_mock_event_queue_s *q, struct vpi_mock_event_s *e)
+{
+    if (q->num >= q->max) {
+        q->max     = (q->max == 0) ? 64 : (2 * q->max);
+        q->entries = (struct vpi_mock_event_s *)realloc (q->entries, sizeof (struct vpi_mock_event_s) * q->max);
+        assert (q->entries);
+    }
+
+    e->seq = vpi_mock.seq++;
+
+    size_t i = q->num++;
+
+    while (i > 0) {
+        size_t p = (i - 1) / 2;
+        if (!vpi_mock_event_before (e, &q->entries[p])) break;
+        q->entries[i] = q->entries[p];
+        i             = p;
+    }
+    q->entries[i] = *e;
+}
+
+static void vpi_mock_event_pop (struct vpi_mock_event_queue_s *q, struct vpi_mock_event_s *e)
+{
+    assert (q->num > 0);
+
+    *e = q->entries[0];
+
+    struct vpi_mock_event_s *last = &q->entries[--q->num];
+    size_t                   i    = 0;
+
+    for (;;) {
+        size_t c = 2 * i + 1;
+        if (c >= q->num) break;
+        if ((c + 1 < q->num) && vpi_mock_event_before (&q->entries[c + 1], &q->entries[c])) c++;
+        if (!vpi_mock_event_before (&q->entries[c], last)) break;
+        q->entries[i] = q->entries[c];
+        i             = c;
+    }
+    q->entries[i] = *last;
+}
+
+static void vpi_mock_event_queue_free (struct vpi_mock_event_queue_s *q)
+{
+    for (size_t i = 0; i < q->num; i++) {
+        struct vpi_mock_event_s *e = &q->entries[i];
+        if (e->vec != NULL) free (e->vec);
+        if ((e->type == VPI_MOCK_EVENT_CALLBACK) || (e->type == VPI_MOCK_EVENT_SYNCH)) free (e->obj);
+    }
+
+    free (q->entries);
+    q->entries = NULL;
+    q->num     = 0;
+    q->max     = 0;
+}
+
+/******************************************************************************************************/
+/* callbacks */
+/******************************************************************************************************/
+static void vpi_mock_cb_list_append (struct vpi_mock_cb_list_s *l, vpiHandle cb)
+{
+    cb->cb.next = NULL;
+
+    if (l->tail == NULL) {
+        l->head = cb;
+    } else {
+        l->tail->cb.next = cb;
+    }
+    l->tail = cb;
+}
+
+static void vpi_mock_cb_list_free (struct vpi_mock_cb_list_s *l)
+{
+    while (l->head != NULL) {
+        vpiHandle cb = l->head;
+        l->head = cb->cb.next;
+        free (cb);
+    }
+    l->tail = NULL;
+}
+
+static void vpi_mock_cb_call (vpiHandle cb, vpiHandle obj)
+{
+    s_cb_data   data = cb->cb.data;
+    s_vpi_time  time;
+    s_vpi_value value;
+
+    if (data.time != NULL) {
+        time.type = data.time->type;
+        vpi_mock_set_time (&time);
+        data.time = &time;
+    }
+    if ((data.value != NULL) && (obj != NULL)) {
+        value.format = data.value->format;
+        if (value.format != vpiSuppressVal) vpi_get_value (obj, &value);
+        data.value = &value;
+    }
+    if (obj != NULL) data.obj = obj;
+
+    vpi_mock.stats[VPI_MOCK_STAT_CALLBACK]++;
+    data.cb_rtn (&data);
+}
+
+/* one-shot callbacks are kept after they returned until their handle is released */
+static void vpi_mock_cb_call_once (vpiHandle cb)
+{
+    if (!cb->cb.removed) {
+        vpi_mock_cb_call (cb, NULL);
+    }
+
+    if (cb->cb.released) {
+        free (cb);
+    } else {
+        cb->cb.garbage = vpi_mock.fired;
+        vpi_mock.fired = cb;
+    }
+}
+
+static void vpi_mock_cb_release (vpiHandle cb)
+{
+    assert (!cb->cb.released);
+
+    cb->cb.released = true;
+}
+
+static void vpi_mock_cb_list_call (struct vpi_mock_cb_list_s *l)
+{
+    vpiHandle cb = l->head;
+
+    l->head = NULL;
+    l->tail = NULL;
+
+    while (cb != NULL) {
+        vpiHandle next = cb->cb.next;
+        if (vpi_mock.finished) {
+            /* handle stays valid until vpi_mock_end */
+            vpi_mock_cb_list_append (l, cb);
+        } else {
+            vpi_mock_cb_call_once (cb);
+        }
+        cb = next;
+    }
+}
+
+static void vpi_mock_value_changed (vpiHandle obj)
+{
+    /* callbacks registered during execution only see later changes */
+    uint64_t serial = vpi_mock.cb_serial;
+
+    for (vpiHandle cb = obj->value.cbs; cb != NULL; cb = cb->cb.next) {
+        if (cb->cb.serial >= serial) break;
+        if (cb->cb.removed) continue;
+
+        vpi_mock_cb_call (cb, obj);
+    }
+}
+
+static void vpi_mock_garbage_free (void)
+{
+    while (vpi_mock.garbage != NULL) {
+        vpiHandle cb = vpi_mock.garbage;
+        vpi_mock.garbage = cb->cb.garbage;
+        free (cb);
+    }
+
+    /* fired one-shot callbacks with released handle */
+    vpiHandle *cb_ptr = &vpi_mock.fired;
+
+    while (*cb_ptr != NULL) {
+        vpiHandle cb = *cb_ptr;
+        if (cb->cb.released) {
+            *cb_ptr = cb->cb.garbage;
+            free (cb);
+        } else {
+            cb_ptr = &cb->cb.garbage;
+        }
+    }
+}
+
+/******************************************************************************************************/
+/* values */
+/******************************************************************************************************/
+static void vpi_mock_value_convert (vpiHandle obj, const s_vpi_value *v, s_vpi_vecval *vec, double *real)
+{
+    unsigned words = vpi_mock_words (obj->value.size);
+
+    *real = obj->value.real;
+
+    if (obj->type == vpiRealVar) {
+        switch (v->format) {
+            case vpiRealVal:
+                *real = v->value.real;
+                break;
+            case vpiIntVal:
+                *real = v->value.integer;
+                break;
+            default:
+                assert (0 && "unsupported value format for real variable");
+        }
+        vec[0] = obj->value.vec[0];
+        return;
+    }
+
+    for (unsigned i = 0; i < words; i++) {
+        vec[i].aval = 0;
+        vec[i].bval = 0;
+    }
+
+    switch (v->format) {
+        case vpiScalarVal:
+            switch (v->value.scalar) {
+                case vpi0:
+                    break;
+                case vpi1:
+                    vec[0].aval = 1;
+                    break;
+                case vpiZ:
+                    vec[0].bval = 1;
+                    break;
+                default:
+                    vec[0].aval = 1;
+                    vec[0].bval = 1;
+                    break;
+            }
+            break;
+        case vpiIntVal:
+            /* sign extension */
+            for (unsigned i = 1; i < words; i++) {
+                vec[i].aval = (v->value.integer < 0) ? -1 : 0;
+            }
+            vec[0].aval = v->value.integer;
+            break;
+        case vpiRealVal: {
+            int64_t  ival = llround (v->value.real);
+            uint64_t uval = (uint64_t)ival;
+            vec[0].aval = (PLI_INT32)(uval & 0xffffffff);
+            if (words > 1) vec[1].aval = (PLI_INT32)(uval >> 32);
+            for (unsigned i = 2; i < words; i++) {
+                vec[i].aval = (ival < 0) ? -1 : 0;
+            }
+            break;
+        }
+        case vpiVectorVal:
+            memcpy (vec, v->value.vector, sizeof (s_vpi_vecval) * words);
+            break;
+        case vpiBinStrVal: {
+            const char *str = v->value.str;
+            size_t      len = strlen (str);
+            for (size_t i = 0; (i < len) && (i < obj->value.size); i++) {
+                char     c   = str[len - 1 - i];
+                uint32_t bit = UINT32_C (1) << (i % 32);
+                if ((c == '1') || (c == 'x') || (c == 'X')) vec[i / 32].aval |= (PLI_INT32)bit;
+                if ((c == 'z') || (c == 'Z') || (c == 'x') || (c == 'X')) vec[i / 32].bval |= (PLI_INT32)bit;
+            }
+            break;
+        }
+        default:
+            assert (0 && "unsupported value format");
+    }
+
+    if (obj->value.size % 32 != 0) {
+        PLI_INT32 mask = (PLI_INT32)((UINT32_C (1) << (obj->value.size % 32)) - 1);
+        vec[words - 1].aval &= mask;
+        vec[words - 1].bval &= mask;
+    }
+}
+
+static void vpi_mock_value_assign (vpiHandle obj, const s_vpi_vecval *vec, double real)
+{
+    unsigned words = vpi_mock_words (obj->value.size);
+
+    if ((memcmp (obj->value.vec, vec, sizeof (s_vpi_vecval) * words) == 0) && (obj->value.real == real)) {
+        return;
+    }
+
+    memcpy (obj->value.vec, vec, sizeof (s_vpi_vecval) * words);
+    obj->value.real = real;
+
+    vpi_mock_value_changed (obj);
+}
+
+static uint64_t vpi_mock_value_uint64 (vpiHandle obj)
+{
+    uint64_t result = (uint32_t)(obj->value.vec[0].aval & ~obj->value.vec[0].bval);
+
+    if (vpi_mock_words (obj->value.size) > 1) {
+        result |= ((uint64_t)(uint32_t)(obj->value.vec[1].aval & ~obj->value.vec[1].bval)) << 32;
+    }
+
+    return result;
+}
+
+static PLI_INT32 vpi_mock_value_bit (vpiHandle obj, unsigned bit)
+{
+    uint32_t a = ((uint32_t)obj->value.vec[bit / 32].aval >> (bit % 32)) & 1;
+    uint32_t b = ((uint32_t)obj->value.vec[bit / 32].bval >> (bit % 32)) & 1;
+
+    if (b) return a ? vpiX : vpiZ;
+    return a ? vpi1 : vpi0;
+}
+
+/******************************************************************************************************/
+/* design */
+/******************************************************************************************************/
+vpiHandle vpi_mock_module_create (vpiHandle parent, const char *name)
+{
+    assert ((parent == NULL) || (parent->type == vpiModule));
+
+    vpiHandle module = vpi_mock_object (vpiModule);
+
+    vpi_mock_object_name (module, parent, name);
+    vpi_mock_object_append (parent, module);
+
+    return module;
+}
+
+vpiHandle vpi_mock_net_create (vpiHandle module, const char *name, PLI_INT32 type, unsigned size)
+{
+    assert (module && (module->type == vpiModule));
+    assert ((type == vpiNet) || (type == vpiReg) || (type == vpiRealVar));
+
+    vpiHandle net = vpi_mock_object (type);
+
+    vpi_mock_object_name (net, module, name);
+    vpi_mock_value_init (net, (type == vpiRealVar) ? 1 : size);
+    if (type == vpiRealVar) {
+        net->value.vec[0].aval = 0;
+        net->value.vec[0].bval = 0;
+    }
+    vpi_mock_object_append (module, net);
+
+    return net;
+}
+
+void vpi_mock_net_set_signed (vpiHandle net)
+{
+    assert (net && ((net->type == vpiNet) || (net->type == vpiReg)));
+
+    net->value.is_signed = true;
+}
+
+vpiHandle vpi_mock_parameter_create (vpiHandle module, const char *name, PLI_INT32 value)
+{
+    assert (module && (module->type == vpiModule));
+
+    vpiHandle parameter = vpi_mock_object (vpiParameter);
+
+    vpi_mock_object_name (parameter, module, name);
+    vpi_mock_value_init (parameter, 32);
+    parameter->value.vec[0].aval = value;
+    parameter->value.vec[0].bval = 0;
+    parameter->value.real        = value;
+    vpi_mock_object_append (module, parameter);
+
+    return parameter;
+}
+
+vpiHandle vpi_mock_memory_create (vpiHandle module, const char *name, unsigned width, PLI_INT32 left, PLI_INT32 right)
+{
+    assert (module && (module->type == vpiModule));
+    assert (width > 0);
+
+    vpiHandle memory = vpi_mock_object (vpiMemory);
+
+    vpi_mock_object_name (memory, module, name);
+    memory->memory.width = width;
+    memory->memory.left  = left;
+    memory->memory.right = right;
+
+    size_t depth = (size_t)((left > right) ? ((int64_t)left - right) : ((int64_t)right - left)) + 1;
+
+    /* words are created on first access */
+    memory->memory.words = (vpiHandle *)calloc (depth, sizeof (vpiHandle));
+    assert (memory->memory.words);
+
+    for (unsigned i = 0; i < 2; i++) {
+        vpiHandle range = vpi_mock_object (vpiConstant);
+        vpi_mock_value_init (range, 32);
+        range->value.vec[0].aval = (i == 0) ? left : right;
+        range->value.vec[0].bval = 0;
+        range->parent            = memory;
+        memory->memory.range[i]  = range;
+    }
+
+    vpi_mock_object_append (module, memory);
+
+    return memory;
+}
+
+static PLI_INT32 vpi_mock_memory_depth (vpiHandle memory)
+{
+    PLI_INT32 left  = memory->memory.left;
+    PLI_INT32 right = memory->memory.right;
+
+    return ((left > right) ? (left - right) : (right - left)) + 1;
+}
+
+static void vpi_mock_object_free (vpiHandle obj)
+{
+    while (obj->children != NULL) {
+        vpiHandle child = obj->children;
+        obj->children = child->sibling;
+        vpi_mock_object_free (child);
+    }
+
+    if (obj->type == vpiMemory) {
+        PLI_INT32 depth = vpi_mock_memory_depth (obj);
+        for (PLI_INT32 i = 0; i < depth; i++) {
+            if (obj->memory.words[i] != NULL) vpi_mock_object_free (obj->memory.words[i]);
+        }
+        free (obj->memory.words);
+        vpi_mock_object_free (obj->memory.range[0]);
+        vpi_mock_object_free (obj->memory.range[1]);
+    }
+
+    while (obj->value.cbs != NULL) {
+        vpiHandle cb = obj->value.cbs;
+        obj->value.cbs = cb->cb.next;
+        free (cb);
+    }
+
+    if (obj->value.vec != NULL) free (obj->value.vec);
+    if (obj->name != NULL) free (obj->name);
+    if (obj->fullname != NULL) free (obj->fullname);
+    free (obj);
+}
+
+/******************************************************************************************************/
+/* simulator */
+/******************************************************************************************************/
+void vpi_mock_set_time_precision (int precision)
+{
+    vpi_mock.precision = precision;
+}
+
+void vpi_mock_set_product (const char *product)
+{
+    vpi_mock.product = product;
+}
+
+void vpi_mock_set_args (int argc, char **argv)
+{
+    vpi_mock.argc = argc;
+    vpi_mock.argv = argv;
+}
+
+void vpi_mock_startup (void (*routines[])(void))
+{
+    for (size_t i = 0; routines[i] != NULL; i++) {
+        routines[i]();
+    }
+}
+
+bool vpi_mock_systf_call (const char *name, vpiHandle scope)
+{
+    for (size_t i = 0; i < vpi_mock.systf_num; i++) {
+        struct vpi_mock_systf_s *tf = &vpi_mock.systf[i];
+
+        if (strcmp (tf->name, name) != 0) continue;
+
+        struct __vpiHandle call_prev = vpi_mock.systf_call;
+
+        vpi_mock.systf_call.type   = vpiSysTfCall;
+        vpi_mock.systf_call.parent = scope;
+
+        if (tf->compiletf != NULL) tf->compiletf (tf->user_data);
+        if (tf->calltf != NULL) tf->calltf (tf->user_data);
+
+        vpi_mock.systf_call = call_prev;
+
+        return true;
+    }
+
+    return false;
+}
+
+void vpi_mock_schedule (uint64_t delay, vpi_mock_process_t func, void *data)
+{
+    struct vpi_mock_event_s e = {
+        .time = vpi_mock.time + delay,
+        .type = VPI_MOCK_EVENT_PROCESS,
+        .func = func,
+        .data = data,
+    };
+
+    vpi_mock_event_push (&vpi_mock.events, &e);
+}
+
+uint64_t vpi_mock_time (void)
+{
+    return vpi_mock.time;
+}
+
+static void vpi_mock_event_run (struct vpi_mock_event_s *e)
+{
+    switch (e->type) {
+        case VPI_MOCK_EVENT_PROCESS:
+            e->func (e->data);
+            break;
+        case VPI_MOCK_EVENT_CALLBACK:
+            vpi_mock_cb_call_once (e->obj);
+            break;
+        case VPI_MOCK_EVENT_SYNCH:
+            if (e->obj->cb.data.reason == cbReadWriteSynch) {
+                vpi_mock_cb_list_append (&vpi_mock.rw_synch, e->obj);
+            } else {
+                vpi_mock_cb_list_append (&vpi_mock.ro_synch, e->obj);
+            }
+            break;
+        case VPI_MOCK_EVENT_PUT:
+            vpi_mock_value_assign (e->obj, e->vec, e->real);
+            free (e->vec);
+            break;
+    }
+}
+
+static void vpi_mock_time_slot (void)
+{
+    for (;;) {
+        /* active region */
+        while (!vpi_mock.finished && (vpi_mock.events.num > 0) && (vpi_mock.events.entries[0].time == vpi_mock.time)) {
+            struct vpi_mock_event_s e;
+
+            vpi_mock_event_pop (&vpi_mock.events, &e);
+
+            if (e.type == VPI_MOCK_EVENT_PUT) {
+                vpi_mock_event_push (&vpi_mock.nba, &e);
+            } else {
+                vpi_mock_event_run (&e);
+            }
+        }
+        if (vpi_mock.finished) return;
+
+        /* delayed assignments */
+        if (vpi_mock.nba.num > 0) {
+            while (!vpi_mock.finished && (vpi_mock.nba.num > 0)) {
+                struct vpi_mock_event_s e;
+
+                vpi_mock_event_pop (&vpi_mock.nba, &e);
+                vpi_mock_event_run (&e);
+            }
+            continue;
+        }
+
+        /* read-write synchronization */
+        if (vpi_mock.rw_synch.head != NULL) {
+            vpi_mock_cb_list_call (&vpi_mock.rw_synch);
+            continue;
+        }
+
+        break;
+    }
+
+    vpi_mock_cb_list_call (&vpi_mock.ro_synch);
+}
+
+static void vpi_mock_cb_list_call_reason (struct vpi_mock_cb_list_s *l, PLI_INT32 reason)
+{
+    vpiHandle cb = l->head;
+
+    l->head = NULL;
+    l->tail = NULL;
+
+    while (cb != NULL) {
+        vpiHandle next = cb->cb.next;
+
+        if (cb->cb.data.reason == reason) {
+            vpi_mock_cb_call_once (cb);
+        } else {
+            vpi_mock_cb_list_append (l, cb);
+        }
+        cb = next;
+    }
+}
+
+bool vpi_mock_run (uint64_t until)
+{
+    if (!vpi_mock.started) {
+        vpi_mock.started = true;
+        vpi_mock_cb_list_call_reason (&vpi_mock.sim_control, cbEndOfCompile);
+        vpi_mock_cb_list_call_reason (&vpi_mock.sim_control, cbStartOfSimulation);
+    }
+
+    while (!vpi_mock.finished) {
+        vpi_mock_time_slot ();
+        vpi_mock_garbage_free ();
+
+        if (vpi_mock.finished || (vpi_mock.events.num == 0)) break;
+
+        uint64_t next = vpi_mock.events.entries[0].time;
+        if (next > until) return true;
+
+        vpi_mock.time = next;
+        vpi_mock_cb_list_call (&vpi_mock.next_time);
+    }
+
+    return false;
+}
+
+bool vpi_mock_end (void)
+{
+    if (vpi_mock.ended) return true;
+
+    vpi_mock.ended    = true;
+    vpi_mock.finished = true;
+
+    vpi_mock_cb_list_call_reason (&vpi_mock.sim_control, cbEndOfSimulation);
+
+    vpi_mock_event_queue_free (&vpi_mock.events);
+    vpi_mock_event_queue_free (&vpi_mock.nba);
+    vpi_mock_cb_list_free (&vpi_mock.rw_synch);
+    vpi_mock_cb_list_free (&vpi_mock.ro_synch);
+    vpi_mock_cb_list_free (&vpi_mock.next_time);
+    vpi_mock_cb_list_free (&vpi_mock.sim_control);
+    vpi_mock_garbage_free ();
+
+    /* remaining fired one-shot callbacks: handle neither removed nor freed */
+    size_t leaked = 0;
+    while (vpi_mock.fired != NULL) {
+        vpiHandle cb = vpi_mock.fired;
+        vpi_mock.fired = cb->cb.garbage;
+        free (cb);
+        leaked++;
+    }
+
+    while (vpi_mock.top != NULL) {
+        vpiHandle module = vpi_mock.top;
+        vpi_mock.top = module->sibling;
+        vpi_mock_object_free (module);
+    }
+    vpi_mock.top_tail = NULL;
+
+    for (size_t i = 0; i < vpi_mock.systf_num; i++) {
+        free (vpi_mock.systf[i].name);
+    }
+    free (vpi_mock.systf);
+    vpi_mock.systf     = NULL;
+    vpi_mock.systf_num = 0;
+
+    free (vpi_mock.vec_buf);
+    free (vpi_mock.str_buf);
+    vpi_mock.vec_buf     = NULL;
+    vpi_mock.vec_buf_len = 0;
+    vpi_mock.str_buf     = NULL;
+    vpi_mock.str_buf_len = 0;
+
+    if (leaked > 0) {
+        fprintf (stderr, "vpimock: ERROR: %zu callback handle(s) leaked (neither removed nor freed)\n", leaked);
+        return false;
+    }
+
+    return true;
+}
+
+/******************************************************************************************************/
+/* statistics */
+/******************************************************************************************************/
+uint64_t vpi_mock_stat (enum vpi_mock_stat stat)
+{
+    assert (stat < VPI_MOCK_STAT__SIZE_);
+
+    return vpi_mock.stats[stat];
+}
+
+void vpi_mock_stat_reset (void)
+{
+    memset (vpi_mock.stats, 0, sizeof (vpi_mock.stats));
+}
+
+/******************************************************************************************************/
+/* vpi */
+/******************************************************************************************************/
+vpiHandle vpi_register_systf (p_vpi_systf_data systf_data_p)
+{
+    vpi_mock.systf = (struct vpi_mock_systf_s *)realloc (vpi_mock.systf, sizeof (struct vpi_mock_systf_s) * (vpi_mock.systf_num + 1));
+    assert (vpi_mock.systf);
+
+    struct vpi_mock_systf_s *tf = &vpi_mock.systf[vpi_mock.systf_num++];
+
+    tf->name      = vpi_mock_strdup (systf_data_p->tfname);
+    tf->calltf    = systf_data_p->calltf;
+    tf->compiletf = systf_data_p->compiletf;
+    tf->user_data = systf_data_p->user_data;
+
+    return NULL;
+}
+
+vpiHandle vpi_register_cb (p_cb_data cb_data_p)
+{
+    vpi_mock.stats[VPI_MOCK_STAT_REGISTER_CB]++;
+
+    vpiHandle cb = vpi_mock_object (vpiCallback);
+
+    cb->cb.data   = *cb_data_p;
+    cb->cb.serial = vpi_mock.cb_serial++;
+    if (cb_data_p->time != NULL) {
+        cb->cb.time      = *cb_data_p->time;
+        cb->cb.data.time = &cb->cb.time;
+    }
+    if (cb_data_p->value != NULL) {
+        cb->cb.value      = *cb_data_p->value;
+        cb->cb.data.value = &cb->cb.value;
+    }
+
+    switch (cb_data_p->reason) {
+        case cbValueChange: {
+            vpiHandle obj = cb_data_p->obj;
+            assert (vpi_mock_is_value (obj));
+
+            vpiHandle *tail = &obj->value.cbs;
+            while (*tail != NULL) tail = &(*tail)->cb.next;
+            *tail = cb;
+            break;
+        }
+        case cbAfterDelay: {
+            assert (cb_data_p->time);
+
+            struct vpi_mock_event_s e = {
+                .time = vpi_mock.time + vpi_mock_delay (cb_data_p->time),
+                .type = VPI_MOCK_EVENT_CALLBACK,
+                .obj  = cb,
+            };
+            vpi_mock_event_push (&vpi_mock.events, &e);
+            break;
+        }
+        case cbReadWriteSynch:
+        case cbReadOnlySynch: {
+            uint64_t delay = vpi_mock_delay (cb_data_p->time);
+
+            if (delay == 0) {
+                vpi_mock_cb_list_append ((cb_data_p->reason == cbReadWriteSynch) ? &vpi_mock.rw_synch : &vpi_mock.ro_synch, cb);
+            } else {
+                struct vpi_mock_event_s e = {
+                    .time = vpi_mock.time + delay,
+                    .type = VPI_MOCK_EVENT_SYNCH,
+                    .obj  = cb,
+                };
+                vpi_mock_event_push (&vpi_mock.events, &e);
+            }
+            break;
+        }
+        case cbNextSimTime:
+            vpi_mock_cb_list_append (&vpi_mock.next_time, cb);
+            break;
+        case cbEndOfCompile:
+        case cbStartOfSimulation:
+        case cbEndOfSimulation:
+        case cbStartOfReset:
+            vpi_mock_cb_list_append (&vpi_mock.sim_control, cb);
+            break;
+        default:
+            free (cb);
+            return NULL;
+    }
+
+    return cb;
+}
+
+PLI_INT32 vpi_remove_cb (vpiHandle cb_obj)
+{
+    vpi_mock.stats[VPI_MOCK_STAT_REMOVE_CB]++;
+
+    assert (cb_obj && (cb_obj->type == vpiCallback));
+
+    vpi_mock_cb_release (cb_obj);
+
+    /* fired one-shot callback: only the handle is left */
+    if (cb_obj->cb.removed) return 1;
+
+    cb_obj->cb.removed = true;
+
+    /* value change callbacks are unlinked but freed at end of time slot (iterations might be running) */
+    if (cb_obj->cb.data.reason == cbValueChange) {
+        vpiHandle *cb_ptr = &cb_obj->cb.data.obj->value.cbs;
+
+        while (*cb_ptr != cb_obj) {
+            assert (*cb_ptr);
+            cb_ptr = &(*cb_ptr)->cb.next;
+        }
+        *cb_ptr = cb_obj->cb.next;
+
+        cb_obj->cb.garbage = vpi_mock.garbage;
+        vpi_mock.garbage   = cb_obj;
+    }
+
+    return 1;
+}
+
+vpiHandle vpi_handle (PLI_INT32 type, vpiHandle ref)
+{
+    vpi_mock.stats[VPI_MOCK_STAT_LOOKUP]++;
+
+    if (ref == NULL) {
+        if ((type == vpiSysTfCall) && (vpi_mock.systf_call.type == vpiSysTfCall)) return &vpi_mock.systf_call;
+        return NULL;
+    }
+
+    switch (type) {
+        case vpiScope:
+        case vpiModule:
+            return ref->parent;
+        case vpiLeftRange:
+            return (ref->type == vpiMemory) ? ref->memory.range[0] : NULL;
+        case vpiRightRange:
+            return (ref->type == vpiMemory) ? ref->memory.range[1] : NULL;
+        default:
+            return NULL;
+    }
+}
+
+static vpiHandle vpi_mock_child_by_name (vpiHandle first, const char *name, size_t len)
+{
+    for (vpiHandle obj = first; obj != NULL; obj = obj->sibling) {
+        if ((strncmp (obj->name, name, len) == 0) && (obj->name[len] == '\0')) return obj;
+    }
+
+    return NULL;
+}
+
+vpiHandle vpi_handle_by_name (PLI_BYTE8 *name, vpiHandle scope)
+{
+    vpi_mock.stats[VPI_MOCK_STAT_LOOKUP]++;
+
+    vpiHandle   obj = NULL;
+    const char *pos = name;
+
+    do {
+        const char *sep = strchr (pos, '.');
+        size_t      len = (sep == NULL) ? strlen (pos) : (size_t)(sep - pos);
+
+        if ((obj == NULL) && (scope == NULL)) {
+            obj = vpi_mock_child_by_name (vpi_mock.top, pos, len);
+        } else {
+            obj = vpi_mock_child_by_name (((obj == NULL) ? scope : obj)->children, pos, len);
+        }
+
+        pos = (sep == NULL) ? NULL : sep + 1;
+    } while ((obj != NULL) && (pos != NULL));
+
+    return obj;
+}
+
+vpiHandle vpi_handle_by_index (vpiHandle object, PLI_INT32 indx)
+{
+    vpi_mock.stats[VPI_MOCK_STAT_LOOKUP]++;
+
+    if ((object == NULL) || (object->type != vpiMemory)) return NULL;
+
+    PLI_INT32 left  = object->memory.left;
+    PLI_INT32 right = object->memory.right;
+    PLI_INT32 low   = (left < right) ? left : right;
+    PLI_INT32 high  = (left < right) ? right : left;
+
+    if ((indx < low) || (indx > high)) return NULL;
+
+    vpiHandle *word = &object->memory.words[indx - low];
+
+    if (*word == NULL) {
+        char name[32];
+        snprintf (name, sizeof (name), "%s[%" PRId32 "]", object->name, indx);
+
+        *word = vpi_mock_object (vpiMemoryWord);
+        vpi_mock_object_name (*word, object->parent, name);
+        (*word)->parent = object;
+        vpi_mock_value_init (*word, object->memory.width);
+    }
+
+    return *word;
+}
+
+vpiHandle vpi_iterate (PLI_INT32 type, vpiHandle ref)
+{
+    vpi_mock.stats[VPI_MOCK_STAT_LOOKUP]++;
+
+    vpiHandle first = (ref == NULL) ? vpi_mock.top : ref->children;
+
+    while ((first != NULL) && (first->type != type)) first = first->sibling;
+
+    if (first == NULL) return NULL;
+
+    vpiHandle iterator = vpi_mock_object (vpiIterator);
+
+    iterator->iter.pos  = first;
+    iterator->iter.type = type;
+
+    return iterator;
+}
+
+vpiHandle vpi_scan (vpiHandle iterator)
+{
+    vpi_mock.stats[VPI_MOCK_STAT_LOOKUP]++;
+
+    assert (iterator && (iterator->type == vpiIterator));
+
+    vpiHandle result = iterator->iter.pos;
+
+    /* iterator is freed after the last element */
+    if (result == NULL) {
+        free (iterator);
+        return NULL;
+    }
+
+    vpiHandle next = result->sibling;
+
+    while ((next != NULL) && (next->type != iterator->iter.type)) next = next->sibling;
+    iterator->iter.pos = next;
+
+    return result;
+}
+
+PLI_INT32 vpi_free_object (vpiHandle object)
+{
+    if ((object != NULL) && (object->type == vpiIterator)) free (object);
+    /* callback stays registered, only the handle is released */
+    if ((object != NULL) && (object->type == vpiCallback)) vpi_mock_cb_release (object);
+
+    return 1;
+}
+
+PLI_INT32 vpi_get (PLI_INT32 property, vpiHandle object)
+{
+    vpi_mock.stats[VPI_MOCK_STAT_LOOKUP]++;
+
+    switch (property) {
+        case vpiTimeUnit:
+        case vpiTimePrecision:
+            return vpi_mock.precision;
+        default:
+            break;
+    }
+
+    if (object == NULL) return vpiUndefined;
+
+    switch (property) {
+        case vpiType:
+            return object->type;
+        case vpiSize:
+            if (object->type == vpiMemory) return vpi_mock_memory_depth (object);
+            if (vpi_mock_is_value (object)) return (PLI_INT32)object->value.size;
+            return vpiUndefined;
+        case vpiSigned:
+            if (vpi_mock_is_value (object)) return object->value.is_signed ? 1 : 0;
+            return vpiUndefined;
+        default:
+            return vpiUndefined;
+    }
+}
+
+PLI_BYTE8 *vpi_get_str (PLI_INT32 property, vpiHandle object)
+{
+    vpi_mock.stats[VPI_MOCK_STAT_LOOKUP]++;
+
+    if (object == NULL) return NULL;
+
+    switch (property) {
+        case vpiName:
+            return object->name;
+        case vpiFullName:
+            return object->fullname;
+        default:
+            return NULL;
+    }
+}
+
+void vpi_get_value (vpiHandle expr, p_vpi_value value_p)
+{
+    vpi_mock.stats[VPI_MOCK_STAT_GET_VALUE]++;
+
+    assert (vpi_mock_is_value (expr));
+
+    unsigned size  = expr->value.size;
+    unsigned words = vpi_mock_words (size);
+
+    if (value_p->format == vpiObjTypeVal) {
+        if (expr->type == vpiRealVar) {
+            value_p->format = vpiRealVal;
+        } else if ((expr->type == vpiParameter) || (expr->type == vpiConstant)) {
+            value_p->format = vpiIntVal;
+        } else if (size == 1) {
+            value_p->format = vpiScalarVal;
+        } else {
+            value_p->format = vpiVectorVal;
+        }
+    }
+
+    switch (value_p->format) {
+        case vpiScalarVal:
+            value_p->value.scalar = vpi_mock_value_bit (expr, 0);
+            break;
+        case vpiIntVal:
+            if (expr->type == vpiRealVar) {
+                value_p->value.integer = (PLI_INT32)lround (expr->value.real);
+            } else {
+                uint32_t integer = expr->value.vec[0].aval & ~expr->value.vec[0].bval;
+                if (expr->value.is_signed && (size < 32) && ((integer >> (size - 1)) & 1)) {
+                    integer |= UINT32_MAX << size;
+                }
+                value_p->value.integer = (PLI_INT32)integer;
+            }
+            break;
+        case vpiRealVal:
+            if (expr->type == vpiRealVar) {
+                value_p->value.real = expr->value.real;
+            } else if ((expr->type == vpiParameter) || (expr->type == vpiConstant)) {
+                value_p->value.real = expr->value.vec[0].aval;
+            } else {
+                value_p->value.real = (double)vpi_mock_value_uint64 (expr);
+            }
+            break;
+        case vpiVectorVal:
+            value_p->value.vector = (s_vpi_vecval *)vpi_mock_buffer ((void **)&vpi_mock.vec_buf, &vpi_mock.vec_buf_len, sizeof (s_vpi_vecval) * words);
+            memcpy (value_p->value.vector, expr->value.vec, sizeof (s_vpi_vecval) * words);
+            break;
+        case vpiBinStrVal: {
+            char *str = (char *)vpi_mock_buffer ((void **)&vpi_mock.str_buf, &vpi_mock.str_buf_len, size + 1);
+            for (unsigned i = 0; i < size; i++) {
+                str[size - 1 - i] = "01zx"[vpi_mock_value_bit (expr, i)];
+            }
+            str[size]            = '\0';
+            value_p->value.str = str;
+            break;
+        }
+        case vpiStringVal: {
+            /* bytes as characters, leading zero bytes are skipped */
+            char    *str = (char *)vpi_mock_buffer ((void **)&vpi_mock.str_buf, &vpi_mock.str_buf_len, size / 8 + 2);
+            unsigned len = 0;
+            for (unsigned i = (size + 7) / 8; i > 0; i--) {
+                unsigned byte = i - 1;
+                char     c    = (char)(((uint32_t)(expr->value.vec[byte / 4].aval & ~expr->value.vec[byte / 4].bval) >> (8 * (byte % 4))) & 0xff);
+                if ((c != '\0') || (len > 0)) str[len++] = c;
+            }
+            str[len]           = '\0';
+            value_p->value.str = str;
+            break;
+        }
+        case vpiSuppressVal:
+            break;
+        default:
+            assert (0 && "unsupported value format");
+    }
+}
+
+vpiHandle vpi_put_value (vpiHandle object, p_vpi_value value_p, p_vpi_time time_p, PLI_INT32 flags)
+{
+    vpi_mock.stats[VPI_MOCK_STAT_PUT_VALUE]++;
+
+    assert (vpi_mock_is_value (object));
+    assert ((object->type != vpiParameter) && (object->type != vpiConstant));
+
+    unsigned      words = vpi_mock_words (object->value.size);
+    s_vpi_vecval *vec   = (s_vpi_vecval *)malloc (sizeof (s_vpi_vecval) * (words > 0 ? words : 1));
+    double        real;
+
+    assert (vec);
+    vpi_mock_value_convert (object, value_p, vec, &real);
+
+    if ((flags & 0xfff) == vpiNoDelay) {
+        vpi_mock_value_assign (object, vec, real);
+        free (vec);
+        return NULL;
+    }
+
+    /* delayed assignments take place after the active region */
+    struct vpi_mock_event_s e = {
+        .time = vpi_mock.time + vpi_mock_delay (time_p),
+        .type = VPI_MOCK_EVENT_PUT,
+        .obj  = object,
+        .vec  = vec,
+        .real = real,
+    };
+
+    if (e.time == vpi_mock.time) {
+        vpi_mock_event_push (&vpi_mock.nba, &e);
+    } else {
+        vpi_mock_event_push (&vpi_mock.events, &e);
+    }
+
+    return NULL;
+}
+
+void vpi_get_time (vpiHandle object __attribute__((unused)), p_vpi_time time_p)
+{
+    vpi_mock_set_time (time_p);
+}
+
+PLI_INT32 vpi_printf (const char *format, ...)
+{
+    va_list ap;
+
+    va_start (ap, format);
+    PLI_INT32 result = vprintf (format, ap);
+    va_end (ap);
+
+    return result;
+}
+
+PLI_INT32 vpi_vprintf (const char *format, va_list ap)
+{
+    return vprintf (format, ap);
+}
+
+PLI_INT32 vpi_flush (void)
+{
+    return fflush (stdout);
+}
+
+PLI_INT32 vpi_control (PLI_INT32 operation, ...)
+{
+    switch (operation) {
+        /* no interactive mode: stop ends the simulation, too */
+        case vpiStop:
+        case vpiFinish:
+            vpi_mock.finished = true;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+PLI_INT32 vpi_get_vlog_info (p_vpi_vlog_info vlog_info_p)
+{
+    vlog_info_p->argc    = vpi_mock.argc;
+    vlog_info_p->argv    = (PLI_BYTE8 **)vpi_mock.argv;
+    vlog_info_p->product = (PLI_BYTE8 *)vpi_mock.product;
+    vlog_info_p->version = (PLI_BYTE8 *)"1.0";
+
+    return 1;
+}
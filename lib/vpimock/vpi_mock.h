@@ -0,0 +1,213 @@
+/*
+ *  stimc is a lightweight verilog-vpi wrapper for stimuli generation.
+ *  Copyright (C) 2019-2022  Andreas Dixius, Felix Neumärker
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file
+ * @brief vpimock: in-process stand-in for a Verilog simulator's vpi.
+ *
+ * Implements the subset of vpi used by stimc on a synthetic design
+ * (modules, nets, parameters and memories created via this interface)
+ * together with a deterministic time-advancing event loop.
+ * Meant for unit tests and microbenchmarks of stimc without a simulator.
+ *
+ * Scheduling within a time slot follows the Verilog regions:
+ * active events (testbench processes, cbAfterDelay), delayed vpi_put_value
+ * assignments, cbReadWriteSynch and finally cbReadOnlySynch.
+ * cbValueChange callbacks are executed immediately when a value changes.
+ */
+
+#ifndef VPI_MOCK_H
+#define VPI_MOCK_H
+
+#include <vpi_user.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+/* *auto-indent-off* */
+extern "C" {
+/* *auto-indent-on* */
+#endif
+
+/******************************************************************************************************/
+/* design */
+/******************************************************************************************************/
+
+/**
+ * @brief Create a module instance.
+ * @param parent Parent module or NULL for a top level module.
+ * @param name Instance name.
+ * @return Handle of the new module.
+ */
+vpiHandle vpi_mock_module_create (vpiHandle parent, const char *name);
+
+/**
+ * @brief Create a net/variable inside a module.
+ * @param module Module to contain the net.
+ * @param name Name of the net.
+ * @param type vpi object type: vpiNet, vpiReg or vpiRealVar.
+ * @param size Width in bits (ignored for vpiRealVar).
+ * @return Handle of the new net with all bits initialized to x (0.0 for vpiRealVar).
+ */
+vpiHandle vpi_mock_net_create (vpiHandle module, const char *name, PLI_INT32 type, unsigned size);
+
+/**
+ * @brief Declare a net/variable signed (integer values are sign extended).
+ * @param net Net created via @ref vpi_mock_net_create (not vpiRealVar).
+ */
+void vpi_mock_net_set_signed (vpiHandle net);
+
+/**
+ * @brief Create a 32 bit integer parameter inside a module.
+ * @param module Module to contain the parameter.
+ * @param name Name of the parameter.
+ * @param value Parameter value.
+ * @return Handle of the new parameter.
+ */
+vpiHandle vpi_mock_parameter_create (vpiHandle module, const char *name, PLI_INT32 value);
+
+/**
+ * @brief Create a memory (reg array) inside a module.
+ * @param module Module to contain the memory.
+ * @param name Name of the memory.
+ * @param width Width of each word in bits.
+ * @param left Left index of the address range.
+ * @param right Right index of the address range.
+ * @return Handle of the new memory with all bits initialized to x.
+ */
+vpiHandle vpi_mock_memory_create (vpiHandle module, const char *name, unsigned width, PLI_INT32 left, PLI_INT32 right);
+
+/******************************************************************************************************/
+/* simulator */
+/******************************************************************************************************/
+
+/**
+ * @brief Set simulation time precision (default -12, 1ps).
+ * @param precision Precision as power of 10 in seconds.
+ *
+ * As there is no separate module timescale this is reported
+ * for vpiTimeUnit and vpiTimePrecision.
+ */
+void vpi_mock_set_time_precision (int precision);
+
+/**
+ * @brief Set product name reported by vpi_get_vlog_info (default "vpimock").
+ * @param product Product name (not copied).
+ */
+void vpi_mock_set_product (const char *product);
+
+/**
+ * @brief Set command line arguments reported by vpi_get_vlog_info (default none).
+ * @param argc Number of arguments.
+ * @param argv Arguments (not copied), e.g. plusargs like @c +name=value.
+ */
+void vpi_mock_set_args (int argc, char **argv);
+
+/**
+ * @brief Run vpi library startup routines.
+ * @param routines NULL terminated list of startup routines,
+ * usually vlog_startup_routines of the vpi library.
+ */
+void vpi_mock_startup (void (*routines[])(void));
+
+/**
+ * @brief Call a registered system task from the scope of a module.
+ * @param name Name of the system task including the leading '$'.
+ * @param scope Module the call is located in.
+ * @return false if the system task is not registered.
+ *
+ * Corresponds to the system task being called inside an initial block,
+ * so it should be called at time 0 before running or from a scheduled process.
+ */
+bool vpi_mock_systf_call (const char *name, vpiHandle scope);
+
+/**
+ * @brief Testbench process function type.
+ */
+typedef void (*vpi_mock_process_t) (void *data);
+
+/**
+ * @brief Schedule a testbench process in the active region.
+ * @param delay Delay in simulation time steps, 0 for the current time slot.
+ * @param func Process function to call.
+ * @param data Data passed to the process function.
+ */
+void vpi_mock_schedule (uint64_t delay, vpi_mock_process_t func, void *data);
+
+/**
+ * @brief Current simulation time.
+ * @return Simulation time in time steps.
+ */
+uint64_t vpi_mock_time (void);
+
+/**
+ * @brief Run simulation.
+ * @param until Last time slot to simulate.
+ * @return true if simulation has been paused as the next event is after @c until,
+ * false if the simulation finished (vpiFinish) or there are no more events.
+ */
+bool vpi_mock_run (uint64_t until);
+
+/**
+ * @brief End simulation.
+ * @return false if callback handles have been leaked, true otherwise.
+ *
+ * Executes cbEndOfSimulation callbacks and frees all objects.
+ * Handles of one-shot callbacks stay valid after the callback fired until they are
+ * released via vpi_remove_cb or vpi_free_object. Handles of fired callbacks that
+ * have not been released by then are reported as leaked.
+ */
+bool vpi_mock_end (void);
+
+/******************************************************************************************************/
+/* statistics */
+/******************************************************************************************************/
+
+/**
+ * @brief Counted vpi accesses.
+ */
+enum vpi_mock_stat {
+    VPI_MOCK_STAT_GET_VALUE,   /**< @brief vpi_get_value calls */
+    VPI_MOCK_STAT_PUT_VALUE,   /**< @brief vpi_put_value calls */
+    VPI_MOCK_STAT_LOOKUP,      /**< @brief vpi_handle*, vpi_get*, vpi_iterate and vpi_scan calls */
+    VPI_MOCK_STAT_REGISTER_CB, /**< @brief vpi_register_cb calls */
+    VPI_MOCK_STAT_REMOVE_CB,   /**< @brief vpi_remove_cb calls */
+    VPI_MOCK_STAT_CALLBACK,    /**< @brief executed callbacks */
+    VPI_MOCK_STAT__SIZE_,
+};
+
+/**
+ * @brief Get vpi access counter.
+ * @param stat Counter to get.
+ * @return Number of counted accesses since start or last reset.
+ */
+uint64_t vpi_mock_stat (enum vpi_mock_stat stat);
+
+/**
+ * @brief Reset all vpi access counters.
+ */
+void vpi_mock_stat_reset (void);
+
+#ifdef __cplusplus
+/* *auto-indent-off* */
+}
+/* *auto-indent-on* */
+#endif
+
+#endif
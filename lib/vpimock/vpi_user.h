@@ -0,0 +1,228 @@
+/*
+ *  stimc is a lightweight verilog-vpi wrapper for stimuli generation.
+ *  Copyright (C) 2019-2022  Andreas Dixius, Felix Neumärker
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file
+ * @brief Subset of the IEEE 1364 vpi_user.h declarations for building against vpimock.
+ *
+ * Only contains what is needed by stimc and the vpimock testbenches.
+ * Constants and structures follow the standard header, so code compiled
+ * against it does not differ from code compiled against a simulator's header.
+ */
+
+#ifndef VPI_USER_H
+#define VPI_USER_H
+
+#include <stdint.h>
+#include <stdarg.h>
+
+#ifdef __cplusplus
+/* *auto-indent-off* */
+extern "C" {
+/* *auto-indent-on* */
+#endif
+
+/* basic types */
+typedef int32_t  PLI_INT32;
+typedef uint32_t PLI_UINT32;
+typedef int16_t  PLI_INT16;
+typedef uint16_t PLI_UINT16;
+typedef int64_t  PLI_INT64;
+typedef uint64_t PLI_UINT64;
+typedef char     PLI_BYTE8;
+typedef uint8_t  PLI_UBYTE8;
+
+typedef struct __vpiHandle *vpiHandle;
+
+/* object types */
+#define vpiConstant    7
+#define vpiIterator   27
+#define vpiMemory     29
+#define vpiMemoryWord 30
+#define vpiModule     32
+#define vpiNet        36
+#define vpiParameter  41
+#define vpiRealVar    47
+#define vpiReg        48
+#define vpiCallback  107
+
+/* methods */
+#define vpiLeftRange  79
+#define vpiRightRange 83
+#define vpiScope      84
+#define vpiSysTfCall  85
+
+/* properties */
+#define vpiUndefined     -1
+#define vpiType           1
+#define vpiName           2
+#define vpiFullName       3
+#define vpiSize           4
+#define vpiTimeUnit      11
+#define vpiTimePrecision 12
+#define vpiSigned        65
+
+/* time */
+typedef struct t_vpi_time {
+    PLI_INT32  type;
+    PLI_UINT32 high;
+    PLI_UINT32 low;
+    double     real;
+} s_vpi_time, *p_vpi_time;
+
+#define vpiScaledRealTime 1
+#define vpiSimTime        2
+#define vpiSuppressTime   3
+
+/* values */
+typedef struct t_vpi_vecval {
+    PLI_INT32 aval;
+    PLI_INT32 bval;
+} s_vpi_vecval, *p_vpi_vecval;
+
+typedef struct t_vpi_strengthval {
+    PLI_INT32 logic;
+    PLI_INT32 s0;
+    PLI_INT32 s1;
+} s_vpi_strengthval, *p_vpi_strengthval;
+
+typedef struct t_vpi_value {
+    PLI_INT32 format;
+    union {
+        PLI_BYTE8                *str;
+        PLI_INT32                 scalar;
+        PLI_INT32                 integer;
+        double                    real;
+        struct t_vpi_time        *time;
+        struct t_vpi_vecval      *vector;
+        struct t_vpi_strengthval *strength;
+        PLI_BYTE8                *misc;
+    } value;
+} s_vpi_value, *p_vpi_value;
+
+#define vpiBinStrVal    1
+#define vpiOctStrVal    2
+#define vpiDecStrVal    3
+#define vpiHexStrVal    4
+#define vpiScalarVal    5
+#define vpiIntVal       6
+#define vpiRealVal      7
+#define vpiStringVal    8
+#define vpiVectorVal    9
+#define vpiStrengthVal 10
+#define vpiTimeVal     11
+#define vpiObjTypeVal  12
+#define vpiSuppressVal 13
+
+#define vpi0        0
+#define vpi1        1
+#define vpiZ        2
+#define vpiX        3
+#define vpiH        4
+#define vpiL        5
+#define vpiDontCare 6
+
+/* vpi_put_value flags */
+#define vpiNoDelay            1
+#define vpiInertialDelay      2
+#define vpiTransportDelay     3
+#define vpiPureTransportDelay 4
+
+/* system tasks/functions */
+typedef struct t_vpi_systf_data {
+    PLI_INT32  type;
+    PLI_INT32  sysfunctype;
+    PLI_BYTE8 *tfname;
+    PLI_INT32  (*calltf)(PLI_BYTE8 *);
+    PLI_INT32  (*compiletf)(PLI_BYTE8 *);
+    PLI_INT32  (*sizetf)(PLI_BYTE8 *);
+    PLI_BYTE8 *user_data;
+} s_vpi_systf_data, *p_vpi_systf_data;
+
+#define vpiSysTask 1
+#define vpiSysFunc 2
+
+/* simulator information */
+typedef struct t_vpi_vlog_info {
+    PLI_INT32   argc;
+    PLI_BYTE8 **argv;
+    PLI_BYTE8  *product;
+    PLI_BYTE8  *version;
+} s_vpi_vlog_info, *p_vpi_vlog_info;
+
+/* simulation control */
+#define vpiStop   66
+#define vpiFinish 67
+#define vpiReset  68
+
+/* callbacks */
+typedef struct t_cb_data {
+    PLI_INT32  reason;
+    PLI_INT32  (*cb_rtn)(struct t_cb_data *);
+    vpiHandle  obj;
+    p_vpi_time time;
+    p_vpi_value value;
+    PLI_INT32  index;
+    PLI_BYTE8 *user_data;
+} s_cb_data, *p_cb_data;
+
+#define cbValueChange        1
+#define cbReadWriteSynch     6
+#define cbReadOnlySynch      7
+#define cbNextSimTime        8
+#define cbAfterDelay         9
+#define cbEndOfCompile      10
+#define cbStartOfSimulation 11
+#define cbEndOfSimulation   12
+#define cbStartOfReset      19
+
+/* functions */
+vpiHandle  vpi_register_cb     (p_cb_data cb_data_p);
+PLI_INT32  vpi_remove_cb       (vpiHandle cb_obj);
+vpiHandle  vpi_register_systf  (p_vpi_systf_data systf_data_p);
+
+vpiHandle  vpi_handle          (PLI_INT32 type, vpiHandle ref);
+vpiHandle  vpi_handle_by_name  (PLI_BYTE8 *name, vpiHandle scope);
+vpiHandle  vpi_handle_by_index (vpiHandle object, PLI_INT32 indx);
+vpiHandle  vpi_iterate         (PLI_INT32 type, vpiHandle ref);
+vpiHandle  vpi_scan            (vpiHandle iterator);
+PLI_INT32  vpi_free_object     (vpiHandle object);
+
+PLI_INT32  vpi_get             (PLI_INT32 property, vpiHandle object);
+PLI_BYTE8 *vpi_get_str         (PLI_INT32 property, vpiHandle object);
+void       vpi_get_value       (vpiHandle expr, p_vpi_value value_p);
+vpiHandle  vpi_put_value       (vpiHandle object, p_vpi_value value_p, p_vpi_time time_p, PLI_INT32 flags);
+void       vpi_get_time        (vpiHandle object, p_vpi_time time_p);
+
+PLI_INT32  vpi_printf          (const char *format, ...) __attribute__((format (printf, 1, 2)));
+PLI_INT32  vpi_vprintf         (const char *format, va_list ap);
+PLI_INT32  vpi_flush           (void);
+PLI_INT32  vpi_control         (PLI_INT32 operation, ...);
+PLI_INT32  vpi_get_vlog_info   (p_vpi_vlog_info vlog_info_p);
+
+/* startup routines provided by the vpi library */
+extern void (*vlog_startup_routines[])(void);
+
+#ifdef __cplusplus
+/* *auto-indent-off* */
+}
+/* *auto-indent-on* */
+#endif
+
+#endif
@@ -0,0 +1,45 @@
+#!/bin/bash
+# run stimc_bench for each thread implementation (SIMULATOR=mock)
+# and merge the results into a single json array
+#
+# usage: scripts/bench_thread_impls.sh [<output.json>] [<extra stimc_bench args>]
+
+die() {
+    echo $@ >&2
+    exit 1
+}
+
+SRCDIR=$(cd "$(dirname "$0")/.." && pwd)
+BUILDDIR=${BUILDDIR:-${SRCDIR}/build-bench}
+IMPLS=${IMPLS:-libco-local libco pcl boost1 boost2}
+OUTPUT=${1:-${BUILDDIR}/stimc_bench.json}
+shift
+
+mkdir -p "${BUILDDIR}" || die "cannot create ${BUILDDIR}"
+
+RESULTS=()
+for impl in ${IMPLS} ; do
+    dir="${BUILDDIR}/${impl}"
+    if ! cmake -S "${SRCDIR}" -B "${dir}" -DSIMULATOR=mock -DTHREAD_IMPL=${impl} -DCMAKE_BUILD_TYPE=Release > "${dir}.log" 2>&1 ||
+       ! cmake --build "${dir}" --target stimc_bench -j"$(nproc)" >> "${dir}.log" 2>&1 ; then
+        echo "skipping ${impl} (see ${dir}.log)" >&2
+        continue
+    fi
+
+    echo "running ${impl}" >&2
+    "${dir}/bench/stimc_bench" -o "${dir}/stimc_bench.json" "$@" || die "stimc_bench failed for ${impl}"
+    RESULTS+=("${dir}/stimc_bench.json")
+done
+
+[ ${#RESULTS[@]} -gt 0 ] || die "no thread implementation could be built"
+
+{
+    echo "["
+    for ((i = 0; i < ${#RESULTS[@]}; i++)) ; do
+        [ $i -gt 0 ] && echo ","
+        cat "${RESULTS[$i]}"
+    done
+    echo "]"
+} > "${OUTPUT}"
+
+echo "results written to ${OUTPUT}" >&2
@@ -4,12 +4,12 @@
 set (
     SIMULATOR auto
     CACHE
-    STRING "set simulator for vpi headers and test, one of: auto, icarus, cvc, ncsim, xcelium (default=auto)"
+    STRING "set simulator for vpi headers and test, one of: auto, icarus, cvc, ncsim, xcelium, mock (default=auto)"
 )
 set_property (
     CACHE
     SIMULATOR
-    PROPERTY STRINGS auto icarus cvc ncsim xcelium
+    PROPERTY STRINGS auto icarus cvc ncsim xcelium mock
 )
 
 set (
@@ -34,6 +34,41 @@ set (
     CACHE
     STRING "default stack size for coroutines, 0 for default implementation"
 )
+set (
+    THREAD_STACK_POOL_MAX 0
+    CACHE
+    STRING "maximum number of pooled coroutine stacks, 0 for default implementation"
+)
+set (
+    DISABLE_THREAD_STACK_POOL FALSE
+    CACHE
+    BOOL "disable pooling of coroutine stacks (e.g. for valgrind)"
+)
+set (
+    DISABLE_THREAD_STACK_MMAP FALSE
+    CACHE
+    BOOL "allocate coroutine stacks via malloc instead of lazily committed mmap with guard page"
+)
+set (
+    DISABLE_SLAB_ALLOC FALSE
+    CACHE
+    BOOL "use plain malloc instead of slab allocator for internal objects (e.g. for valgrind)"
+)
+set (
+    THREAD_STACK_WATERMARK FALSE
+    CACHE
+    BOOL "measure maximum coroutine stack usage per thread function and report it at end of simulation"
+)
+set (
+    PROFILE FALSE
+    CACHE
+    BOOL "count scheduler operations, measure time in threads/methods/stimc and report it at end of simulation"
+)
+set (
+    TRACE FALSE
+    CACHE
+    BOOL "support tracing of thread scheduling to chrome trace event json (stimc_trace_start, +stimc_trace=<file>)"
+)
 set (
     DISABLE_CLEANUP FALSE
     CACHE
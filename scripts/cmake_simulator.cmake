@@ -20,7 +20,7 @@ if (SIMULATOR STREQUAL auto)
     set (
         SIMULATOR ${SIMULATOR}
         CACHE
-        STRING "set simulator for vpi headers and test, one of: auto, icarus, cvc, ncsim, xcelium (default=auto)"
+        STRING "set simulator for vpi headers and test, one of: auto, icarus, cvc, ncsim, xcelium, mock (default=auto)"
         FORCE
     )
 endif ()
@@ -69,6 +69,13 @@ elseif (SIMULATOR STREQUAL xcelium OR SIMULATOR STREQUAL ncsim)
         INC_VPI_USER vpi_user.h REQUIRED
         HINTS ${CDS_INC}
     )
+elseif (SIMULATOR STREQUAL mock)
+    # in-process vpi stand-in (lib/vpimock)
+    find_path (
+        INC_VPI_USER vpi_user.h REQUIRED
+        PATHS "${CMAKE_SOURCE_DIR}/lib/vpimock"
+        NO_DEFAULT_PATH
+    )
 else ()
     message (FATAL_ERROR "unknown or invalid simulator specified: ${SIMULATOR}")
 endif ()
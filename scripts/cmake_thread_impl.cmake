@@ -15,6 +15,18 @@ elseif (THREAD_IMPL STREQUAL libco)
 
     set (STIMC_THREAD_IMPL_LIBCO TRUE)
 
+    # co_derive (coroutine on pooled stack memory) is missing in older libco versions
+    include (CheckSymbolExists)
+    set (CMAKE_REQUIRED_INCLUDES  ${INC_LIBCO})
+    set (CMAKE_REQUIRED_LIBRARIES ${LIB_LIBCO})
+    check_symbol_exists (co_derive libco.h LIBCO_HAS_CO_DERIVE)
+    unset (CMAKE_REQUIRED_INCLUDES)
+    unset (CMAKE_REQUIRED_LIBRARIES)
+    if (NOT LIBCO_HAS_CO_DERIVE)
+        message (STATUS "libco without co_derive: coroutine stacks are not pooled")
+        set (STIMC_THREAD_LIBCO_NO_DERIVE TRUE)
+    endif ()
+
     target_include_directories (stimc PRIVATE ${INC_LIBCO})
     target_link_libraries      (stimc PRIVATE ${LIB_LIBCO})
 